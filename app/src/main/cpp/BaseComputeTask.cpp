@@ -1,16 +1,44 @@
 #include "BaseComputeTask.h"
+#include "UploadRing.h"
+#include "SubmitQueue.h"
+#include "Trace.h"
 #include <stdexcept>
 
 // --- Includes for assets ---
+#ifdef __ANDROID__
 #include <android/asset_manager.h>
+#else
+#include <fstream>
+
+#ifndef GPUCOMPUTE_ASSET_DIR
+#define GPUCOMPUTE_ASSET_DIR "."
+#endif
+
+namespace {
+std::string& assetDirectory() {
+    static std::string directory = GPUCOMPUTE_ASSET_DIR;
+    return directory;
+}
+}
+#endif
 
 // --- Constructor ---
 BaseComputeTask::BaseComputeTask(AAssetManager* assetManager) {
     m_context = VulkanContext::getInstance();
     m_assetManager = assetManager; // Store the asset manager
+#ifdef __ANDROID__
     if (m_assetManager == nullptr) {
         throw std::runtime_error("AAssetManager is null in BaseComputeTask");
     }
+#endif
+}
+
+void BaseComputeTask::setAssetDirectory(const std::string& directory) {
+#ifdef __ANDROID__
+    (void)directory;
+#else
+    assetDirectory() = directory;
+#endif
 }
 
 BaseComputeTask::~BaseComputeTask() {
@@ -22,6 +50,8 @@ void BaseComputeTask::init() {
     LOGI("BaseComputeTask::init() starting...");
 
     createBuffers();
+    // All initial uploads queued by createBuffers() go out as one batch
+    m_context->getUploadRing()->submit();
     createDescriptorSetLayout();
     createDescriptorPool();
     createDescriptorSet();
@@ -85,6 +115,7 @@ void BaseComputeTask::cleanup() {
 VkShaderModule BaseComputeTask::loadShaderModule(const std::string& shaderPath) {
     LOGI("Loading pre-compiled shader: %s", shaderPath.c_str());
 
+#ifdef __ANDROID__
     // 1. Read SPIR-V file from assets
     AAsset* file = AAssetManager_open(m_assetManager, shaderPath.c_str(), AASSET_MODE_BUFFER);
     if (file == nullptr) {
@@ -102,6 +133,20 @@ VkShaderModule BaseComputeTask::loadShaderModule(const std::string& shaderPath)
     // 2. Copy SPIR-V data (it's already compiled binary)
     std::vector<char> spirvCode(fileContent, fileContent + fileSize);
     AAsset_close(file);
+#else
+    // 1-2. Read SPIR-V file from the asset directory
+    std::string filePath = assetDirectory() + "/" + shaderPath;
+    std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+    if (!file) {
+        LOGE("Failed to open shader file: %s", filePath.c_str());
+        throw std::runtime_error("Failed to open shader file");
+    }
+    std::vector<char> spirvCode(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(spirvCode.data(), spirvCode.size())) {
+        throw std::runtime_error("Failed to read shader file");
+    }
+#endif
 
     // 3. Validate that size is a multiple of 4 (SPIR-V requirement)
     if (spirvCode.size() % 4 != 0) {
@@ -124,9 +169,65 @@ VkShaderModule BaseComputeTask::loadShaderModule(const std::string& shaderPath)
     return shaderModule;
 }
 
+void BaseComputeTask::createPipelineLayout(uint32_t pushConstantSize) {
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = pushConstantSize;
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &m_descriptorSetLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = pushConstantSize > 0 ? 1 : 0;
+    pipelineLayoutInfo.pPushConstantRanges = pushConstantSize > 0 ? &pushConstantRange : nullptr;
+
+    if (vkCreatePipelineLayout(m_context->getDevice(), &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create pipeline layout!");
+    }
+}
+
+VkPipeline BaseComputeTask::createComputePipeline(const std::string& shaderPath,
+                                                  const VkSpecializationInfo* specializationInfo) {
+    VkShaderModule shaderModule = loadShaderModule(shaderPath);
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.layout = m_pipelineLayout;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = shaderModule;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.stage.pSpecializationInfo = specializationInfo;
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    VkResult result = vkCreateComputePipelines(m_context->getDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline);
+
+    // Shader module can be destroyed after pipeline creation
+    vkDestroyShaderModule(m_context->getDevice(), shaderModule, nullptr);
+
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create compute pipeline!");
+    }
+    return pipeline;
+}
+
 
 void BaseComputeTask::createBuffer(VkBuffer& buffer, VkDeviceMemory& bufferMemory, VkDeviceSize size,
                                    VkBufferUsageFlags usage, VkMemoryPropertyFlags properties) {
+    VkMemoryRequirements memRequirements = createBufferHandle(buffer, size, usage);
+    allocateBufferMemory(buffer, bufferMemory, memRequirements,
+                         m_context->findMemoryType(memRequirements.memoryTypeBits, properties));
+}
+
+void BaseComputeTask::createBuffer(VkBuffer& buffer, VkDeviceMemory& bufferMemory, VkDeviceSize size,
+                                   VkBufferUsageFlags usage, MemoryUsage memoryUsage) {
+    VkMemoryRequirements memRequirements = createBufferHandle(buffer, size, usage);
+    allocateBufferMemory(buffer, bufferMemory, memRequirements,
+                         m_context->selectMemoryType(memRequirements.memoryTypeBits, memoryUsage));
+}
+
+VkMemoryRequirements BaseComputeTask::createBufferHandle(VkBuffer& buffer, VkDeviceSize size, VkBufferUsageFlags usage) {
     VkDevice device = m_context->getDevice();
 
     VkBufferCreateInfo bufferInfo{};
@@ -141,11 +242,17 @@ void BaseComputeTask::createBuffer(VkBuffer& buffer, VkDeviceMemory& bufferMemor
 
     VkMemoryRequirements memRequirements;
     vkGetBufferMemoryRequirements(device, buffer, &memRequirements);
+    return memRequirements;
+}
+
+void BaseComputeTask::allocateBufferMemory(VkBuffer buffer, VkDeviceMemory& bufferMemory,
+                                           const VkMemoryRequirements& memRequirements, uint32_t memoryTypeIndex) {
+    VkDevice device = m_context->getDevice();
 
     VkMemoryAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
     allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = m_context->findMemoryType(memRequirements.memoryTypeBits, properties);
+    allocInfo.memoryTypeIndex = memoryTypeIndex;
 
     if (vkAllocateMemory(device, &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS) {
         throw std::runtime_error("Failed to allocate buffer memory!");
@@ -173,16 +280,12 @@ VkCommandBuffer BaseComputeTask::beginSingleTimeCommands() {
 }
 
 void BaseComputeTask::endSingleTimeCommands(VkCommandBuffer commandBuffer) {
+    TRACE_SCOPE("submit and wait", "vulkan");
     vkEndCommandBuffer(commandBuffer);
 
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffer;
-
-    VkQueue queue = m_context->getQueue();
-    vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(queue);
+    // Waits on this submission's fence only, not on the whole queue
+    SubmitTicket ticket = m_context->getSubmitQueue()->submit(getTaskQueue(), commandBuffer);
+    ticket.wait();
 
     vkFreeCommandBuffers(m_context->getDevice(), m_context->getCommandPool(), 1, &commandBuffer);
 }
@@ -206,35 +309,44 @@ void BaseComputeTask::addBufferBarrier(VkCommandBuffer commandBuffer, VkBuffer b
 
 void BaseComputeTask::createStagingBuffer(VkBuffer& buffer, VkDeviceMemory& memory, VkDeviceSize size, const void* initialData) {
     VkDevice device = m_context->getDevice();
+    VkBufferUsageFlags usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+    // Unified memory: the GPU reads system RAM either way, so a staging copy
+    // would only double the traffic. Write the data in place.
+    if (m_context->isUnifiedMemory()) {
+        BaseComputeTask::createBuffer(buffer, memory, size, usage, MemoryUsage::STREAMING);
+
+        void* mappedData;
+        vkMapMemory(device, memory, 0, VK_WHOLE_SIZE, 0, &mappedData);
+        memcpy(mappedData, initialData, (size_t)size);
+        // Required on non-coherent types, harmless on coherent ones
+        VkMappedMemoryRange range{};
+        range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+        range.memory = memory;
+        range.offset = 0;
+        range.size = VK_WHOLE_SIZE;
+        vkFlushMappedMemoryRanges(device, 1, &range);
+        vkUnmapMemory(device, memory);
+        return;
+    }
 
-    // 1. Create a temporary staging buffer (CPU-visible)
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
-    BaseComputeTask::createBuffer(stagingBuffer, stagingBufferMemory, size,
-                                  VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-    // 2. Map it and copy the initial data into it
-    void* mappedData;
-    vkMapMemory(device, stagingBufferMemory, 0, size, 0, &mappedData);
-    memcpy(mappedData, initialData, (size_t)size);
-    vkUnmapMemory(device, stagingBufferMemory);
-
-    // 3. Create the final destination buffer (GPU-only)
-    BaseComputeTask::createBuffer(buffer, memory, size,
-                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    // Discrete: device-local buffer, filled through the shared upload ring.
+    // The copy is only queued here; it is submitted with the rest of the
+    // batch (BaseComputeTask::init() does this after createBuffers()).
+    BaseComputeTask::createBuffer(buffer, memory, size, usage, MemoryUsage::GPU_ONLY);
+    m_context->getUploadRing()->enqueue(buffer, 0, initialData, size, getTaskQueue());
+}
 
-    // 4. Use a one-time command buffer to copy from staging to device buffer
-    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+void BaseComputeTask::recordResultCopy(VkCommandBuffer commandBuffer, VkBuffer src, VkBuffer dst, VkDeviceSize size) {
+    addBufferBarrier(commandBuffer, src,
+                     VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT,
+                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
 
     VkBufferCopy copyRegion{};
     copyRegion.size = size;
-    vkCmdCopyBuffer(commandBuffer, stagingBuffer, buffer, 1, &copyRegion);
-
-    endSingleTimeCommands(commandBuffer);
+    vkCmdCopyBuffer(commandBuffer, src, dst, 1, &copyRegion);
 
-    // 5. Clean up temporary staging buffer
-    vkDestroyBuffer(device, stagingBuffer, nullptr);
-    vkFreeMemory(device, stagingBufferMemory, nullptr);
+    addBufferBarrier(commandBuffer, dst,
+                     VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_HOST_READ_BIT,
+                     VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT);
 }
\ No newline at end of file
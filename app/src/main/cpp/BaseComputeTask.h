@@ -3,7 +3,11 @@
 #include "ComputeTask.h"
 #include <vector>
 #include <string>
+#ifdef __ANDROID__
 #include <android/asset_manager.h> // <-- NEW
+#else
+struct AAssetManager; // Desktop builds pass nullptr and read shaders from the asset directory
+#endif
 
 class BaseComputeTask : public ComputeTask {
 public:
@@ -15,6 +19,15 @@ public:
     void init() override;
     void cleanup() override;
 
+    // Compute queue this task submits to (see VulkanContext::getComputeQueue).
+    // Independent tasks on different queues may run concurrently; call before init().
+    void setQueueIndex(uint32_t queueIndex) { m_queueIndex = queueIndex; }
+    VkQueue getTaskQueue() { return m_context->getComputeQueue(m_queueIndex); }
+
+    // Desktop builds only: the directory getShaderPath() is relative to
+    // (GPUCOMPUTE_ASSET_DIR by default). Android reads the APK's assets instead.
+    static void setAssetDirectory(const std::string& directory);
+
 protected:
     // --- "Fill in the blank" methods for subclasses ---
 
@@ -36,15 +49,26 @@ protected:
     // --- NEW Helper: loads a compiled shader from assets ---
     VkShaderModule loadShaderModule(const std::string& shaderPath);
 
+    // --- Pipeline helpers for tasks that override init() ---
+    // Creates m_pipelineLayout with one compute push-constant range (0 = none)
+    void createPipelineLayout(uint32_t pushConstantSize);
+    // Loads the shader and builds a compute pipeline against m_pipelineLayout
+    VkPipeline createComputePipeline(const std::string& shaderPath,
+                                     const VkSpecializationInfo* specializationInfo = nullptr);
+
     // --- Helper methods for subclasses ---
     void createBuffer(VkBuffer& buffer, VkDeviceMemory& bufferMemory, VkDeviceSize size,
                       VkBufferUsageFlags usage, VkMemoryPropertyFlags properties);
+    // Same, but the memory type comes from the context's usage-based policy
+    void createBuffer(VkBuffer& buffer, VkDeviceMemory& bufferMemory, VkDeviceSize size,
+                      VkBufferUsageFlags usage, MemoryUsage memoryUsage);
 
     // For one-time command buffer recording
     VkCommandBuffer beginSingleTimeCommands();
     void endSingleTimeCommands(VkCommandBuffer commandBuffer);
 
-    // For copying data to a device-local buffer
+    // For creating a GPU-read buffer with initial data (written in place on
+    // unified memory, queued on the context's UploadRing on discrete GPUs)
     void createStagingBuffer(VkBuffer& buffer, VkDeviceMemory& memory, VkDeviceSize size, const void* initialData);
 
     // For adding a barrier
@@ -52,6 +76,10 @@ protected:
                           VkAccessFlags srcAccess, VkAccessFlags dstAccess,
                           VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage);
 
+    // Copies 'size' bytes of a shader-written buffer into a host-readable one
+    // and makes them visible to the host (for results that land in a GPU_ONLY buffer)
+    void recordResultCopy(VkCommandBuffer commandBuffer, VkBuffer src, VkBuffer dst, VkDeviceSize size);
+
     // --- Common Vulkan Objects ---
     VulkanContext* m_context;
     AAssetManager* m_assetManager; // <-- NEW
@@ -62,4 +90,10 @@ protected:
     VkDescriptorSetLayout m_descriptorSetLayout = VK_NULL_HANDLE;
     VkDescriptorPool m_descriptorPool = VK_NULL_HANDLE;
     VkDescriptorSet m_descriptorSet = VK_NULL_HANDLE;
+    uint32_t m_queueIndex = 0;
+
+private:
+    VkMemoryRequirements createBufferHandle(VkBuffer& buffer, VkDeviceSize size, VkBufferUsageFlags usage);
+    void allocateBufferMemory(VkBuffer buffer, VkDeviceMemory& bufferMemory,
+                              const VkMemoryRequirements& memRequirements, uint32_t memoryTypeIndex);
 };
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "BenchmarkRunner.h"
+#include "VulkanContext.h" // LOGI/LOGE
+#include "Trace.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+// --- BenchmarkRecord ---
+
+void BenchmarkRecord::setSamples(std::vector<double> samples) {
+    iterations = static_cast<uint32_t>(samples.size());
+    if (samples.empty()) return;
+
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&samples](double p) {
+        size_t rank = static_cast<size_t>(std::ceil(p * samples.size()));
+        return samples[std::min(samples.size(), std::max<size_t>(rank, 1)) - 1];
+    };
+    minUs = samples.front();
+    maxUs = samples.back();
+    p50Us = percentile(0.50);
+    p90Us = percentile(0.90);
+    p99Us = percentile(0.99);
+    double total = 0.0;
+    for (double sample : samples) total += sample;
+    meanUs = total / samples.size();
+}
+
+static void writeJsonString(std::ostringstream& out, const std::string& value) {
+    out << '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') out << '\\';
+        if (static_cast<unsigned char>(c) < 0x20) {
+            out << ' ';
+            continue;
+        }
+        out << c;
+    }
+    out << '"';
+}
+
+// JSON has no NaN or infinity
+static void writeJsonNumber(std::ostringstream& out, double value) {
+    if (std::isfinite(value)) {
+        out << value;
+    } else {
+        out << "null";
+    }
+}
+
+std::string BenchmarkRecord::toJson() const {
+    std::ostringstream out;
+    out << "{\"experiment\":";
+    writeJsonString(out, experiment);
+    out << ",\"backend\":";
+    writeJsonString(out, backend);
+    out << ",\"size\":" << size << ",\"iterations\":" << iterations;
+    const std::pair<const char*, double> latencies[] = {
+            {"min_us", minUs}, {"p50_us", p50Us}, {"p90_us", p90Us},
+            {"p99_us", p99Us}, {"max_us", maxUs}, {"mean_us", meanUs}};
+    for (const auto& latency : latencies) {
+        out << ",\"" << latency.first << "\":";
+        writeJsonNumber(out, latency.second);
+    }
+    out << ",\"phases\":{";
+    for (size_t i = 0; i < phases.size(); i++) {
+        if (i > 0) out << ",";
+        writeJsonString(out, phases[i].first);
+        out << ":";
+        writeJsonNumber(out, phases[i].second);
+    }
+    out << "},\"valid\":" << (valid ? "true" : "false") << "}";
+    return out.str();
+}
+
+// --- BenchmarkRunner ---
+
+BenchmarkRunner::~BenchmarkRunner() {
+    requestStop();
+    join();
+}
+
+bool BenchmarkRunner::start(Body body) {
+    if (m_state.load() == State::RUNNING) return false;
+    join(); // Reap a finished run's thread
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.clear();
+        m_error.clear();
+    }
+    m_stopRequested.store(false);
+    m_state.store(State::RUNNING);
+
+    m_worker = std::thread([this, body]() {
+        LOGI("BenchmarkRunner: worker started");
+        TRACE_THREAD_NAME("benchmark");
+        State finalState = State::FINISHED;
+        try {
+            body(*this);
+            if (isStopRequested()) finalState = State::CANCELLED;
+        } catch (const std::exception& e) {
+            LOGE("BenchmarkRunner: %s", e.what());
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_error = e.what();
+            finalState = State::FAILED;
+        }
+        m_state.store(finalState);
+        LOGI("BenchmarkRunner: worker finished");
+    });
+    return true;
+}
+
+void BenchmarkRunner::join() {
+    if (m_worker.joinable() && m_worker.get_id() != std::this_thread::get_id()) {
+        m_worker.join();
+    }
+}
+
+void BenchmarkRunner::emit(const BenchmarkRecord& record) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.push_back(record);
+    }
+    if (m_listener) m_listener(record);
+}
+
+std::vector<BenchmarkRecord> BenchmarkRunner::poll(size_t maxRecords) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t count = std::min(maxRecords, m_pending.size());
+    std::vector<BenchmarkRecord> records(m_pending.begin(), m_pending.begin() + count);
+    m_pending.erase(m_pending.begin(), m_pending.begin() + count);
+    return records;
+}
+
+std::string BenchmarkRunner::getError() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_error;
+}
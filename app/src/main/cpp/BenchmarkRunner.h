@@ -0,0 +1,82 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <vector>
+#include <deque>
+#include <utility>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+// The results of one benchmark configuration (one size on one backend)
+struct BenchmarkRecord {
+    std::string experiment;  // e.g. "reduce"
+    std::string backend;     // e.g. "cpu", "gpu-optimized"
+    uint64_t size = 0;       // Elements
+    uint32_t iterations = 0; // Timed samples behind the percentiles
+
+    // Wall time of one timed run, in us
+    double minUs = 0.0;
+    double p50Us = 0.0;
+    double p90Us = 0.0;
+    double p99Us = 0.0;
+    double maxUs = 0.0;
+    double meanUs = 0.0;
+
+    // Where the time went, in us, in the order added (e.g. init, dispatch, gpu, cleanup)
+    std::vector<std::pair<std::string, double>> phases;
+    bool valid = true;
+
+    // Fills iterations and the latency fields (nearest-rank percentiles)
+    void setSamples(std::vector<double> samples);
+    void addPhase(const std::string& name, double us) { phases.emplace_back(name, us); }
+    // One line of JSON
+    std::string toJson() const;
+};
+
+// Runs a benchmark body on a dedicated worker thread and streams its records.
+//
+// The body calls emit() once per configuration; callers collect records with
+// poll() from any thread (the JNI layer polls from the UI), or get them pushed
+// through a listener, which runs on the worker thread. Stopping is
+// cooperative: the body checks isStopRequested() between configurations, and
+// inside any loop long enough that join() would keep the UI thread waiting.
+class BenchmarkRunner {
+public:
+    enum class State { IDLE, RUNNING, FINISHED, FAILED, CANCELLED };
+    using Body = std::function<void(BenchmarkRunner&)>;
+    using Listener = std::function<void(const BenchmarkRecord&)>;
+
+    BenchmarkRunner() = default;
+    ~BenchmarkRunner();
+
+    // Returns false if a run is already in progress. Records of an earlier run that were never polled are dropped.
+    bool start(Body body);
+    void requestStop() { m_stopRequested.store(true); }
+    bool isStopRequested() const { return m_stopRequested.load(); }
+    // Waits for the worker thread (no-op if none)
+    void join();
+
+    // --- Called by the body ---
+    void emit(const BenchmarkRecord& record);
+
+    // --- Results ---
+    // Takes up to 'maxRecords' records emitted since the last poll, oldest first
+    std::vector<BenchmarkRecord> poll(size_t maxRecords = SIZE_MAX);
+    // Optional; set before start()
+    void setListener(Listener listener) { m_listener = std::move(listener); }
+    State getState() const { return m_state.load(); }
+    std::string getError();
+
+private:
+    std::thread m_worker;
+    std::atomic<State> m_state{State::IDLE};
+    std::atomic<bool> m_stopRequested{false};
+    Listener m_listener;
+
+    std::mutex m_mutex; // Guards m_pending and m_error
+    std::deque<BenchmarkRecord> m_pending;
+    std::string m_error;
+};
@@ -0,0 +1,256 @@
+#include "ComputeGraph.h"
+#include <stdexcept>
+
+// --- Building ---
+
+ComputeGraph& ComputeGraph::addDispatch(const std::string& name, VkPipeline pipeline, VkPipelineLayout layout,
+                                        VkDescriptorSet descriptorSet, const void* pushData, uint32_t pushSize,
+                                        uint32_t groupCountX, std::vector<GraphBufferAccess> accesses,
+                                        const PassWork& work) {
+    Node node;
+    node.name = name;
+    node.stage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    node.accesses = std::move(accesses);
+    node.pipeline = pipeline;
+    node.layout = layout;
+    node.descriptorSet = descriptorSet;
+    if (pushSize > 0) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(pushData);
+        node.pushData.assign(bytes, bytes + pushSize);
+    }
+    node.groupCountX = groupCountX;
+    node.work = work;
+    m_nodes.push_back(std::move(node));
+    return *this;
+}
+
+ComputeGraph& ComputeGraph::addCopy(const std::string& name, VkBuffer src, VkBuffer dst, VkDeviceSize size,
+                                    VkDeviceSize srcOffset, VkDeviceSize dstOffset) {
+    return addNode(name, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                   {{src, GraphAccess::READ, size}, {dst, GraphAccess::WRITE, size}},
+                   [=](VkCommandBuffer commandBuffer) {
+                       VkBufferCopy region{};
+                       region.srcOffset = srcOffset;
+                       region.dstOffset = dstOffset;
+                       region.size = size;
+                       vkCmdCopyBuffer(commandBuffer, src, dst, 1, &region);
+                   });
+}
+
+ComputeGraph& ComputeGraph::addNode(const std::string& name, VkPipelineStageFlags stage,
+                                    std::vector<GraphBufferAccess> accesses, RecordFunction record) {
+    Node node;
+    node.name = name;
+    node.stage = stage;
+    node.accesses = std::move(accesses);
+    node.record = std::move(record);
+    m_nodes.push_back(std::move(node));
+    return *this;
+}
+
+ComputeGraph& ComputeGraph::addHostRead(VkBuffer buffer) {
+    m_hostReads.push_back(buffer);
+    return *this;
+}
+
+void ComputeGraph::clear() {
+    m_nodes.clear();
+    m_hostReads.clear();
+    m_states.clear();
+    m_barrierCount = 0;
+    m_bufferBarrierCount = 0;
+    m_finalBarriers = 0;
+}
+
+// --- Recording ---
+
+void ComputeGraph::record(VkCommandBuffer commandBuffer) {
+    m_states.clear();
+    m_barrierCount = 0;
+    m_bufferBarrierCount = 0;
+
+    VkPipeline boundPipeline = VK_NULL_HANDLE;
+    for (Node& node : m_nodes) {
+        const VkAccessFlags readAccess = readAccessFor(node.stage);
+        const VkAccessFlags writeAccess = writeAccessFor(node.stage);
+
+        // 1. Derive this node's barriers from the buffer states
+        PendingBarrier pending;
+        for (const GraphBufferAccess& use : node.accesses) {
+            BufferState& state = stateOf(use.buffer);
+            bool reads = use.access != GraphAccess::WRITE;
+            bool writes = use.access != GraphAccess::READ;
+
+            VkPipelineStageFlags srcStages = 0;
+            VkAccessFlags srcAccess = 0;
+            VkAccessFlags dstAccess = 0;
+            if (reads && state.writeStages != 0 &&
+                ((state.visibleStages & node.stage) != node.stage || (state.visibleAccess & readAccess) != readAccess)) {
+                // Read after write
+                srcStages |= state.writeStages;
+                srcAccess |= state.writeAccess;
+                dstAccess |= readAccess;
+            }
+            if (writes && state.readStages != 0) {
+                // Write after read: the reads only have to finish first
+                srcStages |= state.readStages;
+            }
+            if (writes && state.writeStages != 0) {
+                // Write after write
+                srcStages |= state.writeStages;
+                srcAccess |= state.writeAccess;
+            }
+            if (srcStages != 0) {
+                if (writes) dstAccess |= writeAccess;
+                pending.add(use.buffer, srcStages, srcAccess, node.stage, dstAccess);
+            }
+        }
+        node.barriersBefore = static_cast<uint32_t>(pending.barriers.size());
+        flushBarrier(commandBuffer, pending, node.name);
+
+        // 2. Record the node
+        GpuProfiler::Scope scope(m_profiler, commandBuffer, node.name);
+        node.statisticsQuery = m_statistics != nullptr ? m_statistics->begin(commandBuffer) : UINT32_MAX;
+        if (node.record) {
+            node.record(commandBuffer);
+            boundPipeline = VK_NULL_HANDLE; // The callback may have bound anything
+        } else {
+            if (node.pipeline != boundPipeline) {
+                vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, node.pipeline);
+                boundPipeline = node.pipeline;
+            }
+            if (!node.pushData.empty()) {
+                vkCmdPushConstants(commandBuffer, node.layout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                                   static_cast<uint32_t>(node.pushData.size()), node.pushData.data());
+            }
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, node.layout, 0, 1,
+                                    &node.descriptorSet, 0, nullptr);
+            vkCmdDispatch(commandBuffer, node.groupCountX, 1, 1);
+        }
+        if (m_statistics != nullptr) m_statistics->end(commandBuffer, node.statisticsQuery);
+
+        // 3. Update the buffer states
+        for (const GraphBufferAccess& use : node.accesses) {
+            BufferState& state = stateOf(use.buffer);
+            if (use.access == GraphAccess::READ) {
+                state.readStages |= node.stage;
+                if (state.writeStages != 0) {
+                    state.visibleStages |= node.stage;
+                    state.visibleAccess |= readAccess;
+                }
+            } else {
+                state.writeStages = node.stage;
+                state.writeAccess = writeAccess;
+                state.visibleStages = 0;
+                state.visibleAccess = 0;
+                state.readStages = 0;
+            }
+        }
+    }
+
+    // 4. One final barrier for everything the host reads
+    PendingBarrier hostBarrier;
+    for (VkBuffer buffer : m_hostReads) {
+        BufferState& state = stateOf(buffer);
+        if (state.writeStages != 0) {
+            hostBarrier.add(buffer, state.writeStages, state.writeAccess,
+                            VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_HOST_READ_BIT);
+        }
+    }
+    m_finalBarriers = static_cast<uint32_t>(hostBarrier.barriers.size());
+    flushBarrier(commandBuffer, hostBarrier, "host");
+}
+
+void ComputeGraph::logPlan() const {
+    LOGI("ComputeGraph: %zu nodes, %u barrier calls, %u buffer barriers",
+         m_nodes.size(), m_barrierCount, m_bufferBarrierCount);
+    for (size_t i = 0; i < m_nodes.size(); i++) {
+        LOGI("  [%zu] %s%s", i, m_nodes[i].name.c_str(), m_nodes[i].barriersBefore > 0 ? " (after barrier)" : "");
+    }
+    if (m_finalBarriers > 0) {
+        LOGI("  host barrier on %u buffer(s)", m_finalBarriers);
+    }
+}
+
+// --- Pass statistics ---
+
+std::vector<PassStats> ComputeGraph::collectPassStats(const GpuProfile* profile) {
+    std::vector<int64_t> invocations;
+    if (m_statistics != nullptr) invocations = m_statistics->resolve();
+
+    std::vector<PassStats> passes;
+    for (const Node& node : m_nodes) {
+        PassStats pass;
+        pass.name = node.name;
+        pass.workgroups = node.groupCountX;
+        pass.invocations = (uint64_t)node.groupCountX * node.work.localSize;
+        pass.operations = node.work.operations;
+        pass.barriersBefore = node.barriersBefore;
+        for (const GraphBufferAccess& use : node.accesses) {
+            if (use.access != GraphAccess::WRITE) pass.bytesRead += use.bytes;
+            if (use.access != GraphAccess::READ) pass.bytesWritten += use.bytes;
+        }
+        if (node.statisticsQuery < invocations.size()) pass.measuredInvocations = invocations[node.statisticsQuery];
+        if (profile != nullptr) {
+            const GpuRegion* region = profile->find(node.name);
+            if (profile->trustworthy && region != nullptr && region->plausible) pass.gpuUs = region->durationUs;
+        }
+        passes.push_back(pass);
+    }
+    return passes;
+}
+
+// --- Helpers ---
+
+ComputeGraph::BufferState& ComputeGraph::stateOf(VkBuffer buffer) {
+    for (BufferState& state : m_states) {
+        if (state.buffer == buffer) return state;
+    }
+    BufferState state;
+    state.buffer = buffer;
+    m_states.push_back(state);
+    return m_states.back();
+}
+
+void ComputeGraph::PendingBarrier::add(VkBuffer buffer, VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+                                       VkPipelineStageFlags dstStage, VkAccessFlags dstAccess) {
+    srcStages |= srcStage;
+    dstStages |= dstStage;
+
+    VkBufferMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = dstAccess;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = buffer;
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+    barriers.push_back(barrier);
+}
+
+void ComputeGraph::flushBarrier(VkCommandBuffer commandBuffer, PendingBarrier& pending, const std::string& nextNode) {
+    if (pending.barriers.empty()) return;
+    uint32_t region = UINT32_MAX;
+    if (m_profiler != nullptr) {
+        region = m_profiler->beginRegion(commandBuffer, "barrier:" + nextNode, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+    }
+    vkCmdPipelineBarrier(commandBuffer, pending.srcStages, pending.dstStages, 0,
+                         0, nullptr, static_cast<uint32_t>(pending.barriers.size()), pending.barriers.data(),
+                         0, nullptr);
+    if (m_profiler != nullptr) m_profiler->endRegion(commandBuffer, region, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+    m_barrierCount++;
+    m_bufferBarrierCount += static_cast<uint32_t>(pending.barriers.size());
+}
+
+VkAccessFlags ComputeGraph::readAccessFor(VkPipelineStageFlags stage) {
+    if (stage == VK_PIPELINE_STAGE_TRANSFER_BIT) return VK_ACCESS_TRANSFER_READ_BIT;
+    if (stage == VK_PIPELINE_STAGE_HOST_BIT) return VK_ACCESS_HOST_READ_BIT;
+    return VK_ACCESS_SHADER_READ_BIT;
+}
+
+VkAccessFlags ComputeGraph::writeAccessFor(VkPipelineStageFlags stage) {
+    if (stage == VK_PIPELINE_STAGE_TRANSFER_BIT) return VK_ACCESS_TRANSFER_WRITE_BIT;
+    if (stage == VK_PIPELINE_STAGE_HOST_BIT) return VK_ACCESS_HOST_WRITE_BIT;
+    return VK_ACCESS_SHADER_WRITE_BIT;
+}
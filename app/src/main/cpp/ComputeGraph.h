@@ -0,0 +1,142 @@
+#pragma once
+
+#include "VulkanContext.h"
+#include "GpuProfiler.h"
+#include "PipelineStatistics.h"
+#include <vector>
+#include <string>
+#include <functional>
+
+// How a node touches a buffer
+enum class GraphAccess {
+    READ,
+    WRITE,
+    READ_WRITE
+};
+
+struct GraphBufferAccess {
+    VkBuffer buffer;
+    GraphAccess access;
+    VkDeviceSize bytes = 0; // How much of it the node reads / writes, for PassStats (0: not counted)
+};
+
+// A dispatch's analytic work, for PassStats
+struct PassWork {
+    uint32_t localSize = 0;  // Invocations per workgroup
+    uint64_t operations = 0; // Arithmetic operations the pass performs
+};
+
+// A small render-graph-style recorder for compute work.
+//
+// Nodes declare the buffers they read and write; record() walks them in
+// order, derives the barriers from those declarations and records the whole
+// graph into one command buffer:
+//   - read after write:  memory barrier (writer -> reader)
+//   - write after read:  execution-only barrier (no cache flush needed)
+//   - write after write: memory barrier (writer -> writer)
+//   - reads of data already made visible to that stage need nothing
+// Every barrier a node needs goes into ONE vkCmdPipelineBarrier call, and
+// nodes without hazards between them get none, so they can overlap.
+//
+// A node lists each buffer once (READ_WRITE for in-place updates).
+// Buffers start in a "nothing pending" state: work recorded before the graph
+// (e.g. UploadBuffer::recordUpload) must bring its own barrier.
+class ComputeGraph {
+public:
+    using RecordFunction = std::function<void(VkCommandBuffer)>;
+
+    ComputeGraph() = default;
+
+    // --- Building ---
+    // A compute dispatch; pushSize may be 0
+    ComputeGraph& addDispatch(const std::string& name, VkPipeline pipeline, VkPipelineLayout layout,
+                              VkDescriptorSet descriptorSet, const void* pushData, uint32_t pushSize,
+                              uint32_t groupCountX, std::vector<GraphBufferAccess> accesses,
+                              const PassWork& work = PassWork());
+    // A buffer-to-buffer copy (transfer stage)
+    ComputeGraph& addCopy(const std::string& name, VkBuffer src, VkBuffer dst, VkDeviceSize size,
+                          VkDeviceSize srcOffset = 0, VkDeviceSize dstOffset = 0);
+    // Anything else: 'record' records the commands, the stage and accesses drive the barriers
+    ComputeGraph& addNode(const std::string& name, VkPipelineStageFlags stage,
+                          std::vector<GraphBufferAccess> accesses, RecordFunction record);
+    // The host reads this buffer after the graph's submission completes
+    ComputeGraph& addHostRead(VkBuffer buffer);
+
+    void clear();
+    size_t getNodeCount() const { return m_nodes.size(); }
+
+    // Times every node (a region named after it) and every barrier ("barrier:<next node>", from the work
+    // before it completing to the barrier being passed) in record(). The caller resets and resolves the
+    // profiler; nullptr turns it off. Kept across clear().
+    void setProfiler(GpuProfiler* profiler) { m_profiler = profiler; }
+    // Counts compute shader invocations per node in record(); the caller resets it. Kept across clear().
+    void setStatistics(PipelineStatistics* statistics) { m_statistics = statistics; }
+
+    // --- Recording ---
+    void record(VkCommandBuffer commandBuffer);
+
+    // Stats of the last record()
+    uint32_t getBarrierCount() const { return m_barrierCount; }             // vkCmdPipelineBarrier calls
+    uint32_t getBufferBarrierCount() const { return m_bufferBarrierCount; } // VkBufferMemoryBarriers in them
+
+    // Logs each node with the barrier recorded before it
+    void logPlan() const;
+
+    // Per node of the last record(), once its submission has completed: the declared work and bytes,
+    // the measured invocations (with setStatistics) and the GPU time of the profile region named after
+    // the node (give nodes unique names for that)
+    std::vector<PassStats> collectPassStats(const GpuProfile* profile = nullptr);
+
+private:
+    struct Node {
+        std::string name;
+        VkPipelineStageFlags stage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        std::vector<GraphBufferAccess> accesses;
+        RecordFunction record;
+
+        // Dispatch nodes (pipeline binds are skipped when unchanged)
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        VkPipelineLayout layout = VK_NULL_HANDLE;
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        std::vector<uint8_t> pushData;
+        uint32_t groupCountX = 0;
+        PassWork work;
+
+        uint32_t barriersBefore = 0;          // Filled by record(), for logPlan()
+        uint32_t statisticsQuery = UINT32_MAX; // Filled by record()
+    };
+
+    // What the graph knows about one buffer while recording
+    struct BufferState {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkPipelineStageFlags writeStages = 0;  // Last write (0 = nothing pending)
+        VkAccessFlags writeAccess = 0;
+        VkPipelineStageFlags visibleStages = 0; // Where that write is already visible
+        VkAccessFlags visibleAccess = 0;
+        VkPipelineStageFlags readStages = 0;    // Reads since the last write
+    };
+
+    // Collects the buffer barriers needed before one node (one per buffer)
+    struct PendingBarrier {
+        VkPipelineStageFlags srcStages = 0;
+        VkPipelineStageFlags dstStages = 0;
+        std::vector<VkBufferMemoryBarrier> barriers;
+        void add(VkBuffer buffer, VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+                 VkPipelineStageFlags dstStage, VkAccessFlags dstAccess);
+    };
+
+    BufferState& stateOf(VkBuffer buffer);
+    void flushBarrier(VkCommandBuffer commandBuffer, PendingBarrier& pending, const std::string& nextNode);
+    static VkAccessFlags readAccessFor(VkPipelineStageFlags stage);
+    static VkAccessFlags writeAccessFor(VkPipelineStageFlags stage);
+
+    std::vector<Node> m_nodes;
+    std::vector<VkBuffer> m_hostReads;
+    std::vector<BufferState> m_states; // Few buffers per graph: a linear scan is enough
+    GpuProfiler* m_profiler = nullptr;
+    PipelineStatistics* m_statistics = nullptr;
+
+    uint32_t m_barrierCount = 0;
+    uint32_t m_bufferBarrierCount = 0;
+    uint32_t m_finalBarriers = 0;
+};
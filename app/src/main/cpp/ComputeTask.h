@@ -2,6 +2,14 @@
 
 #include "VulkanContext.h"
 
+// What a task produced in its last run (see ComputeTask::readResult)
+struct TaskResult {
+    bool valid = true;        // Result matched the expected value
+    double value = 0.0;
+    double gpuTimeUs = -1.0;  // From timestamps; <0 when unavailable
+    long long hostTimeUs = 0; // Wall time the caller observed
+};
+
 class ComputeTask{
 public:
     // Virtual destructor is required for base classes
@@ -17,4 +25,23 @@ public:
 
     // 3. Clean up all the resources created in init()
     virtual void cleanup() = 0;
+
+    // --- Batching (optional, see TaskBatch) ---
+
+    // GPU tasks that can record dispatch()'s work into a command buffer
+    // someone else submits return true and implement record()/readResult()
+    virtual bool isRecordable() { return false; }
+    virtual void record(VkCommandBuffer /*commandBuffer*/) {}
+    // Reads back what the last record() produced, once its submission has completed
+    virtual TaskResult readResult() { return TaskResult(); }
+
+    // --- Resizing (optional) ---
+
+    // Long-lived tasks that can change N after init() return true and
+    // implement resize(): pipelines and descriptor sets are kept, N up to the
+    // capacity costs nothing, and beyond it the buffers grow to at least twice
+    // the old capacity. Only between runs (nothing of the task in flight).
+    virtual bool isResizable() { return false; }
+    virtual void resize(uint32_t /*n*/) {}
+    virtual uint32_t getCapacity() { return 0; }
 };
\ No newline at end of file
@@ -0,0 +1,168 @@
+#include "CpuBandwidthTask.h"
+#include "GpuBandwidthTask.h" // MIN_WORKING_SET_BYTES, MIN_BYTES_PER_RUN
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+const uint64_t FLOATS_PER_ELEMENT = 4; // 16-byte elements, as the GPU's vec4s
+const uint64_t STRIDE = 16;             // Elements (256 bytes) between strided reads, as in bandwidth.comp
+}
+
+CpuBandwidthTask::CpuBandwidthTask(uint64_t maxWorkingSetBytes) : m_capacity(maxWorkingSetBytes) {
+    if (m_capacity < GpuBandwidthTask::MIN_WORKING_SET_BYTES || (m_capacity & (m_capacity - 1)) != 0) {
+        throw std::runtime_error("CpuBandwidthTask needs a power-of-two capacity of at least 1 KiB!");
+    }
+    m_numThreads = (int)std::thread::hardware_concurrency();
+    if (m_numThreads == 0) m_numThreads = 4; // Fallback
+    LOGI("CpuBandwidthTask created. Capacity=%llu bytes, Threads=%d", (unsigned long long)m_capacity, m_numThreads);
+}
+
+CpuBandwidthTask::~CpuBandwidthTask() {
+    LOGI("CpuBandwidthTask destroyed");
+}
+
+void CpuBandwidthTask::init() {
+    // Both written here, so every page is mapped before the first timed run
+    m_src.assign(m_capacity / sizeof(float), 1.0f);
+    m_dst.assign(m_capacity / sizeof(float), 0.0f);
+    m_threadSums.assign(m_numThreads, 0.0f);
+    configure(m_kernel, m_workingSetBytes);
+    LOGI("CpuBandwidthTask::init() complete.");
+}
+
+void CpuBandwidthTask::cleanup() {
+    m_src.clear();
+    m_src.shrink_to_fit();
+    m_dst.clear();
+    m_dst.shrink_to_fit();
+    m_threadSums.clear();
+    LOGI("CpuBandwidthTask::cleanup() complete.");
+}
+
+// --- Measuring ---
+
+void CpuBandwidthTask::configure(BandwidthKernel kernel, uint64_t workingSetBytes) {
+    if (workingSetBytes < GpuBandwidthTask::MIN_WORKING_SET_BYTES || workingSetBytes > m_capacity ||
+        (workingSetBytes & (workingSetBytes - 1)) != 0) {
+        throw std::runtime_error("CpuBandwidthTask: the working set must be a power of two within the capacity!");
+    }
+    m_kernel = kernel;
+    m_workingSetBytes = workingSetBytes;
+    m_sweeps = std::max<uint64_t>(1, GpuBandwidthTask::MIN_BYTES_PER_RUN / workingSetBytes);
+}
+
+uint64_t CpuBandwidthTask::getBytesMoved() const {
+    return m_sweeps * (m_workingSetBytes / 16) * getBandwidthBytesPerElement(m_kernel);
+}
+
+BandwidthSample CpuBandwidthTask::measure(BandwidthKernel kernel, uint64_t workingSetBytes, uint32_t iterations) {
+    configure(kernel, workingSetBytes);
+    dispatch(); // Warm-up: caches, and the cores' clocks
+
+    double bestUs = -1.0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        dispatch();
+        if (bestUs < 0.0 || m_lastUs < bestUs) bestUs = m_lastUs;
+    }
+
+    BandwidthSample sample;
+    sample.processor = "cpu";
+    sample.kernel = kernel;
+    sample.workingSetBytes = workingSetBytes;
+    sample.bytesMoved = getBytesMoved();
+    sample.us = bestUs;
+    return sample;
+}
+
+// --- Dispatch ---
+
+long long CpuBandwidthTask::dispatch() {
+    uint64_t elements = m_workingSetBytes / 16;
+    std::atomic<bool> go{false};
+    std::vector<Clock::time_point> threadEnds(m_numThreads);
+
+    // --- 1. Start the threads, held at the line ---
+    std::vector<std::thread> threads;
+    for (int i = 0; i < m_numThreads; i++) {
+        uint64_t begin = elements * i / m_numThreads;
+        uint64_t end = elements * (i + 1) / m_numThreads;
+        threads.emplace_back([this, i, begin, end, &go, &threadEnds]() {
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            runSlice(i, begin, end);
+            threadEnds[i] = Clock::now();
+        });
+    }
+
+    // --- 2. Release them together; the run ends with the slowest ---
+    auto startTime = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& t : threads) {
+        t.join();
+    }
+    auto endTime = *std::max_element(threadEnds.begin(), threadEnds.end());
+
+    m_lastUs = std::chrono::duration<double, std::micro>(endTime - startTime).count();
+    return std::llround(m_lastUs);
+}
+
+void CpuBandwidthTask::runSlice(int thread, uint64_t begin, uint64_t end) {
+    const float* src = m_src.data();
+    float* dst = m_dst.data();
+    uint64_t mask = m_workingSetBytes / 16 - 1;
+    uint64_t columns = (mask + 1) / STRIDE;
+    uint64_t beginFloat = begin * FLOATS_PER_ELEMENT;
+    uint64_t endFloat = end * FLOATS_PER_ELEMENT;
+
+    // Eight independent sums: the sequential read vectorizes without reassociating
+    float sums[8] = {};
+    for (uint64_t sweep = 0; sweep < m_sweeps; sweep++) {
+        switch (m_kernel) {
+            case BandwidthKernel::COPY:
+                std::memcpy(dst + beginFloat, src + beginFloat, (endFloat - beginFloat) * sizeof(float));
+                break;
+            case BandwidthKernel::READ: {
+                uint64_t j = beginFloat;
+                for (; j + 8 <= endFloat; j += 8) {
+                    for (int k = 0; k < 8; k++) sums[k] += src[j + k];
+                }
+                for (; j < endFloat; j++) sums[j % 8] += src[j];
+                break;
+            }
+            case BandwidthKernel::WRITE:
+                std::fill(dst + beginFloat, dst + endFloat, 2.0f);
+                break;
+            case BandwidthKernel::STRIDED:
+                for (uint64_t j = begin; j < end; j++) {
+                    // Column-major walk of a (columns x STRIDE) matrix, as on the GPU
+                    const float* element = src + ((j % columns) * STRIDE + j / columns) * FLOATS_PER_ELEMENT;
+                    for (int k = 0; k < 4; k++) sums[k] += element[k];
+                }
+                break;
+            case BandwidthKernel::RANDOM:
+                for (uint64_t j = begin; j < end; j++) {
+                    // Same permutation as bandwidth.comp (32-bit multiply)
+                    uint32_t index = static_cast<uint32_t>(j * 2654435761u) & static_cast<uint32_t>(mask);
+                    const float* element = src + (uint64_t)index * FLOATS_PER_ELEMENT;
+                    for (int k = 0; k < 4; k++) sums[k] += element[k];
+                }
+                break;
+        }
+        // Repeated copies and fills must not collapse into one
+        if ((m_kernel == BandwidthKernel::COPY || m_kernel == BandwidthKernel::WRITE) && endFloat > beginFloat) {
+            sums[0] += dst[beginFloat];
+        }
+    }
+
+    float total = 0.0f;
+    for (float sum : sums) total += sum;
+    m_threadSums[thread] = total;
+}
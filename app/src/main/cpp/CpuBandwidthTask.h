@@ -0,0 +1,46 @@
+#pragma once
+
+#include "ComputeTask.h"
+#include "Roofline.h"
+#include <vector>
+
+// The CPU side of the roofline: the same kernels as GpuBandwidthTask (copy,
+// read, write, strided and random reads of 16-byte elements), run by one
+// thread per core over slices of the working set.
+//
+// Threads are started first and released together, so thread creation is
+// not timed; a run ends when the slowest thread finishes. As on the GPU,
+// every run visits at least GpuBandwidthTask::MIN_BYTES_PER_RUN.
+class CpuBandwidthTask : public ComputeTask {
+public:
+    explicit CpuBandwidthTask(uint64_t maxWorkingSetBytes);
+    ~CpuBandwidthTask();
+
+    // --- ComputeTask Interface ---
+    void init() override;
+    // The CPU-side time of one run, in us
+    long long dispatch() override;
+    void cleanup() override;
+
+    // --- Measuring ---
+    // Kernel and working set (a power of two, 1 KiB up to the capacity) of the next runs
+    void configure(BandwidthKernel kernel, uint64_t workingSetBytes);
+    uint64_t getBytesMoved() const;
+    // configure(), a warm-up, then the best of 'iterations' runs
+    BandwidthSample measure(BandwidthKernel kernel, uint64_t workingSetBytes, uint32_t iterations);
+
+private:
+    // One thread's share: elements [begin, end) of the working set, 'sweeps' times
+    void runSlice(int thread, uint64_t begin, uint64_t end);
+
+    uint64_t m_capacity; // Bytes per buffer
+    int m_numThreads;
+    BandwidthKernel m_kernel = BandwidthKernel::READ;
+    uint64_t m_workingSetBytes = 1024;
+    uint64_t m_sweeps = 1;
+    double m_lastUs = 0.0;
+
+    std::vector<float> m_src;
+    std::vector<float> m_dst;
+    std::vector<float> m_threadSums; // Keeps the reads from being optimized away
+};
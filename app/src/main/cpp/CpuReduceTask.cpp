@@ -1,10 +1,13 @@
 #include "CpuReduceTask.h"
+#include "Trace.h"
 #include <cmath> // For log2
+#include <algorithm>
 
 // --- Constructor / Destructor ---
 
 // THIS IS THE FIX: The constructor must match the .h file
-CpuReduceTask::CpuReduceTask(size_t n) : m_n(n) {
+CpuReduceTask::CpuReduceTask(size_t n, const InputDistribution& distribution)
+        : m_n(n), m_distribution(distribution) {
     m_numThreads = (int)std::thread::hardware_concurrency();
     if (m_numThreads == 0) m_numThreads = 4; // Fallback
 
@@ -24,12 +27,34 @@ CpuReduceTask::~CpuReduceTask() {
 void CpuReduceTask::init() {
     LOGI("CpuReduceTask::init() - Allocating %zu floats...", m_n);
     m_data.resize(m_n); // Use m_n
-    std::fill(m_data.begin(), m_data.end(), 1.0f);
+    InputGenerator::hostFill(m_distribution, m_data.data(), (uint32_t)m_n);
+    updateReference();
     m_threadPartialSums.resize(m_numThreads);
 
     LOGI("CpuReduceTask::init() complete.");
 }
 
+void CpuReduceTask::updateReference() {
+    double absSum = 0.0;
+    InputGenerator::hostReference(m_distribution, (uint32_t)m_n, m_expected, absSum);
+    m_tolerance = std::max(0.01, 1e-4 * absSum);
+}
+
+void CpuReduceTask::resize(uint32_t n) {
+    if (n > m_data.size()) {
+        size_t filled = m_data.size();
+        m_data.resize(std::max<size_t>(n, 2 * filled));
+        LOGI("CpuReduceTask: growing to %zu elements", m_data.size());
+        for (size_t i = filled; i < m_data.size(); i++) {
+            m_data[i] = InputGenerator::hostValue(m_distribution, (uint32_t)i);
+        }
+    }
+    if (n != m_n) {
+        m_n = n;
+        updateReference();
+    }
+}
+
 void CpuReduceTask::cleanup() {
     m_data.clear();
     m_threadPartialSums.clear();
@@ -37,7 +62,8 @@ void CpuReduceTask::cleanup() {
 }
 
 long long CpuReduceTask::dispatch() {
-    LOGI("CpuReduceTask::dispatch() starting for N=%zu...", m_n);
+    LOGD("CpuReduceTask::dispatch() starting for N=%zu...", m_n);
+    TRACE_SCOPE("CpuReduceTask::dispatch", "task");
 
     auto startTime = std::chrono::high_resolution_clock::now();
 
@@ -57,11 +83,11 @@ long long CpuReduceTask::dispatch() {
 
     // --- 3. Verify Result ---
     float result = m_threadPartialSums[0];
-    float expected = (float)m_n; // Use m_n
+    double expected = m_expected;
 
-    LOGI("--- CPU (N=%zu) ---", m_n);
-    LOGI("Result: %.0f (Expected: %.0f)", result, expected);
-    if (abs(result - expected) < 0.01f) {
+    LOGI("--- CPU (N=%zu, %s) ---", m_n, m_distribution.getName());
+    LOGI("Result: %.3f (Expected: %.3f)", result, expected);
+    if (std::fabs(result - expected) <= m_tolerance) {
         LOGI("SUCCESS");
     } else {
         LOGE("FAILED");
@@ -75,6 +101,8 @@ long long CpuReduceTask::dispatch() {
 // --- The Core Threading Logic ---
 
 void CpuReduceTask::reduceThread(size_t threadId) {
+    TRACE_THREAD_NAME("cpu reduce worker");
+    TRACE_SCOPE("reduceThread", "cpu");
 
     // --- 1. Local Reduction (Phase 1) ---
     size_t dataPerThread = m_n / m_numThreads; // Use m_n
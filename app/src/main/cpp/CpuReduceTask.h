@@ -2,6 +2,7 @@
 
 #include "ComputeTask.h"    // We must implement this interface
 #include "VulkanContext.h"  // For LOGI/LOGE macros
+#include "InputGenerator.h" // Same input values as the GPU tasks
 #include <vector>
 #include <thread>
 #include <numeric>
@@ -13,7 +14,7 @@
 
 class CpuReduceTask : public ComputeTask {
 public:
-    CpuReduceTask(size_t n);
+    CpuReduceTask(size_t n, const InputDistribution& distribution = InputDistribution::constant(1.0f));
     ~CpuReduceTask();
 
     // --- ComputeTask Interface ---
@@ -22,12 +23,24 @@ public:
     long long dispatch() override;
     void cleanup() override;
 
+    // --- Resizing ---
+    // The data only grows (at least doubling); its prefix always holds the
+    // distribution's first values, so growing fills in the new tail only
+    bool isResizable() override { return true; }
+    void resize(uint32_t n) override;
+    uint32_t getCapacity() override { return (uint32_t)m_data.size(); }
+
 private:
+    void updateReference();
+
     // The function each thread will run
     void reduceThread(size_t threadId);
 
     int m_numThreads;
     size_t m_n;
+    InputDistribution m_distribution;
+    double m_expected = 0.0;
+    double m_tolerance = 0.0;
 
     // Our data buffers
     std::vector<float> m_data;
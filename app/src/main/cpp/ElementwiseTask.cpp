@@ -0,0 +1,338 @@
+#include "ElementwiseTask.h"
+#include "UploadRing.h"
+#include <vector>
+#include <stdexcept>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+namespace {
+// IEEE half -> float, for checking TO_HALF on the host
+float halfToFloat(uint16_t h) {
+    uint32_t sign = (h >> 15) & 1;
+    uint32_t exponent = (h >> 10) & 0x1f;
+    uint32_t mantissa = h & 0x3ff;
+    float value;
+    if (exponent == 0) {
+        value = std::ldexp((float)mantissa, -24); // Subnormal
+    } else if (exponent == 31) {
+        value = mantissa == 0 ? INFINITY : NAN;
+    } else {
+        value = std::ldexp((float)(mantissa | 0x400), (int)exponent - 25);
+    }
+    return sign ? -value : value;
+}
+}
+
+ElementwiseTask::ElementwiseTask(AAssetManager* assetManager, ElementwiseOp op, uint32_t n)
+        : BaseComputeTask(assetManager), m_op(op), m_n(n) {
+    if (m_n == 0) {
+        throw std::runtime_error("ElementwiseTask needs at least one element!");
+    }
+    m_numVec4 = (m_n + 3) / 4;
+
+    // Padding lanes stay zero
+    size_t padded = (size_t)m_numVec4 * 4;
+    m_a.assign(padded, 0.0f);
+    for (uint32_t i = 0; i < m_n; i++) {
+        m_a[i] = (float)(i % 100) * 0.01f - 0.5f;
+    }
+    if (inputCount() >= 2) {
+        m_b.assign(padded, 0.0f);
+        for (uint32_t i = 0; i < m_n; i++) {
+            m_b[i] = (float)(i % 37) * 0.1f;
+        }
+    }
+    if (inputCount() >= 3) {
+        m_c.assign(padded, 0.0f);
+        for (uint32_t i = 0; i < m_n; i++) {
+            m_c[i] = 1.0f - (float)(i % 13) * 0.05f;
+        }
+    }
+
+    LOGI("ElementwiseTask created. Op=%s, N=%u", getOpName(m_op), m_n);
+}
+
+ElementwiseTask::~ElementwiseTask() {
+    LOGI("ElementwiseTask destroyed");
+}
+
+const char* ElementwiseTask::getOpName(ElementwiseOp op) {
+    switch (op) {
+        case ElementwiseOp::ADD: return "add";
+        case ElementwiseOp::AXPY: return "axpy";
+        case ElementwiseOp::SCALE: return "scale";
+        case ElementwiseOp::FMA: return "fma";
+        case ElementwiseOp::CLAMP: return "clamp";
+        case ElementwiseOp::TO_HALF: return "to-half";
+    }
+    return "unknown";
+}
+
+uint32_t ElementwiseTask::inputCount() const {
+    switch (m_op) {
+        case ElementwiseOp::ADD:
+        case ElementwiseOp::AXPY: return 2;
+        case ElementwiseOp::FMA: return 3;
+        default: return 1;
+    }
+}
+
+void ElementwiseTask::setInPlace(bool inPlace) {
+    if (inPlace && m_op == ElementwiseOp::TO_HALF) {
+        throw std::runtime_error("TO_HALF changes the element size and cannot run in place!");
+    }
+    m_inPlace = inPlace;
+}
+
+VkDeviceSize ElementwiseTask::outputSize() const {
+    // Four halves (8 bytes) or four floats (16 bytes) per vec4
+    return (VkDeviceSize)m_numVec4 * (m_op == ElementwiseOp::TO_HALF ? 8 : 16);
+}
+
+uint64_t ElementwiseTask::getBytesMoved() const {
+    return (uint64_t)m_numVec4 * 16 * inputCount() + outputSize();
+}
+
+// --- Overridden init() ---
+void ElementwiseTask::init() {
+    LOGI("ElementwiseTask::init() starting...");
+
+    createBuffers();
+    // B and C go out as one upload batch
+    m_context->getUploadRing()->submit();
+    createDescriptorSetLayout();
+    createDescriptorPool();
+    createDescriptorSet();
+
+    createPipelineLayout(sizeof(ElementwisePushData));
+    m_pipeline = createComputePipeline(getShaderPath());
+
+    m_profiler.init(m_context, 1); // Disabled if the compute queue has no timestamps
+
+    LOGI("ElementwiseTask::init() finished.");
+}
+
+void ElementwiseTask::cleanup() {
+    LOGI("ElementwiseTask::cleanup()");
+    VkDevice device = m_context->getDevice();
+
+    m_profiler.cleanup();
+
+    VkBuffer buffers[] = {m_bufferB, m_bufferC, m_outputBuffer};
+    VkDeviceMemory memories[] = {m_memoryB, m_memoryC, m_outputMemory};
+    for (VkBuffer buffer : buffers) {
+        if (buffer != VK_NULL_HANDLE) vkDestroyBuffer(device, buffer, nullptr);
+    }
+    for (VkDeviceMemory memory : memories) {
+        if (memory != VK_NULL_HANDLE) vkFreeMemory(device, memory, nullptr);
+    }
+    m_bufferB = m_bufferC = m_outputBuffer = VK_NULL_HANDLE;
+    m_memoryB = m_memoryC = m_outputMemory = VK_NULL_HANDLE;
+    m_bufferA.destroy();
+    m_readbackBuffer.destroy();
+
+    BaseComputeTask::cleanup();
+}
+
+// --- "Fill-in-the-blank" Implementations ---
+
+std::string ElementwiseTask::getShaderPath() {
+    return "shaders/elementwise.spv";
+}
+
+void ElementwiseTask::createDescriptorSetLayout() {
+    // 0 = a, 1 = b, 2 = c, 3 = float output, 4 = half output
+    std::vector<VkDescriptorSetLayoutBinding> bindings(5);
+    for (uint32_t i = 0; i < bindings.size(); i++) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+    if (vkCreateDescriptorSetLayout(m_context->getDevice(), &layoutInfo, nullptr, &m_descriptorSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create descriptor set layout!");
+    }
+}
+
+void ElementwiseTask::createBuffers() {
+    VkDeviceSize inputSize = (VkDeviceSize)m_numVec4 * 16;
+
+    // A is written in place on unified memory and staged on discrete GPUs;
+    // in-place runs overwrite it, so it is re-filled before each of them
+    m_bufferA.create(m_context, inputSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+    resetInput();
+
+    // B and C never change after init (filled via the upload ring)
+    if (!m_b.empty()) createStagingBuffer(m_bufferB, m_memoryB, inputSize, m_b.data());
+    if (!m_c.empty()) createStagingBuffer(m_bufferC, m_memoryC, inputSize, m_c.data());
+
+    if (!m_inPlace) {
+        createBuffer(m_outputBuffer, m_outputMemory, outputSize(),
+                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, MemoryUsage::GPU_ONLY);
+    }
+
+    m_readbackBuffer.create(m_context, outputSize(), VK_BUFFER_USAGE_TRANSFER_DST_BIT, MemoryUsage::READBACK);
+}
+
+void ElementwiseTask::resetInput() {
+    std::copy(m_a.begin(), m_a.end(), m_bufferA.data<float>());
+    // No-op on coherent memory
+    m_bufferA.flush();
+    m_inputDirty = true;
+}
+
+void ElementwiseTask::createDescriptorPool() {
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = 5;
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    poolInfo.maxSets = 1;
+    if (vkCreateDescriptorPool(m_context->getDevice(), &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create descriptor pool!");
+    }
+}
+
+void ElementwiseTask::createDescriptorSet() {
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_descriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &m_descriptorSetLayout;
+    if (vkAllocateDescriptorSets(m_context->getDevice(), &allocInfo, &m_descriptorSet) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate descriptor set!");
+    }
+
+    // Bindings the op does not use still need a buffer: they fall back to A.
+    // In place, the float output is A itself.
+    VkBuffer a = m_bufferA.getBuffer();
+    bool half = (m_op == ElementwiseOp::TO_HALF);
+    VkBuffer buffers[5] = {
+            a,
+            m_bufferB != VK_NULL_HANDLE ? m_bufferB : a,
+            m_bufferC != VK_NULL_HANDLE ? m_bufferC : a,
+            (m_inPlace || half) ? a : m_outputBuffer,
+            half ? m_outputBuffer : a
+    };
+
+    VkDescriptorBufferInfo bufferInfos[5]{};
+    std::vector<VkWriteDescriptorSet> writes(5);
+    for (uint32_t i = 0; i < 5; i++) {
+        bufferInfos[i].buffer = buffers[i];
+        bufferInfos[i].offset = 0;
+        bufferInfos[i].range = VK_WHOLE_SIZE;
+
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = m_descriptorSet;
+        writes[i].dstBinding = i;
+        writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[i].descriptorCount = 1;
+        writes[i].pBufferInfo = &bufferInfos[i];
+    }
+    vkUpdateDescriptorSets(m_context->getDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+}
+
+// --- Dispatch ---
+
+long long ElementwiseTask::dispatch() {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    double submitUs = GpuProfiler::nowUs();
+    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+    record(commandBuffer);
+    endSingleTimeCommands(commandBuffer);
+    m_hostSubmitUs = submitUs;
+    m_hostCompleteUs = GpuProfiler::nowUs();
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+
+    return duration.count(); // Return the CPU-side time
+}
+
+void ElementwiseTask::record(VkCommandBuffer commandBuffer) {
+    m_hostSubmitUs = -1.0; // Whoever submits this may not be dispatch()
+    m_hostCompleteUs = -1.0;
+    // In-place runs start again from the original A. The upload comes before the kernel region,
+    // but dispatch()'s CPU-side time includes it
+    if (m_inPlace && !m_inputDirty) {
+        resetInput();
+    }
+    if (m_inputDirty) {
+        m_bufferA.recordUpload(commandBuffer);
+        m_inputDirty = false;
+    }
+
+    m_profiler.reset(commandBuffer);
+    uint32_t region = m_profiler.beginRegion(commandBuffer, "kernel");
+
+    ElementwisePushData pushData{};
+    pushData.op = static_cast<uint32_t>(m_op);
+    pushData.numVec4 = m_numVec4;
+    pushData.alpha = m_alpha;
+    pushData.lo = m_lo;
+    pushData.hi = m_hi;
+
+    uint32_t groups = (m_numVec4 + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+    groups = std::min(groups, MAX_GROUPS);
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline);
+    vkCmdPushConstants(commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                       sizeof(ElementwisePushData), &pushData);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout, 0, 1,
+                            &m_descriptorSet, 0, nullptr);
+    vkCmdDispatch(commandBuffer, groups, 1, 1);
+
+    m_profiler.endRegion(commandBuffer, region);
+
+    // --- Read Back Result (outside the timed region) ---
+    VkBuffer output = m_inPlace ? m_bufferA.getBuffer() : m_outputBuffer;
+    recordResultCopy(commandBuffer, output, m_readbackBuffer.getBuffer(), outputSize());
+}
+
+float ElementwiseTask::expectedAt(uint32_t i) const {
+    switch (m_op) {
+        case ElementwiseOp::ADD: return m_a[i] + m_b[i];
+        case ElementwiseOp::AXPY: return m_a[i] + m_alpha * m_b[i];
+        case ElementwiseOp::SCALE: return m_alpha * m_a[i];
+        case ElementwiseOp::FMA: return m_a[i] * m_b[i] + m_c[i];
+        case ElementwiseOp::CLAMP: return std::min(std::max(m_a[i], m_lo), m_hi);
+        case ElementwiseOp::TO_HALF: return m_a[i];
+    }
+    return 0.0f;
+}
+
+TaskResult ElementwiseTask::readResult() {
+    TaskResult result;
+
+    // Non-coherent (e.g. HOST_CACHED) memory must be invalidated before the CPU reads it
+    m_readbackBuffer.invalidate();
+    bool half = (m_op == ElementwiseOp::TO_HALF);
+    const float* values = m_readbackBuffer.data<float>();
+    const uint16_t* halves = m_readbackBuffer.data<uint16_t>();
+
+    for (uint32_t i = 0; i < m_n; i++) {
+        float value = half ? halfToFloat(halves[i]) : values[i];
+        float expected = expectedAt(i);
+        // Halves keep 11 significant bits; fma may round once instead of twice
+        float tolerance = half ? 1e-3f * std::max(1.0f, std::fabs(expected)) + 1e-4f
+                               : 1e-5f * std::max(1.0f, std::fabs(expected));
+        result.value += value;
+        if (!(std::fabs(value - expected) <= tolerance)) {
+            if (result.valid) {
+                LOGE("%s[%u]: %.6f (Expected: %.6f)", getOpName(m_op), i, value, expected);
+            }
+            result.valid = false;
+        }
+    }
+
+    // <0 unless every reading passed the profiler's checks (valid bits, availability, order, CPU bracket)
+    result.gpuTimeUs = m_profiler.resolve(m_hostSubmitUs, m_hostCompleteUs).durationUs("kernel");
+    return result;
+}
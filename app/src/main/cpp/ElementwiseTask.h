@@ -0,0 +1,109 @@
+#pragma once
+
+#include "BaseComputeTask.h"
+#include "MappedBuffer.h"
+#include "GpuProfiler.h"
+#include <vector>
+
+// This struct MUST match the layout in elementwise.comp
+struct ElementwisePushData {
+    uint32_t op;      // ElementwiseOp
+    uint32_t numVec4; // ceil(N / 4)
+    float alpha;      // axpy, scale
+    float lo;         // clamp
+    float hi;
+};
+
+// The ops of the elementwise library (values match the shader's op codes)
+enum class ElementwiseOp : uint32_t {
+    ADD = 0,    // out = a + b
+    AXPY = 1,   // out = a + alpha * b
+    SCALE = 2,  // out = alpha * a
+    FMA = 3,    // out = a * b + c
+    CLAMP = 4,  // out = clamp(a, lo, hi)
+    TO_HALF = 5 // out = half(a), packed (half the bytes of the input)
+};
+
+// Streaming elementwise kernels for any N.
+//
+// The shader works on vec4s in a grid-stride loop; buffers are padded to a
+// whole vec4, so there is no scalar tail path. In-place mode writes the
+// result over 'a' and saves the output buffer (the traffic is the same).
+//
+// Inputs are generated on the host and checked element by element in
+// readResult(). The output is copied to a readback buffer after the timed
+// region, so GPU times cover the kernel only.
+class ElementwiseTask : public BaseComputeTask {
+public:
+    ElementwiseTask(AAssetManager* assetManager, ElementwiseOp op, uint32_t n);
+    ~ElementwiseTask();
+
+    // --- ComputeTask Interface ---
+    void init() override;
+    long long dispatch() override;
+    void cleanup() override;
+
+    // --- Batching ---
+    bool isRecordable() override { return true; }
+    void record(VkCommandBuffer commandBuffer) override;
+    // value = sum of the outputs; valid = every element matches the host
+    TaskResult readResult() override;
+
+    // --- Parameters (call before init()) ---
+    void setInPlace(bool inPlace);
+    void setAlpha(float alpha) { m_alpha = alpha; }
+    void setClampRange(float lo, float hi) { m_lo = lo; m_hi = hi; }
+
+    ElementwiseOp getOp() const { return m_op; }
+    bool isInPlace() const { return m_inPlace; }
+    static const char* getOpName(ElementwiseOp op);
+    // Bytes the kernel reads and writes per dispatch
+    uint64_t getBytesMoved() const;
+
+protected:
+    // --- BaseComputeTask "Fill-in-the-blanks" ---
+    std::string getShaderPath() override;
+    void createDescriptorSetLayout() override;
+    void createBuffers() override;
+    void createDescriptorPool() override;
+    void createDescriptorSet() override;
+
+private:
+    uint32_t inputCount() const;
+    float expectedAt(uint32_t i) const;
+    // Rewrites 'a' (in-place runs overwrite it)
+    void resetInput();
+    VkDeviceSize outputSize() const;
+
+    ElementwiseOp m_op;
+    uint32_t m_n;
+    uint32_t m_numVec4;
+    bool m_inPlace = false;
+    float m_alpha = 2.0f;
+    float m_lo = -0.25f;
+    float m_hi = 0.25f;
+
+    // --- Host data (padded to whole vec4s) ---
+    std::vector<float> m_a;
+    std::vector<float> m_b;
+    std::vector<float> m_c;
+
+    // --- Buffers ---
+    UploadBuffer m_bufferA;                   // Re-uploaded after in-place runs
+    bool m_inputDirty = true;
+    VkBuffer m_bufferB = VK_NULL_HANDLE;      // ADD, AXPY, FMA
+    VkDeviceMemory m_memoryB = VK_NULL_HANDLE;
+    VkBuffer m_bufferC = VK_NULL_HANDLE;      // FMA
+    VkDeviceMemory m_memoryC = VK_NULL_HANDLE;
+    VkBuffer m_outputBuffer = VK_NULL_HANDLE; // Not in place
+    VkDeviceMemory m_outputMemory = VK_NULL_HANDLE;
+    MappedBuffer m_readbackBuffer;
+
+    // "kernel" region, checked against dispatch()'s CPU-side bracket
+    GpuProfiler m_profiler;
+    double m_hostSubmitUs = -1.0;
+    double m_hostCompleteUs = -1.0;
+
+    static const uint32_t WORKGROUP_SIZE = 256;
+    static constexpr uint32_t MAX_GROUPS = 1024; // Enough to fill a mobile GPU; the loop covers the rest
+};
@@ -0,0 +1,309 @@
+#include "FrugalReduceTask.h"
+#include "GpuOptimizedReduceTask.h" // PushData
+#include <vector>
+#include <stdexcept>
+#include <chrono>
+#include <algorithm>
+
+FrugalReduceTask::FrugalReduceTask(AAssetManager* assetManager, uint32_t n)
+        : BaseComputeTask(assetManager), m_n(n), m_capacity(n), m_groups(groupCount(n)), m_ownsInput(true) {
+    if (m_n == 0) {
+        throw std::runtime_error("FrugalReduceTask needs N > 0!");
+    }
+    LOGI("FrugalReduceTask created. N=%u (owned input), %u groups", m_n, m_groups);
+}
+
+FrugalReduceTask::FrugalReduceTask(AAssetManager* assetManager, VkBuffer input, uint32_t n, double expectedSum)
+        : BaseComputeTask(assetManager), m_n(n), m_capacity(n), m_groups(groupCount(n)), m_ownsInput(false),
+          m_inputBuffer(input), m_expected(expectedSum) {
+    if (m_n == 0 || input == VK_NULL_HANDLE) {
+        throw std::runtime_error("FrugalReduceTask needs an input buffer and N > 0!");
+    }
+    m_tolerance = std::max(0.01, 1e-4 * std::fabs(expectedSum));
+    LOGI("FrugalReduceTask created. N=%u (borrowed input), %u groups", m_n, m_groups);
+}
+
+FrugalReduceTask::~FrugalReduceTask() {
+    LOGI("FrugalReduceTask destroyed");
+}
+
+uint32_t FrugalReduceTask::groupCount(uint32_t n) {
+    return std::min((n + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, MAX_GROUPS);
+}
+
+void FrugalReduceTask::setElementCount(uint32_t n, double expectedSum) {
+    if (m_ownsInput || n == 0 || n > m_capacity) {
+        throw std::runtime_error("FrugalReduceTask: element count out of range!");
+    }
+    // Fewer elements never need more groups, so the scratch regions and descriptor sets still fit
+    m_n = n;
+    m_groups = groupCount(n);
+    m_expected = expectedSum;
+    m_tolerance = std::max(0.01, 1e-4 * std::fabs(expectedSum));
+    m_recorded = false;
+}
+
+// --- Overridden init() ---
+void FrugalReduceTask::init() {
+    LOGI("FrugalReduceTask::init() starting...");
+
+    createBuffers();
+    createDescriptorSetLayout();
+    createDescriptorPool();
+    createDescriptorSet();
+
+    createPipelineLayout(sizeof(PushData));
+    m_pipeline = createComputePipeline(getShaderPath());
+
+    m_profiler.init(m_context, 1); // Disabled if the compute queue has no timestamps
+
+    if (m_ownsInput) {
+        generateInput();
+    }
+
+    LOGI("FrugalReduceTask::init() finished. Device memory: %llu bytes (scratch %llu)",
+         (unsigned long long)getDeviceMemoryBytes(), (unsigned long long)m_scratch.size);
+}
+
+void FrugalReduceTask::generateInput() {
+    // Written once: no pass ever writes the input, so it never needs regenerating
+    InputGenerator generator;
+    generator.init(m_context, loadShaderModule(InputGenerator::SHADER_PATH));
+    uint32_t target = generator.addTarget(m_inputBuffer);
+
+    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+    generator.record(commandBuffer, target, m_n, m_distribution);
+    endSingleTimeCommands(commandBuffer);
+    generator.cleanup();
+
+    double absSum = 0.0;
+    InputGenerator::hostReference(m_distribution, m_n, m_expected, absSum);
+    // Float partial sums in a different order: allow a relative error on the magnitudes
+    m_tolerance = std::max(0.01, 1e-4 * absSum);
+}
+
+void FrugalReduceTask::cleanup() {
+    LOGI("FrugalReduceTask::cleanup()");
+    VkDevice device = m_context->getDevice();
+
+    m_profiler.cleanup();
+
+    // A borrowed input stays with its owner
+    if (m_ownsInput) {
+        if (m_inputBuffer != VK_NULL_HANDLE) vkDestroyBuffer(device, m_inputBuffer, nullptr);
+        if (m_inputMemory != VK_NULL_HANDLE) vkFreeMemory(device, m_inputMemory, nullptr);
+        m_inputBuffer = VK_NULL_HANDLE;
+        m_inputMemory = VK_NULL_HANDLE;
+        m_inputAllocationSize = 0;
+    }
+    m_context->getScratchPool()->release(m_scratch);
+    m_resultBuffer.destroy();
+    m_recorded = false;
+
+    // Descriptor sets go away with the pool
+    BaseComputeTask::cleanup();
+}
+
+// --- "Fill-in-the-blank" Implementations ---
+
+std::string FrugalReduceTask::getShaderPath() {
+    return "shaders/reduce_optimized.spv";
+}
+
+void FrugalReduceTask::createDescriptorSetLayout() {
+    // Same layout as GpuOptimizedReduceTask: 0 = in, 1 = out
+    std::vector<VkDescriptorSetLayoutBinding> bindings(2);
+    for (uint32_t i = 0; i < bindings.size(); i++) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+    if (vkCreateDescriptorSetLayout(m_context->getDevice(), &layoutInfo, nullptr, &m_descriptorSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create descriptor set layout!");
+    }
+}
+
+void FrugalReduceTask::createBuffers() {
+    if (m_ownsInput) {
+        // Device-only, filled by the input generator (TRANSFER_DST for constant fills)
+        createBuffer(m_inputBuffer, m_inputMemory, sizeof(float) * (VkDeviceSize)m_n,
+                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, MemoryUsage::GPU_ONLY);
+        VkMemoryRequirements memRequirements;
+        vkGetBufferMemoryRequirements(m_context->getDevice(), m_inputBuffer, &memRequirements);
+        m_inputAllocationSize = memRequirements.size;
+    }
+
+    // Region 0: one partial per pass-1 group; region 1: the first tree level.
+    // Region 1 starts at a descriptor-offset boundary so it can be bound on its own.
+    // Sized for the capacity, so setElementCount() never outgrows them.
+    ScratchPool* pool = m_context->getScratchPool();
+    uint32_t maxGroups = groupCount(m_capacity);
+    m_region1Offset = pool->align(sizeof(float) * maxGroups);
+    VkDeviceSize region1Size = sizeof(float) * ((maxGroups + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE);
+    m_scratch = pool->allocate(m_region1Offset + region1Size);
+
+    m_resultBuffer.create(m_context, sizeof(float), VK_BUFFER_USAGE_TRANSFER_DST_BIT, MemoryUsage::READBACK);
+}
+
+void FrugalReduceTask::createDescriptorPool() {
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = 6;
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    poolInfo.maxSets = 3;
+    if (vkCreateDescriptorPool(m_context->getDevice(), &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create descriptor pool!");
+    }
+}
+
+void FrugalReduceTask::createDescriptorSet() {
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_descriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &m_descriptorSetLayout;
+    if (vkAllocateDescriptorSets(m_context->getDevice(), &allocInfo, &m_descriptorSet) != VK_SUCCESS ||
+        vkAllocateDescriptorSets(m_context->getDevice(), &allocInfo, &m_setR0toR1) != VK_SUCCESS ||
+        vkAllocateDescriptorSets(m_context->getDevice(), &allocInfo, &m_setR1toR0) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate descriptor set!");
+    }
+
+    VkBuffer scratch = m_scratch.buffer;
+    VkDeviceSize region0 = m_scratch.offset;
+    VkDeviceSize region1 = m_scratch.offset + m_region1Offset;
+    VkDeviceSize region0Size = m_region1Offset;
+    VkDeviceSize region1Size = m_scratch.size - m_region1Offset;
+    writeDescriptorSet(m_descriptorSet, m_inputBuffer, 0, VK_WHOLE_SIZE, region0, region0Size);
+    writeDescriptorSet(m_setR0toR1, scratch, region0, region0Size, region1, region1Size);
+    writeDescriptorSet(m_setR1toR0, scratch, region1, region1Size, region0, region0Size);
+}
+
+void FrugalReduceTask::writeDescriptorSet(VkDescriptorSet set, VkBuffer in, VkDeviceSize inOffset,
+                                          VkDeviceSize inRange, VkDeviceSize outOffset, VkDeviceSize outRange) {
+    VkDescriptorBufferInfo bufferInfos[2]{};
+    bufferInfos[0].buffer = in;
+    bufferInfos[0].offset = inOffset;
+    bufferInfos[0].range = inRange;
+    bufferInfos[1].buffer = m_scratch.buffer;
+    bufferInfos[1].offset = outOffset;
+    bufferInfos[1].range = outRange;
+
+    std::vector<VkWriteDescriptorSet> writes(2);
+    for (uint32_t i = 0; i < 2; i++) {
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = set;
+        writes[i].dstBinding = i;
+        writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[i].descriptorCount = 1;
+        writes[i].pBufferInfo = &bufferInfos[i];
+    }
+    vkUpdateDescriptorSets(m_context->getDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+}
+
+// --- Dispatch ---
+
+long long FrugalReduceTask::dispatch() {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    double submitUs = GpuProfiler::nowUs();
+    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+    record(commandBuffer);
+    endSingleTimeCommands(commandBuffer);
+    m_hostSubmitUs = submitUs;
+    m_hostCompleteUs = GpuProfiler::nowUs();
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+
+    return duration.count(); // Return the CPU-side time
+}
+
+void FrugalReduceTask::record(VkCommandBuffer commandBuffer) {
+    m_hostSubmitUs = -1.0; // Whoever submits this may not be dispatch()
+    m_hostCompleteUs = -1.0;
+    m_profiler.reset(commandBuffer);
+    uint32_t region = m_profiler.beginRegion(commandBuffer, "reduce");
+
+    // Both regions share the pool's buffer, so every pass declares it READ_WRITE
+    VkBuffer scratch = m_scratch.buffer;
+    m_graph.clear();
+
+    // --- 1. Grid-stride local reduce (N -> m_groups partials), input -> region 0 ---
+    PushData pushData{};
+    pushData.passType = 2;
+    pushData.numElements = m_n;
+    uint32_t remaining = m_groups;
+    m_graph.addDispatch("grid-stride", m_pipeline, m_pipelineLayout, m_descriptorSet, &pushData, sizeof(PushData),
+                        remaining, {{m_inputBuffer, GraphAccess::READ}, {scratch, GraphAccess::WRITE}});
+
+    // --- 2. Tree passes between the two regions (at most two: 1024 -> 4 -> 1) ---
+    bool resultInRegion0 = true;
+    pushData.passType = 1;
+    while (remaining > 1) {
+        pushData.numElements = remaining;
+        remaining = (remaining + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+        m_graph.addDispatch("tree", m_pipeline, m_pipelineLayout, resultInRegion0 ? m_setR0toR1 : m_setR1toR0,
+                            &pushData, sizeof(PushData), remaining, {{scratch, GraphAccess::READ_WRITE}});
+        resultInRegion0 = !resultInRegion0;
+    }
+
+    // --- 3. Read Back Result ---
+    VkDeviceSize resultOffset = m_scratch.offset + (resultInRegion0 ? 0 : m_region1Offset);
+    m_graph.addCopy("result-copy", scratch, m_resultBuffer.getBuffer(), sizeof(float), resultOffset, 0);
+    m_graph.addHostRead(m_resultBuffer.getBuffer());
+    m_graph.record(commandBuffer);
+    m_recorded = true;
+
+    m_profiler.endRegion(commandBuffer, region);
+}
+
+TaskResult FrugalReduceTask::readResult() {
+    TaskResult result;
+    if (!m_recorded) {
+        result.valid = false;
+        return result;
+    }
+
+    // Non-coherent (e.g. HOST_CACHED) memory must be invalidated before the CPU reads it
+    m_resultBuffer.invalidate(0, sizeof(float));
+    result.value = *m_resultBuffer.data<float>();
+    // Without a reference (borrowed input, no expected sum) there is nothing to check
+    result.valid = std::isnan(m_expected) || std::fabs(result.value - m_expected) <= m_tolerance;
+
+    // <0 unless every reading passed the profiler's checks (valid bits, availability, order, CPU bracket)
+    result.gpuTimeUs = m_profiler.resolve(m_hostSubmitUs, m_hostCompleteUs).durationUs("reduce");
+    return result;
+}
+
+// --- Footprint ---
+
+VkDeviceSize FrugalReduceTask::getDeviceMemoryBytes() const {
+    // Allocation sizes, not requested sizes: what the driver actually reserved
+    return m_inputAllocationSize + m_scratch.size + m_resultBuffer.getAllocationSize();
+}
+
+VkDeviceSize FrugalReduceTask::estimateDeviceMemory(uint32_t n, bool ownsInput) {
+    // Every allocation rounded up to 64 KiB (above the usual memory alignment),
+    // descriptor offsets to 256 (the largest minStorageBufferOffsetAlignment allowed)
+    const VkDeviceSize allocationGranularity = 64 * 1024;
+    const VkDeviceSize offsetAlignment = 256;
+    auto roundUp = [](VkDeviceSize value, VkDeviceSize alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    };
+
+    uint32_t groups = groupCount(n);
+    VkDeviceSize scratch = roundUp(sizeof(float) * groups, offsetAlignment) +
+                           roundUp(sizeof(float) * ((groups + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE), offsetAlignment);
+    VkDeviceSize bytes = scratch + allocationGranularity; // + the readback buffer
+    if (ownsInput) {
+        bytes += roundUp(sizeof(float) * (VkDeviceSize)n, allocationGranularity);
+    }
+    return bytes;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "BaseComputeTask.h"
+#include "MappedBuffer.h"
+#include "ComputeGraph.h"
+#include "InputGenerator.h"
+#include "ScratchPool.h"
+#include <cmath>
+
+// Sum reduction whose device memory does not grow with N beyond the input.
+//
+// The input is only ever read: the first pass is a grid-stride reduce with a
+// capped grid (reduce_optimized.comp pass type 2), so it leaves at most
+// MAX_GROUPS partials whatever N is. Those and the tree passes after them live
+// in one range carved from the context's ScratchPool, and the sum is copied
+// into a 4-byte readback buffer.
+//
+// The input is either owned (generated once on the GPU at init) or borrowed
+// from the caller, who keeps it alive until cleanup(). A borrowed input needs
+// STORAGE_BUFFER usage and at least N floats.
+class FrugalReduceTask : public BaseComputeTask {
+public:
+    // Owned input
+    FrugalReduceTask(AAssetManager* assetManager, uint32_t n);
+    // Borrowed input; readResult() checks against 'expectedSum' unless it is NaN
+    FrugalReduceTask(AAssetManager* assetManager, VkBuffer input, uint32_t n, double expectedSum = NAN);
+    ~FrugalReduceTask();
+
+    // --- ComputeTask Interface ---
+    void init() override;
+    long long dispatch() override;
+    void cleanup() override;
+
+    // --- Batching ---
+    bool isRecordable() override { return true; }
+    void record(VkCommandBuffer commandBuffer) override;
+    TaskResult readResult() override;
+
+    // Owned input only; call before init()
+    void setInputDistribution(const InputDistribution& distribution) { m_distribution = distribution; }
+    VkBuffer getInputBuffer() const { return m_inputBuffer; }
+    // Borrowed input only: reduce the first 'n' elements (n <= the N given at construction) from the next
+    // record() on; readResult() checks against 'expectedSum' unless it is NaN
+    void setElementCount(uint32_t n, double expectedSum = NAN);
+    uint32_t getElementCount() const { return m_n; }
+    double getExpectedSum() const { return m_expected; }
+
+    // --- Footprint ---
+    // Device memory this task holds after init(), in bytes: the owned input's
+    // allocation, its scratch range and the readback allocation
+    VkDeviceSize getDeviceMemoryBytes() const;
+    VkDeviceSize getScratchBytes() const { return m_scratch.size; }
+    // Upper bound of getDeviceMemoryBytes() before creating anything, for admission
+    static VkDeviceSize estimateDeviceMemory(uint32_t n, bool ownsInput);
+
+protected:
+    // --- BaseComputeTask "Fill-in-the-blanks" ---
+    std::string getShaderPath() override;
+    void createDescriptorSetLayout() override;
+    void createBuffers() override;
+    void createDescriptorPool() override;
+    void createDescriptorSet() override;
+
+private:
+    static uint32_t groupCount(uint32_t n);
+    void generateInput();
+    void writeDescriptorSet(VkDescriptorSet set, VkBuffer in, VkDeviceSize inOffset, VkDeviceSize inRange,
+                            VkDeviceSize outOffset, VkDeviceSize outRange);
+
+    uint32_t m_n;
+    uint32_t m_capacity; // N at construction: what the scratch regions are sized for
+    uint32_t m_groups;
+    bool m_ownsInput;
+
+    // --- Input ---
+    VkBuffer m_inputBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory m_inputMemory = VK_NULL_HANDLE; // Owned input only
+    VkDeviceSize m_inputAllocationSize = 0;
+    InputDistribution m_distribution; // All 1.0 by default
+    double m_expected = NAN;
+    double m_tolerance = 0.0;
+
+    // --- Scratch: two regions of one pooled range ---
+    // Region 0 holds the pass-1 partials, region 1 the first tree level
+    ScratchRange m_scratch;
+    VkDeviceSize m_region1Offset = 0; // Relative to m_scratch.offset
+    MappedBuffer m_resultBuffer;      // The sum, 4 bytes
+
+    // m_descriptorSet: input -> region 0; m_setR0toR1 / m_setR1toR0: the tree passes
+    VkDescriptorSet m_setR0toR1 = VK_NULL_HANDLE;
+    VkDescriptorSet m_setR1toR0 = VK_NULL_HANDLE;
+    ComputeGraph m_graph;
+
+    // "reduce" region, checked against dispatch()'s CPU-side bracket
+    GpuProfiler m_profiler;
+    double m_hostSubmitUs = -1.0;
+    double m_hostCompleteUs = -1.0;
+    bool m_recorded = false; // readResult() has something to read
+
+    static const uint32_t WORKGROUP_SIZE = 256;
+    static constexpr uint32_t MAX_GROUPS = 1024; // Pass 1 grid cap: at most 1024 partials
+};
@@ -0,0 +1,434 @@
+#include "FusedReduceTask.h"
+#include "UploadRing.h"
+#include <vector>
+#include <stdexcept>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+FusedReduceTask::FusedReduceTask(AAssetManager* assetManager, FusedOp op, uint32_t n, FusedInput input)
+        : BaseComputeTask(assetManager), m_op(op), m_n(n), m_count(n), m_input(input) {
+    if (m_n == 0 || m_n >= (1u << 24)) {
+        throw std::runtime_error("FusedReduceTask needs 0 < N < 2^24!");
+    }
+    if (m_input == FusedInput::HOST) {
+        if (m_op == FusedOp::DOT) {
+            throw std::runtime_error("FusedReduceTask host input supports single-input ops only!");
+        }
+        LOGI("FusedReduceTask created. Op=%s, capacity=%u (host input)", getOpName(m_op), m_n);
+        return;
+    }
+
+    // Small repeating values with both signs, exact in float
+    m_a.resize(m_n);
+    for (uint32_t i = 0; i < m_n; i++) {
+        m_a[i] = (float)((int)(i % 17) - 8) * 0.125f;
+    }
+    if (m_op == FusedOp::DOT) {
+        m_b.resize(m_n);
+        for (uint32_t i = 0; i < m_n; i++) {
+            m_b[i] = (float)((int)(i % 11) - 5) * 0.25f;
+        }
+    }
+    computeReference();
+
+    LOGI("FusedReduceTask created. Op=%s, N=%u", getOpName(m_op), m_n);
+}
+
+FusedReduceTask::~FusedReduceTask() {
+    LOGI("FusedReduceTask destroyed");
+}
+
+const char* FusedReduceTask::getOpName(FusedOp op) {
+    switch (op) {
+        case FusedOp::SUM: return "sum";
+        case FusedOp::DOT: return "dot";
+        case FusedOp::SUM_OF_SQUARES: return "sum-of-squares";
+        case FusedOp::L1_NORM: return "l1-norm";
+        case FusedOp::L2_NORM: return "l2-norm";
+        case FusedOp::MEAN_VARIANCE: return "mean-variance";
+    }
+    return "unknown";
+}
+
+uint32_t FusedReduceTask::shaderOp() const {
+    switch (m_op) {
+        case FusedOp::SUM: return 0;
+        case FusedOp::DOT: return 1;
+        case FusedOp::SUM_OF_SQUARES:
+        case FusedOp::L2_NORM: return 2; // The square root is taken on the host
+        case FusedOp::L1_NORM: return 3;
+        case FusedOp::MEAN_VARIANCE: return 4;
+    }
+    return 0;
+}
+
+void FusedReduceTask::computeReference() {
+    // Double accumulation; the tolerance scales with the sum of magnitudes
+    double sum = 0.0;
+    double magnitude = 0.0;
+    for (uint32_t i = 0; i < m_n; i++) {
+        double a = m_a[i];
+        double term = a;
+        switch (m_op) {
+            case FusedOp::DOT: term = a * m_b[i]; break;
+            case FusedOp::SUM_OF_SQUARES:
+            case FusedOp::L2_NORM: term = a * a; break;
+            case FusedOp::L1_NORM: term = std::fabs(a); break;
+            default: break;
+        }
+        sum += term;
+        magnitude += std::fabs(term);
+    }
+    m_expected = sum;
+    m_tolerance = 1e-4 * std::max(1.0, magnitude);
+
+    if (m_op == FusedOp::MEAN_VARIANCE) {
+        double mean = sum / m_n;
+        double m2 = 0.0;
+        for (uint32_t i = 0; i < m_n; i++) {
+            m2 += (m_a[i] - mean) * (m_a[i] - mean);
+        }
+        m_expected = mean;
+        m_expectedVariance = m2 / m_n;
+        m_tolerance = 1e-4 * std::max(1.0, magnitude / m_n);
+    }
+}
+
+// --- Overridden init() ---
+void FusedReduceTask::init() {
+    LOGI("FusedReduceTask::init() starting (%s)...", m_fused ? "fused" : "unfused");
+
+    createBuffers();
+    // Inputs go out as one upload batch
+    m_context->getUploadRing()->submit();
+    createDescriptorSetLayout();
+    createDescriptorPool();
+    createDescriptorSet();
+
+    createPipelineLayout(sizeof(FusedPushData));
+    m_pipeline = createComputePipeline(getShaderPath());
+
+    m_profiler.init(m_context, 1); // Disabled if the compute queue has no timestamps
+
+    LOGI("FusedReduceTask::init() finished.");
+}
+
+void FusedReduceTask::cleanup() {
+    LOGI("FusedReduceTask::cleanup()");
+    VkDevice device = m_context->getDevice();
+
+    m_profiler.cleanup();
+
+    if (m_input == FusedInput::HOST) {
+        m_bufferA = VK_NULL_HANDLE; // m_hostInput's, or borrowed
+        m_hostInput.destroy();
+    }
+    VkBuffer buffers[] = {m_bufferA, m_bufferB, m_partialsP, m_partialsQ, m_mappedBuffer};
+    VkDeviceMemory memories[] = {m_memoryA, m_memoryB, m_partialsPMemory, m_partialsQMemory, m_mappedMemory};
+    for (VkBuffer buffer : buffers) {
+        if (buffer != VK_NULL_HANDLE) vkDestroyBuffer(device, buffer, nullptr);
+    }
+    for (VkDeviceMemory memory : memories) {
+        if (memory != VK_NULL_HANDLE) vkFreeMemory(device, memory, nullptr);
+    }
+    m_bufferA = m_bufferB = m_partialsP = m_partialsQ = m_mappedBuffer = VK_NULL_HANDLE;
+    m_memoryA = m_memoryB = m_partialsPMemory = m_partialsQMemory = m_mappedMemory = VK_NULL_HANDLE;
+    m_resultBuffer.destroy();
+
+    // Descriptor sets go away with the pool
+    BaseComputeTask::cleanup();
+}
+
+// --- "Fill-in-the-blank" Implementations ---
+
+std::string FusedReduceTask::getShaderPath() {
+    return "shaders/fused_reduce.spv";
+}
+
+void FusedReduceTask::createDescriptorSetLayout() {
+    // 0 = a, 1 = b, 2 = partials in, 3 = partials out, 4 = mapped values
+    std::vector<VkDescriptorSetLayoutBinding> bindings(5);
+    for (uint32_t i = 0; i < bindings.size(); i++) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+    if (vkCreateDescriptorSetLayout(m_context->getDevice(), &layoutInfo, nullptr, &m_descriptorSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create descriptor set layout!");
+    }
+}
+
+void FusedReduceTask::createBuffers() {
+    if (m_input == FusedInput::HOST) {
+        // Rewritten before every dispatch, so the GPU reads it where the host wrote it
+        m_hostInput.create(m_context, sizeof(float) * (VkDeviceSize)m_n, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                           MemoryUsage::STREAMING);
+        m_bufferA = m_hostInput.getBuffer();
+    } else {
+        // Inputs never change after init, so they live in GPU memory (filled via the upload ring)
+        createStagingBuffer(m_bufferA, m_memoryA, sizeof(float) * m_n, m_a.data());
+    }
+    if (m_op == FusedOp::DOT) {
+        createStagingBuffer(m_bufferB, m_memoryB, sizeof(float) * m_n, m_b.data());
+    }
+
+    // Pass 1 leaves one partial per workgroup; the tree passes only shrink that
+    VkDeviceSize partialsSize = PARTIAL_SIZE * ((m_n + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE);
+    createBuffer(m_partialsP, m_partialsPMemory, partialsSize,
+                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, MemoryUsage::GPU_ONLY);
+    createBuffer(m_partialsQ, m_partialsQMemory, partialsSize,
+                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, MemoryUsage::GPU_ONLY);
+
+    if (!m_fused) {
+        // The intermediate the fused kernel does away with
+        createBuffer(m_mappedBuffer, m_mappedMemory, sizeof(float) * m_n,
+                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryUsage::GPU_ONLY);
+    }
+
+    m_resultBuffer.create(m_context, PARTIAL_SIZE, VK_BUFFER_USAGE_TRANSFER_DST_BIT, MemoryUsage::READBACK);
+}
+
+void FusedReduceTask::createDescriptorPool() {
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = 15;
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    poolInfo.maxSets = 3;
+    if (vkCreateDescriptorPool(m_context->getDevice(), &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create descriptor pool!");
+    }
+}
+
+void FusedReduceTask::createDescriptorSet() {
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_descriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &m_descriptorSetLayout;
+    if (vkAllocateDescriptorSets(m_context->getDevice(), &allocInfo, &m_descriptorSet) != VK_SUCCESS ||
+        vkAllocateDescriptorSets(m_context->getDevice(), &allocInfo, &m_setQtoP) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate descriptor set!");
+    }
+    writeDescriptorSet(m_descriptorSet, m_bufferA, m_partialsP, m_partialsQ);
+    writeDescriptorSet(m_setQtoP, m_bufferA, m_partialsQ, m_partialsP);
+
+    if (!m_fused) {
+        if (vkAllocateDescriptorSets(m_context->getDevice(), &allocInfo, &m_setMapped) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to allocate descriptor set!");
+        }
+        writeDescriptorSet(m_setMapped, m_mappedBuffer, m_partialsP, m_partialsQ);
+    }
+}
+
+void FusedReduceTask::writeDescriptorSet(VkDescriptorSet set, VkBuffer a, VkBuffer partialsIn, VkBuffer partialsOut) {
+    // Unused bindings still need a buffer: B falls back to A, the mapped output to P
+    VkBuffer b = (m_bufferB != VK_NULL_HANDLE) ? m_bufferB : m_bufferA;
+    VkBuffer mapped = (m_mappedBuffer != VK_NULL_HANDLE) ? m_mappedBuffer : m_partialsP;
+    VkBuffer buffers[5] = {a, b, partialsIn, partialsOut, mapped};
+
+    VkDescriptorBufferInfo bufferInfos[5]{};
+    std::vector<VkWriteDescriptorSet> writes(5);
+    for (uint32_t i = 0; i < 5; i++) {
+        bufferInfos[i].buffer = buffers[i];
+        bufferInfos[i].offset = 0;
+        bufferInfos[i].range = VK_WHOLE_SIZE;
+
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = set;
+        writes[i].dstBinding = i;
+        writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[i].descriptorCount = 1;
+        writes[i].pBufferInfo = &bufferInfos[i];
+    }
+    vkUpdateDescriptorSets(m_context->getDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+}
+
+void FusedReduceTask::setElementCount(uint32_t count) {
+    if (m_input != FusedInput::HOST) {
+        throw std::runtime_error("FusedReduceTask element count needs host input!");
+    }
+    if (count == 0 || count > m_n) {
+        throw std::runtime_error("FusedReduceTask element count out of range!");
+    }
+    m_count = count;
+}
+
+void FusedReduceTask::setExternalInput(VkBuffer buffer) {
+    if (m_input != FusedInput::HOST) {
+        throw std::runtime_error("FusedReduceTask external input needs host input!");
+    }
+    VkBuffer input = (buffer != VK_NULL_HANDLE) ? buffer : m_hostInput.getBuffer();
+    if (input == m_bufferA) return;
+    m_bufferA = input;
+    writeDescriptorSet(m_descriptorSet, m_bufferA, m_partialsP, m_partialsQ);
+    writeDescriptorSet(m_setQtoP, m_bufferA, m_partialsQ, m_partialsP);
+    if (m_setMapped != VK_NULL_HANDLE) {
+        writeDescriptorSet(m_setMapped, m_mappedBuffer, m_partialsP, m_partialsQ);
+    }
+}
+
+// --- Dispatch ---
+
+long long FusedReduceTask::dispatch() {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    double submitUs = GpuProfiler::nowUs();
+    if (m_fused) {
+        VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+        record(commandBuffer);
+        endSingleTimeCommands(commandBuffer);
+    } else {
+        // Two tasks with a host sync in between, as the unfused pipeline runs today
+        // (one region over both submissions, so the host sync in between is part of it)
+        VkCommandBuffer mapCommands = beginSingleTimeCommands();
+        m_profiler.reset(mapCommands);
+        uint32_t region = m_profiler.beginRegion(mapCommands, "reduce");
+        m_graph.clear();
+        addMapPass();
+        m_graph.record(mapCommands);
+        endSingleTimeCommands(mapCommands);
+
+        VkCommandBuffer reduceCommands = beginSingleTimeCommands();
+        // The mapped values were written by the previous submission
+        addBufferBarrier(reduceCommands, m_mappedBuffer, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+        m_graph.clear();
+        addReducePasses(m_setMapped, m_mappedBuffer);
+        m_graph.record(reduceCommands);
+        m_profiler.endRegion(reduceCommands, region);
+        endSingleTimeCommands(reduceCommands);
+    }
+    m_hostSubmitUs = submitUs;
+    m_hostCompleteUs = GpuProfiler::nowUs();
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+
+    return duration.count(); // Return the CPU-side time
+}
+
+void FusedReduceTask::record(VkCommandBuffer commandBuffer) {
+    m_hostSubmitUs = -1.0; // Whoever submits this may not be dispatch()
+    m_hostCompleteUs = -1.0;
+    m_profiler.reset(commandBuffer);
+    uint32_t region = m_profiler.beginRegion(commandBuffer, "reduce");
+
+    m_graph.clear();
+    if (m_fused) {
+        addReducePasses(m_descriptorSet, m_bufferA);
+    } else {
+        // Batched: both steps in one command buffer, only the graph's barrier between them
+        addMapPass();
+        addReducePasses(m_setMapped, m_mappedBuffer);
+    }
+    m_graph.record(commandBuffer);
+
+    m_profiler.endRegion(commandBuffer, region);
+}
+
+void FusedReduceTask::addMapPass() {
+    FusedPushData pushData{};
+    pushData.passType = 2;
+    pushData.op = shaderOp();
+    pushData.numElements = m_count;
+    std::vector<GraphBufferAccess> accesses = {{m_bufferA, GraphAccess::READ}, {m_mappedBuffer, GraphAccess::WRITE}};
+    if (m_bufferB != VK_NULL_HANDLE) accesses.push_back({m_bufferB, GraphAccess::READ});
+    m_graph.addDispatch("map", m_pipeline, m_pipelineLayout, m_descriptorSet, &pushData, sizeof(FusedPushData),
+                        (m_count + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, accesses);
+}
+
+void FusedReduceTask::addReducePasses(VkDescriptorSet firstSet, VkBuffer input) {
+    // --- 1. Pass 1: map + local reduce (N -> ceil(N / 256) partials), input -> Q ---
+    // Over the mapped values the op is a plain sum (Welford stays Welford)
+    bool mapped = (input == m_mappedBuffer);
+    FusedPushData pushData{};
+    pushData.passType = 0;
+    pushData.op = (mapped && m_op != FusedOp::MEAN_VARIANCE) ? 0 : shaderOp();
+    pushData.numElements = m_count;
+    uint32_t remaining = (m_count + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+    std::vector<GraphBufferAccess> accesses = {{input, GraphAccess::READ}, {m_partialsQ, GraphAccess::WRITE}};
+    if (!mapped && m_bufferB != VK_NULL_HANDLE) accesses.push_back({m_bufferB, GraphAccess::READ});
+    m_graph.addDispatch("map-reduce", m_pipeline, m_pipelineLayout, firstSet, &pushData, sizeof(FusedPushData),
+                        remaining, accesses);
+
+    // --- 2. Tree passes over the partials until one is left ---
+    bool resultInQ = true;
+    pushData.passType = 1;
+    while (remaining > 1) {
+        pushData.numElements = remaining;
+        remaining = (remaining + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+        VkBuffer in = resultInQ ? m_partialsQ : m_partialsP;
+        VkBuffer out = resultInQ ? m_partialsP : m_partialsQ;
+        m_graph.addDispatch("tree", m_pipeline, m_pipelineLayout, resultInQ ? m_setQtoP : m_descriptorSet,
+                            &pushData, sizeof(FusedPushData), remaining,
+                            {{in, GraphAccess::READ}, {out, GraphAccess::WRITE}});
+        resultInQ = !resultInQ;
+    }
+
+    // --- 3. Read Back Result: the last partial, 16 bytes ---
+    m_graph.addCopy("result-copy", resultInQ ? m_partialsQ : m_partialsP, m_resultBuffer.getBuffer(), PARTIAL_SIZE);
+    m_graph.addHostRead(m_resultBuffer.getBuffer());
+}
+
+TaskResult FusedReduceTask::readResult() {
+    TaskResult result;
+
+    // Non-coherent (e.g. HOST_CACHED) memory must be invalidated before the CPU reads it
+    m_resultBuffer.invalidate();
+    const float* partial = m_resultBuffer.data<float>();
+
+    if (m_input == FusedInput::HOST) {
+        // No reference: the caller's data is only known to the caller
+        result.value = (m_op == FusedOp::MEAN_VARIANCE) ? partial[1]
+                     : (m_op == FusedOp::L2_NORM) ? std::sqrt(std::max(0.0f, partial[0])) : partial[0];
+        m_variance = (m_op == FusedOp::MEAN_VARIANCE && partial[0] > 0.0f) ? (double)partial[2] / partial[0] : 0.0;
+        result.valid = std::isfinite(result.value) &&
+                       (m_op != FusedOp::MEAN_VARIANCE || partial[0] == (float)m_count);
+    } else if (m_op == FusedOp::MEAN_VARIANCE) {
+        result.value = partial[1];
+        m_variance = partial[0] > 0.0f ? (double)partial[2] / partial[0] : 0.0;
+        result.valid = partial[0] == (float)m_n &&
+                       std::fabs(result.value - m_expected) <= m_tolerance &&
+                       std::fabs(m_variance - m_expectedVariance) <= 1e-3 * std::max(1.0, m_expectedVariance);
+    } else if (m_op == FusedOp::L2_NORM) {
+        // Checked on the sum of squares, where the tolerance was computed
+        result.value = std::sqrt(std::max(0.0f, partial[0]));
+        result.valid = std::fabs((double)partial[0] - m_expected) <= m_tolerance;
+    } else {
+        result.value = partial[0];
+        result.valid = std::fabs(result.value - m_expected) <= m_tolerance;
+    }
+
+    // <0 unless every reading passed the profiler's checks (valid bits, availability, order, CPU bracket)
+    result.gpuTimeUs = m_profiler.resolve(m_hostSubmitUs, m_hostCompleteUs).durationUs("reduce");
+    return result;
+}
+
+uint64_t FusedReduceTask::getBytesMoved() const {
+    // Inputs are read once either way
+    uint64_t bytes = (uint64_t)sizeof(float) * m_count * inputCount();
+
+    // Partials: written by each pass, read by the next, plus the 16-byte readback copy
+    uint32_t remaining = (m_count + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+    bytes += PARTIAL_SIZE * remaining;
+    while (remaining > 1) {
+        bytes += PARTIAL_SIZE * remaining;
+        remaining = (remaining + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+        bytes += PARTIAL_SIZE * remaining;
+    }
+    bytes += PARTIAL_SIZE;
+
+    if (!m_fused) {
+        // The mapped values are written by the first task and read back by the second
+        bytes += 2ull * sizeof(float) * m_count;
+    }
+    return bytes;
+}
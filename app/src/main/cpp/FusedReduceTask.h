@@ -0,0 +1,144 @@
+#pragma once
+
+#include "BaseComputeTask.h"
+#include "MappedBuffer.h"
+#include "ComputeGraph.h"
+#include <vector>
+
+// This struct MUST match the layout in fused_reduce.comp
+struct FusedPushData {
+    uint32_t passType;    // 0 = map + local, 1 = tree, 2 = map only
+    uint32_t op;          // Shader op code (see shaderOp())
+    uint32_t numElements;
+};
+
+// The map-reduce a FusedReduceTask computes
+enum class FusedOp {
+    SUM,            // sum(a)
+    DOT,            // sum(a * b)
+    SUM_OF_SQUARES, // sum(a * a)
+    L1_NORM,        // sum(|a|)
+    L2_NORM,        // sqrt(sum(a * a))
+    MEAN_VARIANCE   // Welford: mean and population variance of a
+};
+
+// Where a FusedReduceTask's input comes from
+enum class FusedInput {
+    GENERATED, // A fixed test pattern, checked against a CPU reference
+    HOST       // Written by the caller through getHostInput() before each dispatch
+};
+
+// One-pass map-reduce over one or two input buffers.
+//
+// The elementwise step happens while loading, inside the first pass of the
+// reduce_optimized.comp structure, so the mapped values never touch memory.
+// setFused(false) runs the same op as the two-task pipeline it replaces
+// (map into an N-float buffer, host sync, reduce that buffer) for comparison.
+//
+// With FusedInput::HOST, N is a capacity: A is a persistently mapped buffer the
+// GPU reads in place, setElementCount() picks how much of it each dispatch
+// reduces, and setExternalInput() can bind another buffer (e.g. an imported
+// HostBuffer) instead. Single-input ops only; readResult() has no reference
+// to check against and only rejects non-finite results.
+//
+// Counts are carried as floats in the Welford partials: N must stay below 2^24.
+class FusedReduceTask : public BaseComputeTask {
+public:
+    FusedReduceTask(AAssetManager* assetManager, FusedOp op, uint32_t n, FusedInput input = FusedInput::GENERATED);
+    ~FusedReduceTask();
+
+    // --- ComputeTask Interface ---
+    void init() override;
+    long long dispatch() override;
+    void cleanup() override;
+
+    // --- Batching ---
+    bool isRecordable() override { return true; }
+    void record(VkCommandBuffer commandBuffer) override;
+    // value = the op's result (the mean for MEAN_VARIANCE)
+    TaskResult readResult() override;
+
+    // Call before init()
+    void setFused(bool fused) { m_fused = fused; }
+    bool isFused() const { return m_fused; }
+
+    // --- Host input (FusedInput::HOST only) ---
+    float* getHostInput() const { return m_hostInput.data<float>(); }
+    // Makes host writes to the first 'count' floats visible (no-op on coherent memory)
+    void flushHostInput(uint32_t count) const { m_hostInput.flush(0, sizeof(float) * (VkDeviceSize)count); }
+    // Elements the next dispatch reduces, 0 < count <= capacity
+    void setElementCount(uint32_t count);
+    uint32_t getElementCount() const { return m_count; }
+    uint32_t getCapacity() const { return m_n; }
+    // Binds 'buffer' (at least getElementCount() floats, STORAGE usage) as the
+    // input instead of the mapped one; VK_NULL_HANDLE rebinds the mapped one.
+    // Only between dispatches: the descriptor sets are rewritten in place.
+    void setExternalInput(VkBuffer buffer);
+
+    FusedOp getOp() const { return m_op; }
+    static const char* getOpName(FusedOp op);
+    // Population variance of the last readResult() (MEAN_VARIANCE only)
+    double getVariance() const { return m_variance; }
+    // Estimated global memory traffic of one dispatch in the current mode
+    uint64_t getBytesMoved() const;
+
+protected:
+    // --- BaseComputeTask "Fill-in-the-blanks" ---
+    std::string getShaderPath() override;
+    void createDescriptorSetLayout() override;
+    void createBuffers() override;
+    void createDescriptorPool() override;
+    void createDescriptorSet() override;
+
+private:
+    uint32_t shaderOp() const;
+    uint32_t inputCount() const { return m_op == FusedOp::DOT ? 2 : 1; }
+    void computeReference();
+    void writeDescriptorSet(VkDescriptorSet set, VkBuffer a, VkBuffer partialsIn, VkBuffer partialsOut);
+
+    // Graph builders: the map-only pass, and the reduction of 'input' down to one partial
+    void addMapPass();
+    void addReducePasses(VkDescriptorSet firstSet, VkBuffer input);
+
+    FusedOp m_op;
+    uint32_t m_n;     // Capacity
+    uint32_t m_count; // Elements per dispatch (== m_n unless HOST input)
+    FusedInput m_input;
+    bool m_fused = true;
+
+    // --- Inputs and CPU reference ---
+    std::vector<float> m_a;
+    std::vector<float> m_b;      // DOT only
+    double m_expected = 0.0;
+    double m_expectedVariance = 0.0;
+    double m_tolerance = 0.0;
+    double m_variance = 0.0;
+
+    // --- Buffers ---
+    VkBuffer m_bufferA = VK_NULL_HANDLE;         // The bound input (HOST: m_hostInput or an external buffer)
+    VkDeviceMemory m_memoryA = VK_NULL_HANDLE;
+    MappedBuffer m_hostInput;                    // HOST only
+    VkBuffer m_bufferB = VK_NULL_HANDLE;         // DOT only; otherwise A is bound twice
+    VkDeviceMemory m_memoryB = VK_NULL_HANDLE;
+    VkBuffer m_partialsP = VK_NULL_HANDLE;       // vec4 ping-pong partials
+    VkDeviceMemory m_partialsPMemory = VK_NULL_HANDLE;
+    VkBuffer m_partialsQ = VK_NULL_HANDLE;
+    VkDeviceMemory m_partialsQMemory = VK_NULL_HANDLE;
+    VkBuffer m_mappedBuffer = VK_NULL_HANDLE;    // Unfused only: N mapped floats
+    VkDeviceMemory m_mappedMemory = VK_NULL_HANDLE;
+    MappedBuffer m_resultBuffer;                 // The final vec4 partial
+
+    // m_descriptorSet: (A, B) -> Q and P -> Q; m_setQtoP: Q -> P;
+    // m_setMapped: mapped values -> Q (unfused only)
+    VkDescriptorSet m_setQtoP = VK_NULL_HANDLE;
+    VkDescriptorSet m_setMapped = VK_NULL_HANDLE;
+    ComputeGraph m_graph;
+
+    // "reduce" region, checked against dispatch()'s CPU-side bracket
+    GpuProfiler m_profiler;
+    double m_hostSubmitUs = -1.0;
+    double m_hostCompleteUs = -1.0;
+
+    static const uint32_t WORKGROUP_SIZE = 256;
+    static const VkDeviceSize PARTIAL_SIZE = sizeof(float) * 4;
+};
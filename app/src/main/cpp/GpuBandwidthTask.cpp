@@ -0,0 +1,251 @@
+#include "GpuBandwidthTask.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+GpuBandwidthTask::GpuBandwidthTask(AAssetManager* assetManager, uint64_t maxWorkingSetBytes)
+        : BaseComputeTask(assetManager), m_capacity(maxWorkingSetBytes) {
+    if (m_capacity < MIN_WORKING_SET_BYTES || (m_capacity & (m_capacity - 1)) != 0 ||
+        m_capacity / 16 > UINT32_MAX) {
+        throw std::runtime_error("GpuBandwidthTask needs a power-of-two capacity of at least 1 KiB!");
+    }
+    LOGI("GpuBandwidthTask created. Capacity=%llu bytes", (unsigned long long)m_capacity);
+}
+
+GpuBandwidthTask::~GpuBandwidthTask() {
+    LOGI("GpuBandwidthTask destroyed");
+}
+
+// --- Overridden init() ---
+void GpuBandwidthTask::init() {
+    LOGI("GpuBandwidthTask::init() starting...");
+
+    createBuffers();
+    createDescriptorSetLayout();
+    createDescriptorPool();
+    createDescriptorSet();
+
+    // One pipeline per kernel, the kernel being a specialization constant
+    createPipelineLayout(sizeof(BandwidthPushData));
+    VkSpecializationMapEntry entry{};
+    entry.constantID = 0;
+    entry.offset = 0;
+    entry.size = sizeof(uint32_t);
+    for (uint32_t kernel = 0; kernel < KERNEL_COUNT; kernel++) {
+        VkSpecializationInfo specializationInfo{};
+        specializationInfo.mapEntryCount = 1;
+        specializationInfo.pMapEntries = &entry;
+        specializationInfo.dataSize = sizeof(uint32_t);
+        specializationInfo.pData = &kernel;
+        m_pipelines[kernel] = createComputePipeline(getShaderPath(), &specializationInfo);
+    }
+
+    m_profiler.init(m_context, 1);
+    configure(m_kernel, m_workingSetBytes);
+
+    LOGI("GpuBandwidthTask::init() finished.");
+}
+
+void GpuBandwidthTask::cleanup() {
+    LOGI("GpuBandwidthTask::cleanup()");
+    VkDevice device = m_context->getDevice();
+    m_profiler.cleanup();
+    for (VkPipeline& pipeline : m_pipelines) {
+        if (pipeline != VK_NULL_HANDLE) vkDestroyPipeline(device, pipeline, nullptr);
+        pipeline = VK_NULL_HANDLE;
+    }
+
+    VkBuffer buffers[] = {m_srcBuffer, m_dstBuffer};
+    VkDeviceMemory memories[] = {m_srcMemory, m_dstMemory};
+    for (VkBuffer buffer : buffers) {
+        if (buffer != VK_NULL_HANDLE) vkDestroyBuffer(device, buffer, nullptr);
+    }
+    for (VkDeviceMemory memory : memories) {
+        if (memory != VK_NULL_HANDLE) vkFreeMemory(device, memory, nullptr);
+    }
+    m_srcBuffer = m_dstBuffer = VK_NULL_HANDLE;
+    m_srcMemory = m_dstMemory = VK_NULL_HANDLE;
+    m_srcFilled = false;
+
+    BaseComputeTask::cleanup();
+}
+
+// --- "Fill-in-the-blank" Implementations ---
+
+std::string GpuBandwidthTask::getShaderPath() {
+    return "shaders/bandwidth.spv";
+}
+
+void GpuBandwidthTask::createDescriptorSetLayout() {
+    // 0 = src, 1 = dst
+    std::vector<VkDescriptorSetLayoutBinding> bindings(2);
+    for (uint32_t i = 0; i < bindings.size(); i++) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+    if (vkCreateDescriptorSetLayout(m_context->getDevice(), &layoutInfo, nullptr, &m_descriptorSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create descriptor set layout!");
+    }
+}
+
+void GpuBandwidthTask::createBuffers() {
+    // Src is filled on the GPU (vkCmdFillBuffer) before the first run
+    createBuffer(m_srcBuffer, m_srcMemory, m_capacity,
+                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, MemoryUsage::GPU_ONLY);
+    createBuffer(m_dstBuffer, m_dstMemory, m_capacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryUsage::GPU_ONLY);
+}
+
+void GpuBandwidthTask::createDescriptorPool() {
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = 2;
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    poolInfo.maxSets = 1;
+    if (vkCreateDescriptorPool(m_context->getDevice(), &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create descriptor pool!");
+    }
+}
+
+void GpuBandwidthTask::createDescriptorSet() {
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_descriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &m_descriptorSetLayout;
+    if (vkAllocateDescriptorSets(m_context->getDevice(), &allocInfo, &m_descriptorSet) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate descriptor set!");
+    }
+
+    VkBuffer buffers[2] = {m_srcBuffer, m_dstBuffer};
+    VkDescriptorBufferInfo bufferInfos[2]{};
+    std::vector<VkWriteDescriptorSet> writes(2);
+    for (uint32_t i = 0; i < 2; i++) {
+        bufferInfos[i].buffer = buffers[i];
+        bufferInfos[i].offset = 0;
+        bufferInfos[i].range = VK_WHOLE_SIZE;
+
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = m_descriptorSet;
+        writes[i].dstBinding = i;
+        writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[i].descriptorCount = 1;
+        writes[i].pBufferInfo = &bufferInfos[i];
+    }
+    vkUpdateDescriptorSets(m_context->getDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+}
+
+// --- Measuring ---
+
+void GpuBandwidthTask::configure(BandwidthKernel kernel, uint64_t workingSetBytes) {
+    if (workingSetBytes < MIN_WORKING_SET_BYTES || workingSetBytes > m_capacity ||
+        (workingSetBytes & (workingSetBytes - 1)) != 0) {
+        throw std::runtime_error("GpuBandwidthTask: the working set must be a power of two within the capacity!");
+    }
+    m_kernel = kernel;
+    m_workingSetBytes = workingSetBytes;
+    // Whole sweeps of the working set, at least MIN_BYTES_PER_RUN of them
+    uint64_t sweeps = std::max<uint64_t>(1, MIN_BYTES_PER_RUN / workingSetBytes);
+    m_total = static_cast<uint32_t>(sweeps * (workingSetBytes / 16));
+    m_recorded = false;
+}
+
+uint64_t GpuBandwidthTask::getBytesMoved() const {
+    return (uint64_t)m_total * getBandwidthBytesPerElement(m_kernel);
+}
+
+BandwidthSample GpuBandwidthTask::measure(BandwidthKernel kernel, uint64_t workingSetBytes, uint32_t iterations) {
+    configure(kernel, workingSetBytes);
+    dispatch(); // Warm-up (and the first run also fills src)
+    readResult();
+
+    double bestGpuUs = -1.0;
+    long long bestHostUs = -1;
+    bool allTrusted = true;
+    for (uint32_t i = 0; i < iterations; i++) {
+        long long hostUs = dispatch();
+        TaskResult result = readResult();
+        if (bestHostUs < 0 || hostUs < bestHostUs) bestHostUs = hostUs;
+        if (result.gpuTimeUs <= 0.0) {
+            allTrusted = false;
+        } else if (bestGpuUs < 0.0 || result.gpuTimeUs < bestGpuUs) {
+            bestGpuUs = result.gpuTimeUs;
+        }
+    }
+
+    BandwidthSample sample;
+    sample.processor = "gpu";
+    sample.kernel = kernel;
+    sample.workingSetBytes = workingSetBytes;
+    sample.bytesMoved = getBytesMoved();
+    sample.gpuTimed = allTrusted && bestGpuUs > 0.0;
+    sample.us = sample.gpuTimed ? bestGpuUs : (double)bestHostUs;
+    return sample;
+}
+
+// --- Dispatch ---
+
+long long GpuBandwidthTask::dispatch() {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    double submitUs = GpuProfiler::nowUs();
+    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+    record(commandBuffer);
+    endSingleTimeCommands(commandBuffer);
+    m_hostSubmitUs = submitUs;
+    m_hostCompleteUs = GpuProfiler::nowUs();
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+
+    return duration.count(); // Return the CPU-side time
+}
+
+void GpuBandwidthTask::record(VkCommandBuffer commandBuffer) {
+    m_hostSubmitUs = -1.0; // Whoever submits this may not be dispatch()
+    m_hostCompleteUs = -1.0;
+    m_profiler.reset(commandBuffer);
+
+    // 1.0f everywhere, once, before the profiled pass (the first dispatch's CPU-side time includes it)
+    if (!m_srcFilled) {
+        vkCmdFillBuffer(commandBuffer, m_srcBuffer, 0, VK_WHOLE_SIZE, 0x3f800000u);
+        addBufferBarrier(commandBuffer, m_srcBuffer, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+        m_srcFilled = true;
+    }
+
+    BandwidthPushData pushData{};
+    pushData.mask = static_cast<uint32_t>(m_workingSetBytes / 16 - 1);
+    pushData.total = m_total;
+    pushData.value = 2.0f;
+    uint32_t groups = std::min((m_total + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, MAX_GROUPS);
+
+    {
+        GpuProfiler::Scope scope(&m_profiler, commandBuffer, "kernel");
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelines[static_cast<uint32_t>(m_kernel)]);
+        vkCmdPushConstants(commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                           sizeof(BandwidthPushData), &pushData);
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout, 0, 1,
+                                &m_descriptorSet, 0, nullptr);
+        vkCmdDispatch(commandBuffer, groups, 1, 1);
+    }
+    m_recorded = true;
+}
+
+TaskResult GpuBandwidthTask::readResult() {
+    TaskResult result;
+    if (!m_recorded) {
+        result.valid = false;
+        return result;
+    }
+    result.value = (double)getBytesMoved();
+    result.gpuTimeUs = m_profiler.resolve(m_hostSubmitUs, m_hostCompleteUs).durationUs("kernel");
+    return result;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "BaseComputeTask.h"
+#include "GpuProfiler.h"
+#include "Roofline.h"
+
+// This struct MUST match the layout in bandwidth.comp
+struct BandwidthPushData {
+    uint32_t mask;  // Working set in vec4s, minus one
+    uint32_t total; // vec4s visited per run
+    float value;    // What WRITE fills with
+};
+
+// GPU memory bandwidth microbenchmarks: copy, read, write and strided/random
+// reads over a power-of-two working set (see Roofline.h).
+//
+// Every run visits at least MIN_BYTES_PER_RUN, sweeping the working set as many
+// times as that takes, so a cache-resident working set still keeps the whole
+// GPU busy for long enough to time. There is one pipeline per kernel (a
+// specialization constant) so the shader carries no per-element branch.
+// Buffers are device-only and sized once for the largest working set.
+class GpuBandwidthTask : public BaseComputeTask {
+public:
+    static const uint64_t MIN_WORKING_SET_BYTES = 1024;
+    static const uint64_t MIN_BYTES_PER_RUN = 64ull * 1024 * 1024;
+
+    GpuBandwidthTask(AAssetManager* assetManager, uint64_t maxWorkingSetBytes);
+    ~GpuBandwidthTask();
+
+    // --- ComputeTask Interface ---
+    void init() override;
+    long long dispatch() override;
+    void cleanup() override;
+
+    // --- Batching ---
+    bool isRecordable() override { return true; }
+    void record(VkCommandBuffer commandBuffer) override;
+    // value = bytes moved; gpuTimeUs = the kernel alone (<0 if the timestamps are not trustworthy)
+    TaskResult readResult() override;
+
+    // --- Measuring ---
+    // Kernel and working set (a power of two, MIN_WORKING_SET_BYTES up to the capacity) of the next runs
+    void configure(BandwidthKernel kernel, uint64_t workingSetBytes);
+    uint64_t getBytesMoved() const;
+    // configure(), a warm-up, then the best of 'iterations' runs: GPU time when every reading was
+    // trustworthy, else the CPU-side time (which then includes the submission)
+    BandwidthSample measure(BandwidthKernel kernel, uint64_t workingSetBytes, uint32_t iterations);
+
+protected:
+    // --- BaseComputeTask "Fill-in-the-blanks" ---
+    std::string getShaderPath() override;
+    void createDescriptorSetLayout() override;
+    void createBuffers() override;
+    void createDescriptorPool() override;
+    void createDescriptorSet() override;
+
+private:
+    uint64_t m_capacity; // Bytes per buffer
+    BandwidthKernel m_kernel = BandwidthKernel::READ;
+    uint64_t m_workingSetBytes = MIN_WORKING_SET_BYTES;
+    uint32_t m_total = 0;
+
+    VkBuffer m_srcBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory m_srcMemory = VK_NULL_HANDLE;
+    VkBuffer m_dstBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory m_dstMemory = VK_NULL_HANDLE;
+    bool m_srcFilled = false;
+
+    static const uint32_t KERNEL_COUNT = 5;
+    VkPipeline m_pipelines[KERNEL_COUNT] = {};
+
+    // "kernel" region, checked against dispatch()'s CPU-side bracket
+    GpuProfiler m_profiler;
+    double m_hostSubmitUs = -1.0;
+    double m_hostCompleteUs = -1.0;
+    bool m_recorded = false;
+
+    static const uint32_t WORKGROUP_SIZE = 256;
+    static constexpr uint32_t MAX_GROUPS = 1024; // Enough to fill a mobile GPU; the loop covers the rest
+};
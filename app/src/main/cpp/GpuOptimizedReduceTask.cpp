@@ -1,14 +1,21 @@
 #include "GpuOptimizedReduceTask.h"
+#include "Trace.h"
 #include <vector>
 #include <stdexcept>
 #include <numeric>
 #include <cmath>
+#include <chrono>
+#include <algorithm>
 
 GpuOptimizedReduceTask::GpuOptimizedReduceTask(AAssetManager* assetManager, uint32_t n)
-        : BaseComputeTask(assetManager), m_n(n) {
+        : BaseComputeTask(assetManager), m_n(n), m_capacity(n) {
+    if (m_n == 0) {
+        throw std::runtime_error("GpuOptimizedReduceTask needs N > 0!");
+    }
+    if (m_n > getMaxElementCount()) {
+        throw std::runtime_error("GpuOptimizedReduceTask: N needs more workgroups than maxComputeWorkGroupCount[0]!");
+    }
     LOGI("GpuOptimizedReduceTask created. N=%u", m_n);
-    // Get the timestamp period from the context
-    m_gpuTimestampPeriod = m_context->getTimeStampPeriod();
 }
 
 GpuOptimizedReduceTask::~GpuOptimizedReduceTask() {
@@ -19,27 +26,30 @@ void GpuOptimizedReduceTask::cleanup() {
     LOGI("GpuOptimizedReduceTask::cleanup()");
     cleanupBuffers();
 
-    // --- NEW: Clean up the query pool ---
-    if (m_queryPool != VK_NULL_HANDLE) {
-        vkDestroyQueryPool(m_context->getDevice(), m_queryPool, nullptr);
-    }
-    // ---
+    m_profiler.cleanup();
+    m_statistics.cleanup();
 
     if (m_descriptorPool != VK_NULL_HANDLE) {
-        vkFreeDescriptorSets(m_context->getDevice(), m_descriptorPool, 1, &m_descriptorSetA_to_B);
-        vkFreeDescriptorSets(m_context->getDevice(), m_descriptorPool, 1, &m_descriptorSetB_to_A);
+        VkDescriptorSet sets[] = {m_descriptorSetA_to_B, m_descriptorSetB_to_S, m_descriptorSetS_to_B};
+        vkFreeDescriptorSets(m_context->getDevice(), m_descriptorPool, 3, sets);
     }
 
     BaseComputeTask::cleanup();
 }
 
 void GpuOptimizedReduceTask::cleanupBuffers() {
-    // ... (this function is unchanged)
+    m_generator.cleanup();
+    destroyBuffers();
+}
+
+void GpuOptimizedReduceTask::destroyBuffers() {
     VkDevice device = m_context->getDevice();
     if (m_bufferA != VK_NULL_HANDLE) vkDestroyBuffer(device, m_bufferA, nullptr);
-    if (m_bufferB != VK_NULL_HANDLE) vkDestroyBuffer(device, m_bufferB, nullptr);
-    if (m_bufferMemoryA != VK_NULL_HANDLE) vkFreeMemory(device, m_bufferMemoryA, nullptr);
-    if (m_bufferMemoryB != VK_NULL_HANDLE) vkFreeMemory(device, m_bufferMemoryB, nullptr);
+    if (m_memoryA != VK_NULL_HANDLE) vkFreeMemory(device, m_memoryA, nullptr);
+    m_bufferA = VK_NULL_HANDLE;
+    m_memoryA = VK_NULL_HANDLE;
+    m_bufferB.destroy();
+    m_context->getScratchPool()->release(m_scratch);
 }
 
 // --- Overridden init() ---
@@ -91,23 +101,69 @@ void GpuOptimizedReduceTask::init() {
 
     vkDestroyShaderModule(m_context->getDevice(), shaderModule, nullptr);
 
-    // --- 5. NEW: Create the Query Pool ---
-    if (m_gpuTimestampPeriod > 0) { // Only if timestamps are supported
-        VkQueryPoolCreateInfo queryPoolInfo{};
-        queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
-        queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
-        queryPoolInfo.queryCount = 2; // One for start, one for end
-
-        if (vkCreateQueryPool(m_context->getDevice(), &queryPoolInfo, nullptr, &m_queryPool) != VK_SUCCESS) {
-            throw std::runtime_error("Failed to create query pool!");
-        }
-        LOGI("Query pool created for profiling.");
-    }
-    // ---
+    // --- 5. Profiler (disabled if the compute queue has no timestamps) ---
+    m_profiler.init(m_context);
+    m_graph.setProfiler(&m_profiler);
+    m_statistics.init(m_context);
+    m_graph.setStatistics(&m_statistics);
+
+    // --- 6. Input: generated once here, the passes only read it ---
+    m_generator.init(m_context, loadShaderModule(InputGenerator::SHADER_PATH));
+    m_inputTarget = m_generator.addTarget(m_bufferA);
+    generateInput();
+    updateReference();
 
     LOGI("GpuOptimizedReduceTask::init() finished.");
 }
 
+void GpuOptimizedReduceTask::generateInput() {
+    double submitUs = GpuProfiler::nowUs();
+    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+    m_profiler.reset(commandBuffer);
+    {
+        GpuProfiler::Scope scope(&m_profiler, commandBuffer, "generate");
+        m_generator.record(commandBuffer, m_inputTarget, m_capacity, m_distribution);
+    }
+    endSingleTimeCommands(commandBuffer);
+    m_generateUs = m_profiler.resolve(submitUs, GpuProfiler::nowUs()).durationUs("generate");
+    m_recorded = false; // The profiler no longer holds the last run's regions
+}
+
+void GpuOptimizedReduceTask::updateReference() {
+    double absSum = 0.0;
+    InputGenerator::hostReference(m_distribution, m_n, m_expected, absSum);
+    // Float partial sums in a different order: allow a relative error on the magnitudes
+    m_tolerance = std::max(0.01, 1e-4 * absSum);
+}
+
+uint64_t GpuOptimizedReduceTask::getMaxElementCount() {
+    return (uint64_t)VulkanContext::getInstance()->getMaxComputeWorkGroupCountX() * WORKGROUP_SIZE;
+}
+
+void GpuOptimizedReduceTask::resize(uint32_t n) {
+    if (n == 0) {
+        throw std::runtime_error("GpuOptimizedReduceTask needs N > 0!");
+    }
+    if (n > getMaxElementCount()) {
+        throw std::runtime_error("GpuOptimizedReduceTask: N needs more workgroups than maxComputeWorkGroupCount[0]!");
+    }
+    if (n > m_capacity) {
+        // Geometric growth: a slowly rising N re-allocates O(log N) times
+        m_capacity = std::max(n, m_capacity * 2);
+        LOGI("GpuOptimizedReduceTask: growing to %u elements", m_capacity);
+        destroyBuffers();
+        createBuffers();
+        writeDescriptorSets();
+        m_generator.setTarget(m_inputTarget, m_bufferA);
+        generateInput();
+    }
+    if (n != m_n) {
+        m_n = n;
+        updateReference();
+    }
+    m_recorded = false;
+}
+
 
 // --- "Fill-in-the-blank" Implementations ---
 // (These are all unchanged from Phase 4)
@@ -137,88 +193,118 @@ void GpuOptimizedReduceTask::createDescriptorSetLayout() {
 }
 
 long long GpuOptimizedReduceTask::dispatch() {
-    VkDevice device = m_context->getDevice();
+    TRACE_SCOPE("GpuOptimizedReduceTask::dispatch", "task");
     auto startTime = std::chrono::high_resolution_clock::now();
+    double submitUs = GpuProfiler::nowUs();
     VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+    record(commandBuffer);
+    endSingleTimeCommands(commandBuffer);
+    m_hostSubmitUs = submitUs;
+    m_hostCompleteUs = GpuProfiler::nowUs();
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
 
-    // (Query pool, pipeline binds, etc. - unchanged)
-    if (m_queryPool != VK_NULL_HANDLE) {
-        vkCmdResetQueryPool(commandBuffer, m_queryPool, 0, 2);
-    }
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline);
-    if (m_queryPool != VK_NULL_HANDLE) {
-        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_queryPool, 0);
-    }
+    return duration.count(); // Return the CPU-side time
+}
 
+void GpuOptimizedReduceTask::record(VkCommandBuffer commandBuffer) {
+    TRACE_SCOPE("GpuOptimizedReduceTask::record", "task");
+    m_hostSubmitUs = -1.0; // Whoever submits this may not be dispatch()
+    m_hostCompleteUs = -1.0;
+    m_profiler.reset(commandBuffer);
+    m_statistics.reset(commandBuffer);
+
+    // Starts once earlier work in the command buffer has completed, as the reduction cannot overlap it
+    uint32_t reduceRegion = m_profiler.beginRegion(commandBuffer, "reduce", VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+
+    // The passes only declare what they read and write; the graph places the barriers.
+    // A is only read, so it stays valid from one dispatch to the next.
+    VkBuffer bufferA = m_bufferA;
+    VkBuffer bufferB = m_bufferB.getBuffer();
+    VkBuffer scratch = m_scratch.buffer;
+    m_graph.clear();
+
+    // Each pass reads its inputs once, writes one partial per workgroup and does one add per input
+    // (PassStats); the names are unique so each pass gets its own profile region
+    // --- 1. Pass 1: Local Reduce (N -> ceil(N / 256)), A -> B ---
     PushData pushData{};
-
-    // --- 1. Pass 1: Local Reduce (N=1M -> 4096) ---
     pushData.passType = 0;
     pushData.numElements = m_n;
-    vkCmdPushConstants(commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushData), &pushData);
-    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout, 0, 1, &m_descriptorSetA_to_B, 0, nullptr);
-    uint32_t numWorkgroups = m_n / WORKGROUP_SIZE; // 4096
-    vkCmdDispatch(commandBuffer, numWorkgroups, 1, 1);
-
-    // --- 2. Pass 2: Tree Reduce (N=4096 -> 16) ---
-    addBufferBarrier(commandBuffer, m_bufferB,
-                     VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
-                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
-
+    uint32_t remaining = (m_n + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE; // 4096 for N=1M
+    m_graph.addDispatch("pass1-local", m_pipeline, m_pipelineLayout, m_descriptorSetA_to_B, &pushData,
+                        sizeof(PushData), remaining,
+                        {{bufferA, GraphAccess::READ, sizeof(float) * (VkDeviceSize)m_n},
+                         {bufferB, GraphAccess::WRITE, sizeof(float) * (VkDeviceSize)remaining}},
+                        {WORKGROUP_SIZE, m_n});
+
+    // --- 2. Tree passes (each divides by 256, rounding up) until one sum is left, B <-> S ---
+    // The shader zero-pads partial workgroups, so any N works (1M: 4096 -> 16 -> 1)
+    bool resultInB = true;
     pushData.passType = 1; // Use optimized pass
-    pushData.numElements = numWorkgroups; // 4096
-    vkCmdPushConstants(commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushData), &pushData);
-    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout, 0, 1, &m_descriptorSetB_to_A, 0, nullptr);
-
-    numWorkgroups = numWorkgroups / WORKGROUP_SIZE; // 4096 / 256 = 16
-    vkCmdDispatch(commandBuffer, numWorkgroups, 1, 1);
-
-    // --- 3. Pass 3: Final Reduce (N=16 -> 1) ---
-    addBufferBarrier(commandBuffer, m_bufferA,
-                     VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
-                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
-
-    pushData.passType = 1;
-    pushData.numElements = numWorkgroups; // 16
-    vkCmdPushConstants(commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushData), &pushData);
-    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout, 0, 1, &m_descriptorSetA_to_B, 0, nullptr);
-
-    numWorkgroups = 1;
-    vkCmdDispatch(commandBuffer, numWorkgroups, 1, 1);
+    uint32_t pass = 2;
+    while (remaining > 1) {
+        uint32_t inputs = remaining;
+        pushData.numElements = inputs;
+        remaining = (remaining + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+        VkBuffer in = resultInB ? bufferB : scratch;
+        VkBuffer out = resultInB ? scratch : bufferB;
+        m_graph.addDispatch("pass" + std::to_string(pass++) + "-tree", m_pipeline, m_pipelineLayout,
+                            resultInB ? m_descriptorSetB_to_S : m_descriptorSetS_to_B, &pushData, sizeof(PushData),
+                            remaining,
+                            {{in, GraphAccess::READ, sizeof(float) * (VkDeviceSize)inputs},
+                             {out, GraphAccess::WRITE, sizeof(float) * (VkDeviceSize)remaining}},
+                            {WORKGROUP_SIZE, inputs});
+        resultInB = !resultInB;
+    }
 
-    // --- 4. Read Back Result ---
-    VkBuffer finalBuffer = m_bufferB; // Final result is in B
-    VkDeviceMemory finalMemory = m_bufferMemoryB;
+    // --- 3. Read Back Result ---
+    if (!resultInB) {
+        // S lives in device-only memory: move the sum into B[0]
+        m_graph.addCopy("result-copy", scratch, bufferB, sizeof(float), m_scratch.offset, 0);
+    }
+    m_graph.addHostRead(bufferB);
+    m_graph.record(commandBuffer);
+    m_recorded = true;
 
-    addBufferBarrier(commandBuffer, finalBuffer,
-                     VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_HOST_READ_BIT,
-                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_HOST_BIT);
+    m_profiler.endRegion(commandBuffer, reduceRegion);
+}
 
-    if (m_queryPool != VK_NULL_HANDLE) {
-        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_queryPool, 1);
+TaskResult GpuOptimizedReduceTask::readResult() {
+    TaskResult result;
+    if (!m_recorded) {
+        result.valid = false;
+        return result;
     }
 
-    endSingleTimeCommands(commandBuffer);
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+    // Non-coherent (e.g. HOST_CACHED) memory must be invalidated before the CPU reads it
+    m_bufferB.invalidate(0, sizeof(float));
+    result.value = *m_bufferB.data<float>();
+    result.valid = std::fabs(result.value - m_expected) <= m_tolerance;
 
-    // (GPU timestamp query logic... unchanged)
-    // (Verification logic... unchanged)
-    // ...
+    // Implausible readings come back as -1, like missing ones
+    m_lastProfile = m_profiler.resolve(m_hostSubmitUs, m_hostCompleteUs);
+    result.gpuTimeUs = m_lastProfile.durationUs("reduce");
+    m_lastPassStats = m_graph.collectPassStats(&m_lastProfile);
+    return result;
+}
 
-    return duration.count(); // Return the CPU-side time
+VkDeviceSize GpuOptimizedReduceTask::getDeviceMemoryBytes() const {
+    if (m_bufferA == VK_NULL_HANDLE) return 0;
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(m_context->getDevice(), m_bufferA, &memRequirements);
+    return memRequirements.size + m_bufferB.getAllocationSize() + m_scratch.size;
 }
 
 void GpuOptimizedReduceTask::createDescriptorPool() {
     // ... (unchanged)
     VkDescriptorPoolSize poolSize{};
     poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-    poolSize.descriptorCount = 4;
+    poolSize.descriptorCount = 6;
     VkDescriptorPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
     poolInfo.poolSizeCount = 1;
     poolInfo.pPoolSizes = &poolSize;
-    poolInfo.maxSets = 2;
+    poolInfo.maxSets = 3;
     if (vkCreateDescriptorPool(m_context->getDevice(), &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create descriptor pool!");
     }
@@ -234,102 +320,65 @@ void GpuOptimizedReduceTask::createDescriptorSet() {
     if (vkAllocateDescriptorSets(m_context->getDevice(), &allocInfo, &m_descriptorSetA_to_B) != VK_SUCCESS) {
         throw std::runtime_error("Failed to allocate descriptor set A->B!");
     }
-    if (vkAllocateDescriptorSets(m_context->getDevice(), &allocInfo, &m_descriptorSetB_to_A) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to allocate descriptor set B->A!");
+    if (vkAllocateDescriptorSets(m_context->getDevice(), &allocInfo, &m_descriptorSetB_to_S) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate descriptor set B->S!");
     }
-    VkDescriptorBufferInfo bufferInfoA_in{};
-    bufferInfoA_in.buffer = m_bufferA;
-    bufferInfoA_in.offset = 0;
-    bufferInfoA_in.range = VK_WHOLE_SIZE;
-    VkDescriptorBufferInfo bufferInfoB_out{};
-    bufferInfoB_out.buffer = m_bufferB;
-    bufferInfoB_out.offset = 0;
-    bufferInfoB_out.range = VK_WHOLE_SIZE;
-    std::vector<VkWriteDescriptorSet> writesA_B(2);
-    writesA_B[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    writesA_B[0].dstSet = m_descriptorSetA_to_B;
-    writesA_B[0].dstBinding = 0;
-    writesA_B[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-    writesA_B[0].descriptorCount = 1;
-    writesA_B[0].pBufferInfo = &bufferInfoA_in;
-    writesA_B[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    writesA_B[1].dstSet = m_descriptorSetA_to_B;
-    writesA_B[1].dstBinding = 1;
-    writesA_B[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-    writesA_B[1].descriptorCount = 1;
-    writesA_B[1].pBufferInfo = &bufferInfoB_out;
-    vkUpdateDescriptorSets(m_context->getDevice(), 2, writesA_B.data(), 0, nullptr);
-    VkDescriptorBufferInfo bufferInfoB_in{};
-    bufferInfoB_in.buffer = m_bufferB;
-    bufferInfoB_in.offset = 0;
-    bufferInfoB_in.range = VK_WHOLE_SIZE;
-    VkDescriptorBufferInfo bufferInfoA_out{};
-    bufferInfoA_out.buffer = m_bufferA;
-    bufferInfoA_out.offset = 0;
-    bufferInfoA_out.range = VK_WHOLE_SIZE;
-    std::vector<VkWriteDescriptorSet> writesB_A(2);
-    writesB_A[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    writesB_A[0].dstSet = m_descriptorSetB_to_A;
-    writesB_A[0].dstBinding = 0;
-    writesB_A[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-    writesB_A[0].descriptorCount = 1;
-    writesB_A[0].pBufferInfo = &bufferInfoB_in;
-    writesB_A[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    writesB_A[1].dstSet = m_descriptorSetB_to_A;
-    writesB_A[1].dstBinding = 1;
-    writesB_A[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-    writesB_A[1].descriptorCount = 1;
-    writesB_A[1].pBufferInfo = &bufferInfoA_out;
-    vkUpdateDescriptorSets(m_context->getDevice(), 2, writesB_A.data(), 0, nullptr);
-}
-
-void GpuOptimizedReduceTask::createBuffers() {
-    VkDevice device = m_context->getDevice();
-    VkDeviceSize dataSize = sizeof(float) * m_n;
-
-    // Define the unified memory properties for a mobile GPU
-    VkMemoryPropertyFlags properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
-                                       VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                                       VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-
-    // --- 1. Create Buffer A (Input / Ping-Pong) ---
-    BaseComputeTask::createBuffer(m_bufferA, m_bufferMemoryA, dataSize,
-                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, // Needs to be storage
-                                  properties);
-
-    // --- 2. Fill Buffer A directly (no staging buffer!) ---
-    void* mappedData;
-    vkMapMemory(device, m_bufferMemoryA, 0, dataSize, 0, &mappedData);
-
-    float* dataPtr = (float*)mappedData;
-    for(size_t i = 0; i < m_n; i++) {
-        dataPtr[i] = 1.0f; // Fill with 1.0f
+    if (vkAllocateDescriptorSets(m_context->getDevice(), &allocInfo, &m_descriptorSetS_to_B) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate descriptor set S->B!");
     }
-
-    vkUnmapMemory(device, m_bufferMemoryA);
-
-    // --- 3. Create Buffer B (Intermediate / Ping-Pong) ---
-    // Size is based on the number of workgroups from pass 1
-    VkDeviceSize intermediateSize = sizeof(float) * (m_n / WORKGROUP_SIZE);
-
-    BaseComputeTask::createBuffer(m_bufferB, m_bufferMemoryB, intermediateSize,
-                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, // Storage + readback
-                                  properties);
+    writeDescriptorSets();
 }
 
-// --- NEW FUNCTION ---
-void GpuOptimizedReduceTask::reset() {
-    // Re-fills m_bufferA with 1.0f to reset the state for the next run
-    VkDevice device = m_context->getDevice();
-    VkDeviceSize dataSize = sizeof(float) * m_n;
-
-    void* mappedData;
-    vkMapMemory(device, m_bufferMemoryA, 0, dataSize, 0, &mappedData);
+void GpuOptimizedReduceTask::writeDescriptorSets() {
+    VkBuffer bufferB = m_bufferB.getBuffer();
+    writeDescriptorSet(m_descriptorSetA_to_B, m_bufferA, 0, VK_WHOLE_SIZE, bufferB, 0, VK_WHOLE_SIZE);
+    writeDescriptorSet(m_descriptorSetB_to_S, bufferB, 0, VK_WHOLE_SIZE, m_scratch.buffer, m_scratch.offset,
+                       m_scratch.size);
+    writeDescriptorSet(m_descriptorSetS_to_B, m_scratch.buffer, m_scratch.offset, m_scratch.size, bufferB, 0,
+                       VK_WHOLE_SIZE);
+}
 
-    float* dataPtr = (float*)mappedData;
-    for(size_t i = 0; i < m_n; i++) {
-        dataPtr[i] = 1.0f;
+void GpuOptimizedReduceTask::writeDescriptorSet(VkDescriptorSet set, VkBuffer in, VkDeviceSize inOffset,
+                                                VkDeviceSize inRange, VkBuffer out, VkDeviceSize outOffset,
+                                                VkDeviceSize outRange) {
+    VkDescriptorBufferInfo bufferInfos[2]{};
+    bufferInfos[0].buffer = in;
+    bufferInfos[0].offset = inOffset;
+    bufferInfos[0].range = inRange;
+    bufferInfos[1].buffer = out;
+    bufferInfos[1].offset = outOffset;
+    bufferInfos[1].range = outRange;
+
+    std::vector<VkWriteDescriptorSet> writes(2);
+    for (uint32_t i = 0; i < 2; i++) {
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = set;
+        writes[i].dstBinding = i;
+        writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[i].descriptorCount = 1;
+        writes[i].pBufferInfo = &bufferInfos[i];
     }
+    vkUpdateDescriptorSets(m_context->getDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+}
 
-    vkUnmapMemory(device, m_bufferMemoryA);
+void GpuOptimizedReduceTask::createBuffers() {
+    // Sized for the capacity; dispatches use the first m_n elements
+    VkDeviceSize dataSize = sizeof(float) * (VkDeviceSize)m_capacity;
+
+    // --- 1. Create Buffer A (Input) ---
+    // Device-only: filled by the input generator (TRANSFER_DST for constant fills), then only read
+    createBuffer(m_bufferA, m_memoryA, dataSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                 MemoryUsage::GPU_ONLY);
+
+    // --- 2. Create Buffer B (Intermediate / Ping-Pong) ---
+    // Size is based on the number of workgroups from pass 1.
+    // READBACK prefers HOST_CACHED: the result is read back by the CPU.
+    VkDeviceSize intermediateSize = sizeof(float) * ((m_capacity + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE);
+
+    m_bufferB.create(m_context, intermediateSize,
+                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, // Storage + result copy
+                     MemoryUsage::READBACK);
+    // --- 3. Scratch range S: the first tree level, pass 2's output (16 floats for N=1M) ---
+    uint32_t partials = (m_capacity + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+    m_scratch = m_context->getScratchPool()->allocate(sizeof(float) * ((partials + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE));
 }
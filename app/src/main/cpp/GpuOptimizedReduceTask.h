@@ -1,6 +1,12 @@
 #pragma once
 
 #include "BaseComputeTask.h"
+#include "MappedBuffer.h"
+#include "ComputeGraph.h"
+#include "InputGenerator.h"
+#include "ScratchPool.h"
+#include "GpuProfiler.h"
+#include "PipelineStatistics.h"
 #include <vector>
 
 // This struct MUST match the layout in the shader
@@ -22,7 +28,33 @@ public:
     long long dispatch() override;
     void cleanup() override;
 
-    void reset();
+    // --- Batching ---
+    bool isRecordable() override { return true; }
+    void record(VkCommandBuffer commandBuffer) override;
+    TaskResult readResult() override;
+
+    // --- Resizing ---
+    // N is the capacity until the first resize(); growing re-allocates A, B and the
+    // scratch range, rewrites the descriptor sets and regenerates A, nothing else is re-created
+    bool isResizable() override { return true; }
+    void resize(uint32_t n) override;
+    uint32_t getCapacity() override { return m_capacity; }
+    uint32_t getElementCount() const { return m_n; }
+    // Largest N: pass 1 launches one workgroup per 256 elements, and the device
+    // caps a dispatch at maxComputeWorkGroupCount[0] workgroups (65535 at least)
+    static uint64_t getMaxElementCount();
+
+    // Input values, generated on the GPU by init() and by a growing resize() (call before init())
+    void setInputDistribution(const InputDistribution& distribution) { m_distribution = distribution; }
+    const InputDistribution& getInputDistribution() const { return m_distribution; }
+    // GPU time of the last input generation, for the whole capacity (us, <0 if unknown or not trustworthy)
+    double getLastGenerateUs() const { return m_generateUs; }
+    // Every pass and barrier of the last run, as read by readResult()
+    const GpuProfile& getLastProfile() const { return m_lastProfile; }
+    // Per pass of the last run (workgroups, bytes, adds, invocations, GPU time), as read by readResult()
+    const std::vector<PassStats>& getLastPassStats() const { return m_lastPassStats; }
+    // Device memory held after init() (allocation sizes of A and B, plus the scratch range), in bytes
+    VkDeviceSize getDeviceMemoryBytes() const;
 
 protected:
     // --- BaseComputeTask "Fill-in-the-blanks" ---
@@ -34,28 +66,52 @@ protected:
 
 private:
     void cleanupBuffers();
+    void destroyBuffers(); // A, B and the scratch range only
+    void writeDescriptorSets();
+    void writeDescriptorSet(VkDescriptorSet set, VkBuffer in, VkDeviceSize inOffset, VkDeviceSize inRange,
+                            VkBuffer out, VkDeviceSize outOffset, VkDeviceSize outRange);
+    // Fills A's whole capacity (the reference sums of shorter N are its prefixes)
+    void generateInput();
+    void updateReference();
 
     // --- Task-Specific Members ---
 
-    // We need two buffers to "ping-pong" data between
+    // The input is only ever read; the partials "ping-pong" between B and a small scratch range
     // Pass 1: A -> B
-    // Pass 2: B -> A
-    // Pass 3: A -> B
-    VkBuffer m_bufferA = VK_NULL_HANDLE;
-    VkBuffer m_bufferB = VK_NULL_HANDLE;
-    VkDeviceMemory m_bufferMemoryA = VK_NULL_HANDLE;
-    VkDeviceMemory m_bufferMemoryB = VK_NULL_HANDLE;
-
-    // We store two descriptor sets, one for A->B
-    // and one for B->A
+    // Pass 2: B -> S
+    // Pass 3: S -> B
+    // A never touches the host: it is generated on the GPU at init() and when it grows
+    VkBuffer m_bufferA = VK_NULL_HANDLE; // Input
+    VkDeviceMemory m_memoryA = VK_NULL_HANDLE;
+    MappedBuffer m_bufferB; // Partials / ping-pong, read back by the host
+    ScratchRange m_scratch; // S: the first tree level, from the context's ScratchPool
+
+    // One descriptor set per direction
     VkDescriptorSet m_descriptorSetA_to_B = VK_NULL_HANDLE;
-    VkDescriptorSet m_descriptorSetB_to_A = VK_NULL_HANDLE;
+    VkDescriptorSet m_descriptorSetB_to_S = VK_NULL_HANDLE;
+    VkDescriptorSet m_descriptorSetS_to_B = VK_NULL_HANDLE;
+
+    // GPU profiling: "reduce" around the graph's per-pass and per-barrier regions ("generate" in generateInput())
+    GpuProfiler m_profiler;
+    GpuProfile m_lastProfile;
+    PipelineStatistics m_statistics; // Compute shader invocations per pass, when the device supports it
+    std::vector<PassStats> m_lastPassStats;
+    double m_hostSubmitUs = -1.0;   // dispatch()'s CPU-side bracket, for the plausibility checks
+    double m_hostCompleteUs = -1.0; // (unknown when someone else submits record()'s commands)
 
-    // GPU profiling members
-    VkQueryPool m_queryPool = VK_NULL_HANDLE;
-    float m_gpuTimestampPeriod = 1.0f; // Nanoseconds per timestamp 'tick'
+    uint32_t m_n;        // Elements per dispatch
+    uint32_t m_capacity; // Elements A can hold (and holds generated values for)
+    bool m_recorded = false; // readResult() has something to read
 
-    uint32_t m_n;
+    // --- Input ---
+    InputGenerator m_generator;
+    uint32_t m_inputTarget = 0;
+    InputDistribution m_distribution; // All 1.0 by default
+    double m_expected = 0.0;          // CPU reference sum
+    double m_tolerance = 0.0;
+    double m_generateUs = -1.0;
+    // The passes; rebuilt by record(), which derives the barriers between them
+    ComputeGraph m_graph;
 
     // We use the same problem size as the CPU
     // static const uint32_t NUM_ELEMENTS = 1024 * 1024;
@@ -0,0 +1,219 @@
+#include "GpuProfiler.h"
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+
+// --- GpuProfile ---
+
+const GpuRegion* GpuProfile::find(const std::string& name) const {
+    for (const GpuRegion& region : regions) {
+        if (region.name == name) return &region;
+    }
+    return nullptr;
+}
+
+double GpuProfile::durationUs(const std::string& name) const {
+    const GpuRegion* region = find(name);
+    if (!trustworthy || region == nullptr || !region->plausible) return -1.0;
+    return region->durationUs;
+}
+
+std::string GpuProfile::toString() const {
+    std::ostringstream out;
+    out << "Region,Start_us,Duration_us" << (calibrated ? ",Host_start_us" : "") << ",Plausible\n";
+    for (const GpuRegion& region : regions) {
+        out << std::string(2 * region.depth, ' ') << region.name << "," << region.startUs << "," << region.durationUs;
+        if (calibrated) out << "," << (long long)region.hostStartUs;
+        out << "," << (region.plausible ? "yes" : "NO") << "\n";
+    }
+    out << (trustworthy ? "Trustworthy" : "NOT trustworthy");
+    for (const std::string& issue : issues) {
+        out << "\n  ! " << issue;
+    }
+    return out.str();
+}
+
+// --- GpuProfiler ---
+
+double GpuProfiler::nowUs() {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void GpuProfiler::init(VulkanContext* context, uint32_t maxRegions) {
+    m_context = context;
+    m_period = context->getTimeStampPeriod();
+    uint32_t validBits = context->getTimestampValidBits();
+    if (m_period <= 0.0f || validBits == 0) {
+        LOGW("GpuProfiler: the compute queue cannot write timestamps, profiling disabled");
+        return;
+    }
+    m_mask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+    m_maxQueries = 2 * maxRegions;
+
+    VkQueryPoolCreateInfo queryPoolInfo{};
+    queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    queryPoolInfo.queryCount = m_maxQueries;
+    if (vkCreateQueryPool(context->getDevice(), &queryPoolInfo, nullptr, &m_queryPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create the profiler query pool!");
+    }
+}
+
+void GpuProfiler::cleanup() {
+    if (m_queryPool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(m_context->getDevice(), m_queryPool, nullptr);
+        m_queryPool = VK_NULL_HANDLE;
+    }
+    m_regions.clear();
+    m_lastValues.clear();
+}
+
+// --- Recording ---
+
+void GpuProfiler::reset(VkCommandBuffer commandBuffer) {
+    m_regions.clear();
+    m_openDepth = 0;
+    m_droppedRegions = 0;
+    if (m_queryPool != VK_NULL_HANDLE) {
+        vkCmdResetQueryPool(commandBuffer, m_queryPool, 0, m_maxQueries);
+    }
+}
+
+uint32_t GpuProfiler::beginRegion(VkCommandBuffer commandBuffer, const std::string& name,
+                                  VkPipelineStageFlagBits stage) {
+    if (m_queryPool == VK_NULL_HANDLE) return UINT32_MAX;
+    uint32_t query = static_cast<uint32_t>(2 * m_regions.size());
+    if (query + 2 > m_maxQueries) {
+        m_droppedRegions++;
+        return UINT32_MAX;
+    }
+    vkCmdWriteTimestamp(commandBuffer, stage, m_queryPool, query);
+    m_regions.push_back({name, m_openDepth, query, UINT32_MAX});
+    m_openDepth++;
+    return static_cast<uint32_t>(m_regions.size() - 1);
+}
+
+void GpuProfiler::endRegion(VkCommandBuffer commandBuffer, uint32_t region, VkPipelineStageFlagBits stage) {
+    if (region >= m_regions.size() || m_regions[region].endQuery != UINT32_MAX) return;
+    m_regions[region].endQuery = m_regions[region].beginQuery + 1;
+    vkCmdWriteTimestamp(commandBuffer, stage, m_queryPool, m_regions[region].endQuery);
+    m_openDepth--;
+}
+
+GpuProfiler::Scope::Scope(GpuProfiler* profiler, VkCommandBuffer commandBuffer, const std::string& name)
+        : m_profiler(profiler), m_commandBuffer(commandBuffer),
+          m_region(profiler != nullptr ? profiler->beginRegion(commandBuffer, name) : UINT32_MAX) {}
+
+GpuProfiler::Scope::~Scope() {
+    if (m_profiler != nullptr) m_profiler->endRegion(m_commandBuffer, m_region);
+}
+
+// --- Reading ---
+
+GpuProfile GpuProfiler::resolve(double hostSubmitUs, double hostCompleteUs) {
+    GpuProfile profile;
+    if (m_queryPool == VK_NULL_HANDLE) {
+        profile.issues.push_back("timestamps are not supported on the compute queue");
+        return profile;
+    }
+    if (m_regions.empty()) {
+        profile.issues.push_back("nothing was recorded");
+        return profile;
+    }
+
+    // Value + availability per query
+    uint32_t queryCount = static_cast<uint32_t>(2 * m_regions.size());
+    std::vector<uint64_t> results(2 * queryCount, 0);
+    vkGetQueryPoolResults(m_context->getDevice(), m_queryPool, 0, queryCount, results.size() * sizeof(uint64_t),
+                          results.data(), 2 * sizeof(uint64_t),
+                          VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    std::vector<uint64_t> values(queryCount);
+    std::vector<bool> available(queryCount);
+    for (uint32_t i = 0; i < queryCount; i++) {
+        values[i] = results[2 * i] & m_mask;
+        available[i] = results[2 * i + 1] != 0;
+    }
+
+    // Ticks from a to b, modulo the valid bits (a counter that wrapped still gives the right interval)
+    const uint64_t mask = m_mask;
+    auto ticks = [mask](uint64_t a, uint64_t b) { return (b - a) & mask; };
+    // A "later" reading more than half the counter range ahead is really an earlier one
+    auto isBefore = [mask, &ticks](uint64_t a, uint64_t b) { return a != b && ticks(b, a) < mask / 2; };
+    auto toUs = [this](uint64_t tickCount) { return (double)tickCount * m_period / 1000.0; };
+
+    // --- Profile-wide checks ---
+    if (m_droppedRegions > 0) {
+        profile.issues.push_back(std::to_string(m_droppedRegions) + " region(s) dropped: out of queries");
+    }
+    bool allAvailable = std::all_of(available.begin(), available.end(), [](bool a) { return a; });
+    if (!allAvailable) profile.issues.push_back("some timestamps were not available");
+    if (std::count(values.begin(), values.end(), 0ull) > 0) profile.issues.push_back("zero timestamps");
+    if (queryCount > 2 && std::all_of(values.begin(), values.end(), [&](uint64_t v) { return v == values[0]; })) {
+        profile.issues.push_back("every timestamp has the same value");
+    }
+    if (values == m_lastValues) profile.issues.push_back("same values as the previous profile (stale)");
+    m_lastValues = values;
+
+    // --- CPU clock: one calibrated sample, taken after completion, anchors every timestamp ---
+    uint64_t calibrationTicks = 0, calibrationNs = 0, deviationNs = 0;
+    profile.calibrated = m_context->getCalibratedTimestamps(calibrationTicks, calibrationNs, deviationNs);
+    calibrationTicks &= m_mask;
+    auto toHostUs = [&](uint64_t value) {
+        return ((double)calibrationNs - (double)ticks(value, calibrationTicks) * m_period) / 1000.0;
+    };
+    // The calibration itself is uncertain by its deviation; scheduling adds a little more
+    double slackUs = (double)deviationNs / 1000.0 + 100.0;
+    bool bracketed = hostSubmitUs >= 0.0 && hostCompleteUs >= hostSubmitUs;
+
+    // --- Per region ---
+    uint64_t base = values[0];
+    for (const Region& pending : m_regions) {
+        GpuRegion region;
+        region.name = pending.name;
+        region.depth = pending.depth;
+        if (pending.endQuery == UINT32_MAX) {
+            region.plausible = false;
+            profile.issues.push_back(pending.name + ": never ended");
+            profile.regions.push_back(region);
+            continue;
+        }
+        uint64_t begin = values[pending.beginQuery];
+        uint64_t end = values[pending.endQuery];
+        region.startUs = toUs(ticks(base, begin));
+        region.durationUs = toUs(ticks(begin, end));
+
+        if (isBefore(end, begin)) {
+            // e.g. a TOP_OF_PIPE timestamp the driver wrote before the work ahead of it finished
+            region.plausible = false;
+            region.durationUs = -toUs(ticks(end, begin));
+        }
+        if (bracketed && region.durationUs > (hostCompleteUs - hostSubmitUs) + slackUs) {
+            region.plausible = false;
+            profile.issues.push_back(pending.name + ": longer than the CPU saw the whole submission take");
+        }
+        if (profile.calibrated) {
+            if (isBefore(calibrationTicks, end)) {
+                region.plausible = false;
+                profile.issues.push_back(pending.name + ": ends after the calibration sample was taken");
+            }
+            region.hostStartUs = toHostUs(begin);
+            region.hostEndUs = toHostUs(end);
+            if (bracketed && (region.hostStartUs < hostSubmitUs - slackUs || region.hostEndUs > hostCompleteUs + slackUs)) {
+                region.plausible = false;
+                profile.issues.push_back(pending.name + ": outside the submission on the CPU clock");
+            }
+        }
+        profile.regions.push_back(region);
+    }
+
+    profile.trustworthy = profile.issues.empty();
+    if (!profile.trustworthy && (m_untrustedCount++ % 100) == 0) {
+        LOGW("GpuProfiler: readings not trusted (%s, %u so far)", profile.issues.front().c_str(), m_untrustedCount);
+    }
+#ifdef GPUCOMPUTE_TRACING
+    Tracer::gpuProfile(profile, hostCompleteUs);
+#endif
+    return profile;
+}
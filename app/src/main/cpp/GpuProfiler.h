@@ -0,0 +1,106 @@
+#pragma once
+
+#include "VulkanContext.h"
+#include <string>
+#include <vector>
+
+// One timed interval of a profiled command buffer
+struct GpuRegion {
+    std::string name;
+    uint32_t depth = 0;         // Nesting level (0 = outermost)
+    double startUs = 0.0;       // From the profile's first timestamp
+    double durationUs = 0.0;
+    double hostStartUs = -1.0;  // On the steady_clock (us since its epoch) when calibrated, else -1
+    double hostEndUs = -1.0;
+    bool plausible = true;      // Its own readings passed the checks
+};
+
+// What GpuProfiler::resolve() read back, and how far it can be trusted
+struct GpuProfile {
+    std::vector<GpuRegion> regions; // In begin order
+    bool calibrated = false;        // hostStartUs / hostEndUs are set
+    bool trustworthy = false;       // Supported, and no profile-wide issue found
+    std::vector<std::string> issues;
+
+    const GpuRegion* find(const std::string& name) const;
+    // The first region called 'name', or -1 if it is missing, implausible or the profile is not trustworthy
+    double durationUs(const std::string& name) const;
+    // One line per region, indented by depth, then the issues
+    std::string toString() const;
+};
+
+// GPU timestamps for named regions of one command buffer at a time.
+//
+// Regions nest and each one costs two queries: the begin timestamp is written
+// at TOP_OF_PIPE and the end at BOTTOM_OF_PIPE by default. ComputeGraph wraps
+// every node and every barrier in one when given a profiler (see
+// ComputeGraph::setProfiler).
+//
+// Readings are not trusted blindly; some drivers return zeros or repeat old
+// values. resolve() masks every value to the queue family's timestampValidBits
+// (so wrap-around is handled) and checks availability, zero readings, regions
+// that end before they start, a profile identical to the previous one, and,
+// when the caller passes the submission's CPU-side bracket, intervals longer
+// than the CPU saw. With VK_EXT_calibrated_timestamps every region is also
+// placed on the CPU clock and must fall inside that bracket.
+class GpuProfiler {
+public:
+    GpuProfiler() = default;
+
+    // Creates the query pool; without timestamp support on the compute queue the profiler stays disabled
+    // and every call is a no-op (resolve() then reports why)
+    void init(VulkanContext* context, uint32_t maxRegions = 32);
+    void cleanup();
+    bool isEnabled() const { return m_queryPool != VK_NULL_HANDLE; }
+
+    // --- Recording ---
+    // Resets the queries and forgets the regions; call first in every command buffer
+    void reset(VkCommandBuffer commandBuffer);
+    // Returns the region's index (UINT32_MAX when disabled or out of queries)
+    uint32_t beginRegion(VkCommandBuffer commandBuffer, const std::string& name,
+                         VkPipelineStageFlagBits stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+    void endRegion(VkCommandBuffer commandBuffer, uint32_t region,
+                   VkPipelineStageFlagBits stage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+
+    // begin/end bracketed by a C++ scope; a null profiler records nothing
+    class Scope {
+    public:
+        Scope(GpuProfiler* profiler, VkCommandBuffer commandBuffer, const std::string& name);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        GpuProfiler* m_profiler;
+        VkCommandBuffer m_commandBuffer;
+        uint32_t m_region;
+    };
+
+    // --- Reading ---
+    // Once the submission has completed. 'hostSubmitUs' / 'hostCompleteUs' (nowUs() just before the
+    // submit and just after the wait, <0 to skip) bound what the GPU can plausibly have measured.
+    GpuProfile resolve(double hostSubmitUs = -1.0, double hostCompleteUs = -1.0);
+
+    // The steady_clock in us, the clock calibrated host times are on
+    static double nowUs();
+
+private:
+    struct Region {
+        std::string name;
+        uint32_t depth;
+        uint32_t beginQuery;
+        uint32_t endQuery; // UINT32_MAX while open
+    };
+
+    VulkanContext* m_context = nullptr;
+    VkQueryPool m_queryPool = VK_NULL_HANDLE;
+    uint32_t m_maxQueries = 0;
+    float m_period = 0.0f; // ns per tick
+    uint64_t m_mask = 0;   // timestampValidBits
+
+    std::vector<Region> m_regions;
+    uint32_t m_openDepth = 0;
+    uint32_t m_droppedRegions = 0;
+    std::vector<uint64_t> m_lastValues; // Of the previous resolve(), to spot a driver repeating itself
+    uint32_t m_untrustedCount = 0;      // For rate-limited warnings
+};
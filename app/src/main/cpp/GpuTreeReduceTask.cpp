@@ -35,11 +35,8 @@ void GpuTreeReduceTask::cleanup() {
 
 void GpuTreeReduceTask::cleanupBuffers() {
     // ... (this function is unchanged)
-    VkDevice device = m_context->getDevice();
-    if (m_bufferA != VK_NULL_HANDLE) vkDestroyBuffer(device, m_bufferA, nullptr);
-    if (m_bufferB != VK_NULL_HANDLE) vkDestroyBuffer(device, m_bufferB, nullptr);
-    if (m_bufferMemoryA != VK_NULL_HANDLE) vkFreeMemory(device, m_bufferMemoryA, nullptr);
-    if (m_bufferMemoryB != VK_NULL_HANDLE) vkFreeMemory(device, m_bufferMemoryB, nullptr);
+    m_bufferA.destroy();
+    m_bufferB.destroy();
 }
 
 // --- Overridden init() ---
@@ -146,6 +143,10 @@ long long GpuTreeReduceTask::dispatch() {
     // --- 2. Allocate Command Buffer ---
     VkCommandBuffer commandBuffer = beginSingleTimeCommands();
 
+    // Staged input (discrete GPUs only) is copied in before the START timestamp, so the GPU time
+    // excludes it; the CPU-side time above does include it
+    m_bufferA.recordUpload(commandBuffer);
+
     // --- 3. Reset Query Pool ---
     if (m_queryPool != VK_NULL_HANDLE) {
         vkCmdResetQueryPool(commandBuffer, m_queryPool, 0, 2);
@@ -178,7 +179,7 @@ long long GpuTreeReduceTask::dispatch() {
     while (elementsToProcess > 1) {
         // *** CRITICAL BARRIER ***
         addBufferBarrier(commandBuffer,
-                         readFromB_writeToA ? m_bufferB : m_bufferA,
+                         readFromB_writeToA ? m_bufferB.getBuffer() : m_bufferA.getBuffer(),
                          VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
                          VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
 
@@ -199,14 +200,22 @@ long long GpuTreeReduceTask::dispatch() {
     }
 
     // --- 7. Read Back Result ---
-    VkBuffer finalBuffer = readFromB_writeToA ? m_bufferB : m_bufferA; // The fix
-    VkDeviceMemory finalMemory = readFromB_writeToA ? m_bufferMemoryB : m_bufferMemoryA;
+    bool resultInA = !readFromB_writeToA; // The fix
+    const MappedBuffer* finalMapped = &m_bufferB;
 
-    // *** FINAL BARRIER ***
-    // Wait for shader writes to be visible to the HOST (CPU)
-    addBufferBarrier(commandBuffer, finalBuffer,
-                     VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_HOST_READ_BIT,
-                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_HOST_BIT);
+    if (resultInA && !m_bufferA.isDirect()) {
+        // A lives in device-only memory (discrete GPU): move the sum into B[0]
+        recordResultCopy(commandBuffer, m_bufferA.getBuffer(), m_bufferB.getBuffer(), sizeof(float));
+    } else {
+        // B is host-visible, and so is A when it is used in place (unified memory)
+        if (resultInA) finalMapped = &m_bufferA.getHostBuffer();
+
+        // *** FINAL BARRIER ***
+        // Wait for shader writes to be visible to the HOST (CPU)
+        addBufferBarrier(commandBuffer, finalMapped->getBuffer(),
+                         VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_HOST_READ_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_HOST_BIT);
+    }
 
     // --- 8. Write END Timestamp ---
     if (m_queryPool != VK_NULL_HANDLE) {
@@ -220,7 +229,7 @@ long long GpuTreeReduceTask::dispatch() {
     // ...
 
     // --- 10. End Recording and Submit ---
-    endSingleTimeCommands(commandBuffer); // This includes vkQueueWaitIdle()
+    endSingleTimeCommands(commandBuffer); // Waits for this submission to finish
 
     // --- 11. Get CPU-side timer ---
     auto endTime = std::chrono::high_resolution_clock::now();
@@ -258,11 +267,11 @@ long long GpuTreeReduceTask::dispatch() {
     }
     // ---
 
-    // --- 13. Verify (Read directly from the final buffer) ---
-    void* mappedData;
-    vkMapMemory(device, finalMemory, 0, sizeof(float), 0, &mappedData);
+    // --- 13. Verify (Read directly from the persistently mapped final buffer) ---
+    // Non-coherent (e.g. HOST_CACHED) memory must be invalidated before the CPU reads it
+    finalMapped->invalidate(0, sizeof(float));
 
-    float result = *(float*)mappedData;
+    float result = *finalMapped->data<float>();
     float expected = (float)m_n;
 
     LOGI("--- VERIFICATION (N=%u) ---", m_n);
@@ -274,8 +283,6 @@ long long GpuTreeReduceTask::dispatch() {
         LOGE("FAILED");
     }
 
-    vkUnmapMemory(device, finalMemory);
-
     // --- 14. Cleanup (No staging buffer) ---
     LOGI("CPU-side timer (incl. stall): %lld microseconds", (long long)duration.count());
 
@@ -311,11 +318,11 @@ void GpuTreeReduceTask::createDescriptorSet() {
         throw std::runtime_error("Failed to allocate descriptor set B->A!");
     }
     VkDescriptorBufferInfo bufferInfoA_in{};
-    bufferInfoA_in.buffer = m_bufferA;
+    bufferInfoA_in.buffer = m_bufferA.getBuffer();
     bufferInfoA_in.offset = 0;
     bufferInfoA_in.range = VK_WHOLE_SIZE;
     VkDescriptorBufferInfo bufferInfoB_out{};
-    bufferInfoB_out.buffer = m_bufferB;
+    bufferInfoB_out.buffer = m_bufferB.getBuffer();
     bufferInfoB_out.offset = 0;
     bufferInfoB_out.range = VK_WHOLE_SIZE;
     std::vector<VkWriteDescriptorSet> writesA_B(2);
@@ -333,11 +340,11 @@ void GpuTreeReduceTask::createDescriptorSet() {
     writesA_B[1].pBufferInfo = &bufferInfoB_out;
     vkUpdateDescriptorSets(m_context->getDevice(), 2, writesA_B.data(), 0, nullptr);
     VkDescriptorBufferInfo bufferInfoB_in{};
-    bufferInfoB_in.buffer = m_bufferB;
+    bufferInfoB_in.buffer = m_bufferB.getBuffer();
     bufferInfoB_in.offset = 0;
     bufferInfoB_in.range = VK_WHOLE_SIZE;
     VkDescriptorBufferInfo bufferInfoA_out{};
-    bufferInfoA_out.buffer = m_bufferA;
+    bufferInfoA_out.buffer = m_bufferA.getBuffer();
     bufferInfoA_out.offset = 0;
     bufferInfoA_out.range = VK_WHOLE_SIZE;
     std::vector<VkWriteDescriptorSet> writesB_A(2);
@@ -357,52 +364,35 @@ void GpuTreeReduceTask::createDescriptorSet() {
 }
 
 void GpuTreeReduceTask::createBuffers() {
-    VkDevice device = m_context->getDevice();
     VkDeviceSize dataSize = sizeof(float) * m_n;
 
-    // Define the unified memory properties for a mobile GPU
-    VkMemoryPropertyFlags properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
-                                       VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                                       VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-
-    // --- 1. Create Buffer A (Input / Ping-Pong) ---
-    BaseComputeTask::createBuffer(m_bufferA, m_bufferMemoryA, dataSize,
-                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, // Needs to be storage
-                                  properties);
+    // Placement comes from VulkanContext's memory policy: on unified memory A
+    // is written in place, on discrete GPUs it is staged into device memory.
 
-    // --- 2. Fill Buffer A directly (no staging buffer!) ---
-    void* mappedData;
-    vkMapMemory(device, m_bufferMemoryA, 0, dataSize, 0, &mappedData);
+    // --- 1. Create Buffer A (Input / Ping-Pong), written by the host every reset() ---
+    m_bufferA.create(m_context, dataSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
 
-    float* dataPtr = (float*)mappedData;
-    for(size_t i = 0; i < m_n; i++) {
-        dataPtr[i] = 1.0f; // Fill with 1.0f
-    }
-
-    vkUnmapMemory(device, m_bufferMemoryA);
+    // --- 2. Fill Buffer A (uploaded at the start of the next dispatch if staged) ---
+    reset();
 
     // --- 3. Create Buffer B (Intermediate / Ping-Pong) ---
-    // Size is based on the number of workgroups from pass 1
+    // Size is based on the number of workgroups from pass 1.
+    // READBACK prefers HOST_CACHED: the result is read back by the CPU.
     VkDeviceSize intermediateSize = sizeof(float) * (m_n / WORKGROUP_SIZE);
 
-    BaseComputeTask::createBuffer(m_bufferB, m_bufferMemoryB, intermediateSize,
-                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, // Storage + readback
-                                  properties);
+    m_bufferB.create(m_context, intermediateSize,
+                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, // Storage + result copy
+                     MemoryUsage::READBACK);
 }
 
 // --- NEW FUNCTION ---
 void GpuTreeReduceTask::reset() {
     // Re-fills m_bufferA with 1.0f to reset the state for the next run
-    VkDevice device = m_context->getDevice();
-    VkDeviceSize dataSize = sizeof(float) * m_n;
-
-    void* mappedData;
-    vkMapMemory(device, m_bufferMemoryA, 0, dataSize, 0, &mappedData);
-
-    float* dataPtr = (float*)mappedData;
+    float* dataPtr = m_bufferA.data<float>();
     for(size_t i = 0; i < m_n; i++) {
         dataPtr[i] = 1.0f;
     }
 
-    vkUnmapMemory(device, m_bufferMemoryA);
+    // No-op on coherent memory
+    m_bufferA.flush();
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "BaseComputeTask.h"
+#include "MappedBuffer.h"
 #include <vector>
 
 // This struct MUST match the layout in the shader
@@ -41,10 +42,9 @@ private:
     // Pass 1: A -> B
     // Pass 2: B -> A
     // Pass 3: A -> B
-    VkBuffer m_bufferA = VK_NULL_HANDLE;
-    VkBuffer m_bufferB = VK_NULL_HANDLE;
-    VkDeviceMemory m_bufferMemoryA = VK_NULL_HANDLE;
-    VkDeviceMemory m_bufferMemoryB = VK_NULL_HANDLE;
+    // Both stay mapped for the task's lifetime (no per-iteration vkMapMemory)
+    UploadBuffer m_bufferA; // Input / ping-pong (staged on discrete GPUs)
+    MappedBuffer m_bufferB; // Partials / ping-pong, read back by the host
 
     // We store two descriptor sets, one for A->B
     // and one for B->A
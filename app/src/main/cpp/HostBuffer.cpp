@@ -0,0 +1,135 @@
+#include "HostBuffer.h"
+#include <stdexcept>
+#include <cstring>
+#include <algorithm>
+
+const char* HostBuffer::getPathName(HostBufferPath path) {
+    switch (path) {
+        case HostBufferPath::IMPORTED: return "imported";
+        case HostBufferPath::STAGED_COPY: return "staged-copy";
+    }
+    return "unknown";
+}
+
+VkDeviceSize HostBuffer::alignForImport(VulkanContext* context, VkDeviceSize size) {
+    VkDeviceSize alignment = std::max<VkDeviceSize>(1, context->getMinImportedHostPointerAlignment());
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+void HostBuffer::create(VulkanContext* context, void* hostPointer, VkDeviceSize size, VkBufferUsageFlags usage,
+                        bool allowImport) {
+    m_context = context;
+    m_hostPointer = hostPointer;
+    m_size = size;
+    if (hostPointer == nullptr || size == 0) {
+        throw std::runtime_error("HostBuffer needs a host pointer and a size!");
+    }
+
+    m_fallbackReason = allowImport ? tryImport(usage) : "import disabled by caller";
+    if (m_fallbackReason == nullptr) {
+        m_path = HostBufferPath::IMPORTED;
+        LOGI("HostBuffer: imported %llu bytes at %p", (unsigned long long)m_size, m_hostPointer);
+        return;
+    }
+
+    // Pinned copy: the GPU reads it in place, like the unified-memory UploadBuffer
+    m_path = HostBufferPath::STAGED_COPY;
+    m_staged.create(m_context, m_size, usage, MemoryUsage::STREAMING);
+    update();
+    LOGI("HostBuffer: copying %llu bytes (%s)", (unsigned long long)m_size, m_fallbackReason);
+}
+
+const char* HostBuffer::tryImport(VkBufferUsageFlags usage) {
+    if (!m_context->hasHostPointerImport()) {
+        return "VK_EXT_external_memory_host not supported";
+    }
+    VkDeviceSize alignment = m_context->getMinImportedHostPointerAlignment();
+    if (reinterpret_cast<uintptr_t>(m_hostPointer) % alignment != 0 || m_size % alignment != 0) {
+        return "pointer or size not aligned for import";
+    }
+    uint32_t importTypeBits = m_context->getHostPointerMemoryTypeBits(m_hostPointer);
+    if (importTypeBits == 0) {
+        return "driver cannot import this allocation";
+    }
+
+    VkDevice device = m_context->getDevice();
+    VkExternalMemoryBufferCreateInfo externalInfo{};
+    externalInfo.sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO;
+    externalInfo.handleTypes = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.pNext = &externalInfo;
+    bufferInfo.size = m_size;
+    bufferInfo.usage = usage;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if (vkCreateBuffer(device, &bufferInfo, nullptr, &m_importedBuffer) != VK_SUCCESS) {
+        m_importedBuffer = VK_NULL_HANDLE;
+        return "external buffer creation failed";
+    }
+
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(device, m_importedBuffer, &memRequirements);
+
+    // Only coherent types: imported memory is never mapped, so it cannot be flushed
+    const VkPhysicalDeviceMemoryProperties& memoryProperties = m_context->getMemoryProperties();
+    uint32_t typeBits = 0;
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+        if (memoryProperties.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) {
+            typeBits |= (1u << i);
+        }
+    }
+    typeBits &= importTypeBits & memRequirements.memoryTypeBits;
+
+    const char* failure = nullptr;
+    if (typeBits == 0) {
+        failure = "no coherent memory type accepts the import";
+    } else if (memRequirements.size > m_size) {
+        failure = "buffer needs more memory than the allocation holds";
+    } else {
+        VkImportMemoryHostPointerInfoEXT importInfo{};
+        importInfo.sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_HOST_POINTER_INFO_EXT;
+        importInfo.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+        importInfo.pHostPointer = m_hostPointer;
+
+        VkMemoryAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.pNext = &importInfo;
+        allocInfo.allocationSize = m_size;
+        allocInfo.memoryTypeIndex = m_context->selectMemoryType(typeBits, MemoryUsage::STREAMING);
+        if (vkAllocateMemory(device, &allocInfo, nullptr, &m_importedMemory) != VK_SUCCESS) {
+            m_importedMemory = VK_NULL_HANDLE;
+            failure = "memory import failed";
+        } else if (vkBindBufferMemory(device, m_importedBuffer, m_importedMemory, 0) != VK_SUCCESS) {
+            failure = "binding imported memory failed";
+        }
+    }
+
+    if (failure != nullptr) {
+        if (m_importedMemory != VK_NULL_HANDLE) vkFreeMemory(device, m_importedMemory, nullptr);
+        vkDestroyBuffer(device, m_importedBuffer, nullptr);
+        m_importedBuffer = VK_NULL_HANDLE;
+        m_importedMemory = VK_NULL_HANDLE;
+    }
+    return failure;
+}
+
+void HostBuffer::destroy() {
+    if (m_context == nullptr) return;
+    VkDevice device = m_context->getDevice();
+    // The imported pages stay with the caller; only the Vulkan objects go
+    if (m_importedBuffer != VK_NULL_HANDLE) vkDestroyBuffer(device, m_importedBuffer, nullptr);
+    if (m_importedMemory != VK_NULL_HANDLE) vkFreeMemory(device, m_importedMemory, nullptr);
+    m_importedBuffer = VK_NULL_HANDLE;
+    m_importedMemory = VK_NULL_HANDLE;
+    m_staged.destroy();
+    m_context = nullptr;
+}
+
+void HostBuffer::update(VkDeviceSize offset, VkDeviceSize size) {
+    if (m_path == HostBufferPath::IMPORTED) return; // The GPU reads the caller's bytes
+
+    if (size == VK_WHOLE_SIZE) size = m_size - offset;
+    std::memcpy(m_staged.data<uint8_t>() + offset, static_cast<const uint8_t*>(m_hostPointer) + offset, size);
+    m_staged.flush(offset, size);
+}
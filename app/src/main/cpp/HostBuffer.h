@@ -0,0 +1,63 @@
+#pragma once
+
+#include "VulkanContext.h"
+#include "MappedBuffer.h"
+
+// How a HostBuffer's data reaches the GPU
+enum class HostBufferPath {
+    IMPORTED,   // The caller's memory itself (VK_EXT_external_memory_host), no copy
+    STAGED_COPY // A pinned host-visible copy that update() refreshes
+};
+
+// A VkBuffer over memory the caller already owns (malloc'd, a Java direct buffer, ...).
+//
+// When the device supports VK_EXT_external_memory_host and the pointer and
+// size are multiples of getMinImportedHostPointerAlignment(), the memory is
+// imported as-is: the GPU reads the caller's bytes and update() costs nothing.
+// Otherwise the data is copied into a persistently mapped STREAMING buffer,
+// which the GPU also reads in place; update() copies again. getPath() and
+// getFallbackReason() tell the caller which one it got.
+//
+// Either way the caller keeps ownership of the pointer and must keep it alive
+// (and unmoved) until destroy(). Host writes must finish before the submit
+// that reads them; update() must come after them.
+class HostBuffer {
+public:
+    HostBuffer() = default;
+
+    // 'allowImport' = false forces the copy path (for comparisons)
+    void create(VulkanContext* context, void* hostPointer, VkDeviceSize size, VkBufferUsageFlags usage,
+                bool allowImport = true);
+    void destroy();
+
+    // Makes the caller's latest writes visible to the GPU (no-op when imported)
+    void update(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+
+    // --- Getters ---
+    VkBuffer getBuffer() const { return m_path == HostBufferPath::IMPORTED ? m_importedBuffer : m_staged.getBuffer(); }
+    VkDeviceSize getSize() const { return m_size; }
+    HostBufferPath getPath() const { return m_path; }
+    bool isImported() const { return m_path == HostBufferPath::IMPORTED; }
+    static const char* getPathName(HostBufferPath path);
+    // Why the import was not used (nullptr when imported)
+    const char* getFallbackReason() const { return m_fallbackReason; }
+
+    // Rounds a size up to what an import needs (for callers sizing their own allocations)
+    static VkDeviceSize alignForImport(VulkanContext* context, VkDeviceSize size);
+
+private:
+    // Returns nullptr on success, the reason otherwise
+    const char* tryImport(VkBufferUsageFlags usage);
+
+    VulkanContext* m_context = nullptr;
+    void* m_hostPointer = nullptr;
+    VkDeviceSize m_size = 0;
+    HostBufferPath m_path = HostBufferPath::STAGED_COPY;
+    const char* m_fallbackReason = nullptr;
+
+    // IMPORTED
+    VkBuffer m_importedBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory m_importedMemory = VK_NULL_HANDLE;
+    // STAGED_COPY
+    MappedBuffer m_staged;
+};
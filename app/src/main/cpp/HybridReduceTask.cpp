@@ -0,0 +1,178 @@
+#include "HybridReduceTask.h"
+#include "SubmitQueue.h"
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+using Clock = std::chrono::high_resolution_clock;
+
+HybridReduceTask::HybridReduceTask(AAssetManager* assetManager, uint32_t n, const InputDistribution& distribution)
+        : m_assetManager(assetManager), m_context(VulkanContext::getInstance()), m_n(n),
+          m_distribution(distribution) {
+    if (m_n < 2) {
+        throw std::runtime_error("HybridReduceTask needs N >= 2!");
+    }
+    m_numThreads = (int)std::thread::hardware_concurrency();
+    if (m_numThreads == 0) m_numThreads = 4; // Fallback
+    LOGI("HybridReduceTask created. N=%u, CPU threads=%d", m_n, m_numThreads);
+}
+
+HybridReduceTask::~HybridReduceTask() {
+    LOGI("HybridReduceTask destroyed");
+}
+
+void HybridReduceTask::init() {
+    LOGI("HybridReduceTask::init() starting...");
+
+    // READBACK prefers HOST_CACHED: the CPU threads read it every dispatch, and
+    // reads from uncached (write-combined) memory would starve them
+    m_input.create(m_context, sizeof(float) * (VkDeviceSize)m_n, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                   MemoryUsage::READBACK);
+    InputGenerator::hostFill(m_distribution, m_input.data<float>(), m_n);
+    m_input.flush(); // Written once; neither side ever writes it again
+
+    double absSum = 0.0;
+    InputGenerator::hostReference(m_distribution, m_n, m_expected, absSum);
+    // Float partial sums in a different order: allow a relative error on the magnitudes
+    m_tolerance = std::max(0.01, 1e-4 * absSum);
+
+    m_gpuTask.reset(new FrugalReduceTask(m_assetManager, m_input.getBuffer(), m_n));
+    m_gpuTask->init();
+    m_threadPartialSums.assign(m_numThreads, 0.0);
+
+    LOGI("HybridReduceTask::init() finished. Input %s, %s memory", m_input.isCached() ? "cached" : "uncached",
+         m_context->isUnifiedMemory() ? "unified" : "discrete");
+}
+
+void HybridReduceTask::cleanup() {
+    LOGI("HybridReduceTask::cleanup()");
+    if (m_gpuTask) {
+        m_gpuTask->cleanup();
+        m_gpuTask.reset();
+    }
+    m_input.destroy();
+    m_threadPartialSums.clear();
+}
+
+// --- Split control ---
+
+void HybridReduceTask::setFixedShare(double gpuShare) {
+    m_gpuShare = std::min(1.0, std::max(0.0, gpuShare));
+    m_adaptive = false;
+}
+
+void HybridReduceTask::setAdaptive(double initialGpuShare) {
+    m_gpuShare = std::min(1.0 - MIN_SHARE, std::max(MIN_SHARE, initialGpuShare));
+    m_adaptive = true;
+}
+
+// --- Dispatch ---
+
+long long HybridReduceTask::dispatch() {
+    TRACE_SCOPE("HybridReduceTask::dispatch", "task");
+    uint32_t gpuCount = (uint32_t)std::llround(m_gpuShare * m_n);
+    if (m_adaptive) gpuCount = std::min(m_n - 1, std::max(1u, gpuCount)); // Both sides get work to measure
+    uint32_t cpuCount = m_n - gpuCount;
+
+    auto startTime = Clock::now();
+
+    // --- 1. GPU side: the prefix, submitted without waiting ---
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    SubmitTicket ticket;
+    if (gpuCount > 0) {
+        m_gpuTask->setElementCount(gpuCount);
+
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = m_context->getCommandPool();
+        allocInfo.commandBufferCount = 1;
+        if (vkAllocateCommandBuffers(m_context->getDevice(), &allocInfo, &commandBuffer) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to allocate the hybrid command buffer!");
+        }
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(commandBuffer, &beginInfo);
+        m_gpuTask->record(commandBuffer);
+        vkEndCommandBuffer(commandBuffer);
+        ticket = m_context->getSubmitQueue()->submit(m_context->getQueue(), commandBuffer);
+    }
+
+    // --- 2. CPU side: the tail, on the threads, while the GPU works ---
+    // Each thread records when it finished; the CPU side is done with the last one
+    std::vector<Clock::time_point> threadEnds(m_numThreads, startTime);
+    std::vector<std::thread> threads;
+    if (cpuCount > 0) {
+        uint32_t perThread = cpuCount / m_numThreads;
+        for (int i = 0; i < m_numThreads; i++) {
+            uint32_t begin = gpuCount + i * perThread;
+            uint32_t end = (i == m_numThreads - 1) ? m_n : begin + perThread;
+            threads.emplace_back([this, i, begin, end, &threadEnds]() {
+                TRACE_THREAD_NAME("hybrid worker");
+                TRACE_SCOPE("cpu slice", "cpu");
+                const float* data = m_input.data<float>();
+                float sum = 0.0f;
+                for (uint32_t j = begin; j < end; j++) {
+                    sum += data[j];
+                }
+                m_threadPartialSums[i] = sum;
+                threadEnds[i] = Clock::now();
+            });
+        }
+    }
+
+    // --- 3. Wait for both, timing each side separately ---
+    auto gpuEnd = startTime;
+    TaskResult gpuResult;
+    gpuResult.value = 0.0;
+    if (gpuCount > 0) {
+        ticket.wait(); // Traced as "fence wait"
+        gpuEnd = Clock::now();
+        vkFreeCommandBuffers(m_context->getDevice(), m_context->getCommandPool(), 1, &commandBuffer);
+        gpuResult = m_gpuTask->readResult();
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    double cpuSum = 0.0;
+    auto cpuEnd = startTime;
+    if (cpuCount > 0) {
+        for (int i = 0; i < m_numThreads; i++) {
+            cpuSum += m_threadPartialSums[i];
+            cpuEnd = std::max(cpuEnd, threadEnds[i]);
+        }
+    }
+    auto endTime = Clock::now();
+
+    // --- 4. Combine the partials on the host ---
+    m_lastResult = TaskResult();
+    m_lastResult.value = gpuResult.value + cpuSum;
+    m_lastResult.valid = std::fabs(m_lastResult.value - m_expected) <= m_tolerance;
+    m_lastResult.gpuTimeUs = gpuCount > 0 ? gpuResult.gpuTimeUs : -1.0;
+    m_lastResult.hostTimeUs = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+
+    m_lastSplit.gpuElements = gpuCount;
+    m_lastSplit.cpuElements = cpuCount;
+    m_lastSplit.gpuUs = std::chrono::duration<double, std::micro>(gpuEnd - startTime).count();
+    m_lastSplit.cpuUs = std::chrono::duration<double, std::micro>(cpuEnd - startTime).count();
+
+    // --- 5. Move the share toward the one at which both sides would finish together ---
+    if (m_adaptive && m_lastSplit.gpuUs > 0.0 && m_lastSplit.cpuUs > 0.0) {
+        double gpuRate = gpuCount / m_lastSplit.gpuUs;
+        double cpuRate = cpuCount / m_lastSplit.cpuUs;
+        double balanced = gpuRate / (gpuRate + cpuRate);
+        m_gpuShare += SMOOTHING * (balanced - m_gpuShare);
+        m_gpuShare = std::min(1.0 - MIN_SHARE, std::max(MIN_SHARE, m_gpuShare));
+    }
+    m_lastSplit.gpuShare = m_gpuShare;
+
+    if (!m_lastResult.valid) {
+        LOGE("HybridReduceTask: %.3f, expected %.3f (GPU %u + CPU %u elements)", m_lastResult.value, m_expected,
+             gpuCount, cpuCount);
+    }
+    return m_lastResult.hostTimeUs;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "ComputeTask.h"
+#include "MappedBuffer.h"
+#include "FrugalReduceTask.h"
+#include "InputGenerator.h"
+#include <android/asset_manager.h>
+#include <memory>
+#include <vector>
+
+// How the last dispatch divided the input, and how long each side took
+struct HybridSplit {
+    uint32_t gpuElements = 0; // [0, gpuElements) on the GPU
+    uint32_t cpuElements = 0; // The rest on the CPU threads
+    double gpuUs = 0.0;       // Submit -> fence, wall time
+    double cpuUs = 0.0;       // Thread launch -> last thread done
+    double gpuShare = 0.0;    // The share the next dispatch will use
+};
+
+// Sum reduction of one input split between the GPU and the CPU at the same time.
+//
+// The input is a single host-cached mapped buffer that both sides read in
+// place: the GPU reduces the prefix through a borrowed-input FrugalReduceTask
+// (reduce_optimized.comp, input never written), while the CPU threads reduce
+// the tail, the same slicing as CpuReduceTask. The two partials are added on
+// the host. On unified memory neither side copies anything; on a discrete GPU
+// the prefix is read across the bus, so the split settles on a small GPU share.
+//
+// The GPU share adapts after every dispatch: each side's throughput
+// (elements / wall time) gives the share at which both would finish together,
+// and the share moves halfway there. Its fixed point is both sides finishing
+// at the same time. setFixedShare() turns this off (0 = CPU only, 1 = GPU only).
+class HybridReduceTask : public ComputeTask {
+public:
+    HybridReduceTask(AAssetManager* assetManager, uint32_t n,
+                     const InputDistribution& distribution = InputDistribution::constant(1.0f));
+    ~HybridReduceTask();
+
+    // --- ComputeTask Interface ---
+    void init() override;
+    long long dispatch() override;
+    void cleanup() override;
+
+    // The sum of the last dispatch, checked against the host reference
+    TaskResult getLastResult() const { return m_lastResult; }
+    const HybridSplit& getLastSplit() const { return m_lastSplit; }
+
+    // --- Split control ---
+    void setFixedShare(double gpuShare);
+    void setAdaptive(double initialGpuShare = 0.5);
+    double getGpuShare() const { return m_gpuShare; }
+
+private:
+    AAssetManager* m_assetManager;
+    VulkanContext* m_context;
+    uint32_t m_n;
+    int m_numThreads;
+    InputDistribution m_distribution;
+    double m_expected = 0.0;
+    double m_tolerance = 0.0;
+
+    MappedBuffer m_input; // Read in place by both sides
+    std::unique_ptr<FrugalReduceTask> m_gpuTask;
+    std::vector<double> m_threadPartialSums;
+
+    // --- Split state ---
+    double m_gpuShare = 0.5;
+    bool m_adaptive = true;
+    HybridSplit m_lastSplit;
+    TaskResult m_lastResult;
+
+    static constexpr double MIN_SHARE = 0.02; // Adaptive mode keeps both sides measurable
+    static constexpr double SMOOTHING = 0.5;  // Fraction of the way to the balanced share per dispatch
+};
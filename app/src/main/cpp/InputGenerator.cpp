@@ -0,0 +1,251 @@
+#include "InputGenerator.h"
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+// Same hash as generate.comp
+uint32_t pcg(uint32_t v) {
+    uint32_t state = v * 747796405u + 2891336453u;
+    uint32_t word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    return (word >> 22u) ^ word;
+}
+
+const float INV_2_24 = 1.0f / 16777216.0f;
+}
+
+const char* InputDistribution::getName() const {
+    switch (kind) {
+        case InputKind::CONSTANT: return "constant";
+        case InputKind::IOTA: return "iota";
+        case InputKind::UNIFORM: return "uniform";
+        case InputKind::NORMAL: return "normal";
+    }
+    return "unknown";
+}
+
+// --- Setup ---
+
+void InputGenerator::init(VulkanContext* context, VkShaderModule shaderModule) {
+    m_context = context;
+    VkDevice device = m_context->getDevice();
+
+    VkDescriptorSetLayoutBinding binding{};
+    binding.binding = 0;
+    binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    binding.descriptorCount = 1;
+    binding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = 1;
+    layoutInfo.pBindings = &binding;
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &m_descriptorSetLayout) != VK_SUCCESS) {
+        vkDestroyShaderModule(device, shaderModule, nullptr);
+        throw std::runtime_error("Failed to create generator descriptor set layout!");
+    }
+
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = MAX_TARGETS;
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    poolInfo.maxSets = MAX_TARGETS;
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS) {
+        vkDestroyShaderModule(device, shaderModule, nullptr);
+        throw std::runtime_error("Failed to create generator descriptor pool!");
+    }
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(GeneratePushData);
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &m_descriptorSetLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+    if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
+        vkDestroyShaderModule(device, shaderModule, nullptr);
+        throw std::runtime_error("Failed to create generator pipeline layout!");
+    }
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.layout = m_pipelineLayout;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = shaderModule;
+    pipelineInfo.stage.pName = "main";
+    VkResult result = vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_pipeline);
+
+    // Shader module can be destroyed after pipeline creation
+    vkDestroyShaderModule(device, shaderModule, nullptr);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create generator pipeline!");
+    }
+}
+
+void InputGenerator::cleanup() {
+    if (m_context == nullptr) return;
+    VkDevice device = m_context->getDevice();
+
+    if (m_pipeline != VK_NULL_HANDLE) vkDestroyPipeline(device, m_pipeline, nullptr);
+    if (m_pipelineLayout != VK_NULL_HANDLE) vkDestroyPipelineLayout(device, m_pipelineLayout, nullptr);
+    // Descriptor sets go away with the pool
+    if (m_descriptorPool != VK_NULL_HANDLE) vkDestroyDescriptorPool(device, m_descriptorPool, nullptr);
+    if (m_descriptorSetLayout != VK_NULL_HANDLE) vkDestroyDescriptorSetLayout(device, m_descriptorSetLayout, nullptr);
+
+    m_pipeline = VK_NULL_HANDLE;
+    m_pipelineLayout = VK_NULL_HANDLE;
+    m_descriptorPool = VK_NULL_HANDLE;
+    m_descriptorSetLayout = VK_NULL_HANDLE;
+    m_targets.clear();
+    m_context = nullptr;
+}
+
+uint32_t InputGenerator::addTarget(VkBuffer buffer) {
+    if (m_targets.size() >= MAX_TARGETS) {
+        throw std::runtime_error("Too many input generator targets!");
+    }
+
+    Target target;
+    target.buffer = buffer;
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_descriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &m_descriptorSetLayout;
+    if (vkAllocateDescriptorSets(m_context->getDevice(), &allocInfo, &target.descriptorSet) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate generator descriptor set!");
+    }
+
+    m_targets.push_back(target);
+    uint32_t index = static_cast<uint32_t>(m_targets.size() - 1);
+    setTarget(index, buffer);
+    return index;
+}
+
+void InputGenerator::setTarget(uint32_t target, VkBuffer buffer) {
+    Target& t = m_targets.at(target);
+    t.buffer = buffer;
+
+    VkDescriptorBufferInfo bufferInfo{};
+    bufferInfo.buffer = buffer;
+    bufferInfo.offset = 0;
+    bufferInfo.range = VK_WHOLE_SIZE;
+
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = t.descriptorSet;
+    write.dstBinding = 0;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    write.descriptorCount = 1;
+    write.pBufferInfo = &bufferInfo;
+    vkUpdateDescriptorSets(m_context->getDevice(), 1, &write, 0, nullptr);
+}
+
+// --- Recording ---
+
+void InputGenerator::record(VkCommandBuffer commandBuffer, uint32_t target, uint32_t count,
+                            const InputDistribution& distribution) const {
+    const Target& t = m_targets.at(target);
+
+    VkPipelineStageFlags srcStage;
+    VkAccessFlags srcAccess;
+    if (distribution.kind == InputKind::CONSTANT) {
+        // A fill is a transfer; no shader needed
+        uint32_t bits;
+        std::memcpy(&bits, &distribution.p0, sizeof(bits));
+        vkCmdFillBuffer(commandBuffer, t.buffer, 0, sizeof(float) * (VkDeviceSize)count, bits);
+        srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        srcAccess = VK_ACCESS_TRANSFER_WRITE_BIT;
+    } else {
+        GeneratePushData pushData{};
+        pushData.mode = distribution.kind == InputKind::IOTA ? 1 : (distribution.kind == InputKind::UNIFORM ? 2 : 3);
+        pushData.count = count;
+        pushData.p0 = distribution.p0;
+        pushData.p1 = distribution.p1;
+        pushData.seed = distribution.seed;
+
+        uint32_t groups = std::min((count + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, MAX_GROUPS);
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline);
+        vkCmdPushConstants(commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                           sizeof(GeneratePushData), &pushData);
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout, 0, 1,
+                                &t.descriptorSet, 0, nullptr);
+        vkCmdDispatch(commandBuffer, std::max(groups, 1u), 1, 1);
+        srcStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        srcAccess = VK_ACCESS_SHADER_WRITE_BIT;
+    }
+
+    // Consumers read the input, and the reductions write over it in place
+    VkBufferMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = t.buffer;
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+    vkCmdPipelineBarrier(commandBuffer, srcStage, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                         0, nullptr, 1, &barrier, 0, nullptr);
+}
+
+// --- Host Reference ---
+
+float InputGenerator::hostValue(const InputDistribution& distribution, uint32_t index) {
+    switch (distribution.kind) {
+        case InputKind::CONSTANT:
+            return distribution.p0;
+        case InputKind::IOTA:
+            return distribution.p0 + distribution.p1 * (float)index;
+        case InputKind::UNIFORM: {
+            uint32_t h1 = pcg(pcg(distribution.seed) + 2u * index);
+            float u = (float)(h1 >> 8) * INV_2_24;
+            return distribution.p0 + (distribution.p1 - distribution.p0) * u;
+        }
+        case InputKind::NORMAL: {
+            uint32_t key = pcg(distribution.seed);
+            uint32_t h1 = pcg(key + 2u * index);
+            uint32_t h2 = pcg(key + 2u * index + 1u);
+            float u1 = (float)((h1 >> 8) + 1u) * INV_2_24;
+            float u2 = (float)(h2 >> 8) * INV_2_24;
+            return distribution.p0 + distribution.p1 * std::sqrt(-2.0f * std::log(u1)) * std::cos(6.28318530718f * u2);
+        }
+    }
+    return 0.0f;
+}
+
+void InputGenerator::hostFill(const InputDistribution& distribution, float* data, uint32_t count) {
+    if (distribution.kind == InputKind::CONSTANT) {
+        std::fill(data, data + count, distribution.p0);
+        return;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        data[i] = hostValue(distribution, i);
+    }
+}
+
+void InputGenerator::hostReference(const InputDistribution& distribution, uint32_t count,
+                                   double& sum, double& absSum) {
+    if (distribution.kind == InputKind::CONSTANT) {
+        sum = (double)distribution.p0 * count;
+        absSum = std::fabs(sum);
+        return;
+    }
+    sum = 0.0;
+    absSum = 0.0;
+    for (uint32_t i = 0; i < count; i++) {
+        double value = hostValue(distribution, i);
+        sum += value;
+        absSum += std::fabs(value);
+    }
+}
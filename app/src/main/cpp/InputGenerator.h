@@ -0,0 +1,89 @@
+#pragma once
+
+#include "VulkanContext.h"
+#include <vector>
+
+// What a benchmark input is filled with
+enum class InputKind {
+    CONSTANT, // p0 everywhere (vkCmdFillBuffer)
+    IOTA,     // p0 + p1 * i
+    UNIFORM,  // [p0, p1)
+    NORMAL    // mean p0, standard deviation p1
+};
+
+struct InputDistribution {
+    InputKind kind = InputKind::CONSTANT;
+    float p0 = 1.0f;
+    float p1 = 0.0f;
+    uint32_t seed = 0; // UNIFORM / NORMAL
+
+    static InputDistribution constant(float value) { return {InputKind::CONSTANT, value, 0.0f, 0}; }
+    static InputDistribution iota(float start, float step) { return {InputKind::IOTA, start, step, 0}; }
+    static InputDistribution uniform(float lo, float hi, uint32_t seed = 1) { return {InputKind::UNIFORM, lo, hi, seed}; }
+    static InputDistribution normal(float mean, float stddev, uint32_t seed = 1) { return {InputKind::NORMAL, mean, stddev, seed}; }
+
+    const char* getName() const;
+};
+
+// This struct MUST match the layout in generate.comp
+struct GeneratePushData {
+    uint32_t mode; // 1 = iota, 2 = uniform, 3 = normal
+    uint32_t count;
+    float p0;
+    float p1;
+    uint32_t seed;
+};
+
+// Fills device buffers on the GPU instead of writing them from the host.
+//
+// Constant fills are a vkCmdFillBuffer (the buffer needs TRANSFER_DST usage);
+// iota and the random distributions run generate.comp, a counter-based PCG
+// hash, so element i only depends on (seed, i). The host* functions compute
+// the same values on the CPU for reference results.
+//
+// Owned by a task: init() with the task's shader loader, register each
+// target buffer once with addTarget(), then record() into any command buffer.
+class InputGenerator {
+public:
+    static constexpr const char* SHADER_PATH = "shaders/generate.spv";
+
+    InputGenerator() = default;
+
+    // Takes ownership of 'shaderModule' (destroyed once the pipeline exists)
+    void init(VulkanContext* context, VkShaderModule shaderModule);
+    void cleanup();
+
+    // Returns the target index for record()
+    uint32_t addTarget(VkBuffer buffer);
+    // Points a target at another buffer (e.g. after the owner re-allocated it)
+    void setTarget(uint32_t target, VkBuffer buffer);
+
+    // Writes 'count' floats at the start of the target, then a barrier that
+    // makes them visible to compute-shader reads and writes
+    void record(VkCommandBuffer commandBuffer, uint32_t target, uint32_t count,
+                const InputDistribution& distribution) const;
+
+    // --- Host reference (same formulas and float math as generate.comp) ---
+    static float hostValue(const InputDistribution& distribution, uint32_t index);
+    static void hostFill(const InputDistribution& distribution, float* data, uint32_t count);
+    // Double-precision sum and sum of magnitudes of the first 'count' values
+    static void hostReference(const InputDistribution& distribution, uint32_t count,
+                              double& sum, double& absSum);
+
+private:
+    struct Target {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+    };
+
+    VulkanContext* m_context = nullptr;
+    VkDescriptorSetLayout m_descriptorSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool m_descriptorPool = VK_NULL_HANDLE;
+    VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline m_pipeline = VK_NULL_HANDLE;
+    std::vector<Target> m_targets;
+
+    static const uint32_t MAX_TARGETS = 8;
+    static const uint32_t WORKGROUP_SIZE = 256;
+    static constexpr uint32_t MAX_GROUPS = 1024; // The shader loops over the rest
+};
@@ -143,8 +143,6 @@ void LocalReduceTask::createDescriptorSet() {
 
 long long LocalReduceTask::dispatch() {
     VkDevice device = m_context->getDevice();
-    VkCommandPool commandPool = m_context->getCommandPool();
-    VkQueue queue = m_context->getQueue();
 
     // --- 1. Create Staging Buffer (for readback) ---
     VkBuffer stagingBuffer;
@@ -0,0 +1,270 @@
+#include "Log.h"
+#ifdef __ANDROID__
+#include <android/log.h>
+#endif
+#include <pthread.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <ctime>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+const size_t RING_SLOTS = 1024;           // Power of two
+const size_t SLOT_CHARS = 240;
+const size_t MAX_SLOTS_PER_MESSAGE = 64;  // Longer messages are truncated (~15 KB)
+const size_t LOGCAT_MAX_CHARS = 4000;     // logd truncates longer entries
+const auto IDLE_WAIT = std::chrono::milliseconds(50);
+
+// A message takes one or more consecutive slots; the first one carries the header
+struct Slot {
+    std::atomic<uint64_t> sequence{0}; // == position: free; == position + 1: published
+    int level = 0;
+    uint32_t length = 0;               // Of the whole message (first slot only)
+    int64_t timeNs = 0;                // system_clock (first slot only)
+    char text[SLOT_CHARS];
+};
+
+struct LogState {
+    // --- Ring: any thread pushes, the drain thread pops ---
+    Slot slots[RING_SLOTS];
+    std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<bool> sleeping{false};
+
+    // --- Drain side, guarded by mutex ---
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable drained;
+    uint64_t tail = 0;
+    uint64_t reportedDropped = 0;
+    bool flushRequested = false;
+#ifdef __ANDROID__
+    uint32_t backends = LOG_TO_LOGCAT;
+#else
+    uint32_t backends = LOG_TO_STDERR; // Desktop builds have no logcat
+#endif
+    FILE* file = nullptr;
+
+    LogState() {
+        for (size_t i = 0; i < RING_SLOTS; i++) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        std::thread(&LogState::run, this).detach();
+    }
+
+    // Claims 'count' consecutive slots, or returns false if the ring is full
+    bool claim(size_t count, uint64_t& position) {
+        position = head.load(std::memory_order_relaxed);
+        for (;;) {
+            // The drain thread frees slots in order, so if the last one is free they all are
+            uint64_t last = position + count - 1;
+            int64_t diff = (int64_t)slots[last % RING_SLOTS].sequence.load(std::memory_order_acquire) - (int64_t)last;
+            if (diff == 0) {
+                if (head.compare_exchange_weak(position, position + count, std::memory_order_relaxed)) return true;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                position = head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void push(int level, const char* text, size_t length) {
+        length = std::min(length, MAX_SLOTS_PER_MESSAGE * SLOT_CHARS);
+        size_t count = std::max<size_t>(1, (length + SLOT_CHARS - 1) / SLOT_CHARS);
+        uint64_t position = 0;
+        if (!claim(count, position)) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        Slot& first = slots[position % RING_SLOTS];
+        first.level = level;
+        first.length = (uint32_t)length;
+        first.timeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+        for (size_t i = 0; i < count; i++) {
+            Slot& slot = slots[(position + i) % RING_SLOTS];
+            size_t offset = i * SLOT_CHARS;
+            std::copy(text + offset, text + std::min(length, offset + SLOT_CHARS), slot.text);
+            // Continuations first: the drain thread reads the whole message once the first slot is published
+            if (i > 0) slot.sequence.store(position + i + 1, std::memory_order_release);
+        }
+        first.sequence.store(position + 1, std::memory_order_seq_cst);
+
+        // Only an idle drain thread needs waking; a lost wake-up costs at most IDLE_WAIT
+        if (sleeping.load(std::memory_order_seq_cst)) wake.notify_one();
+    }
+
+    bool hasPublished() const {
+        return slots[tail % RING_SLOTS].sequence.load(std::memory_order_seq_cst) == tail + 1;
+    }
+
+    // --- Drain thread ---
+
+    void run() {
+        pthread_setname_np(pthread_self(), "GpuComputeLog");
+        std::unique_lock<std::mutex> lock(mutex);
+        std::string message;
+        for (;;) {
+            while (hasPublished()) {
+                Slot& first = slots[tail % RING_SLOTS];
+                size_t count = std::max<size_t>(1, (first.length + SLOT_CHARS - 1) / SLOT_CHARS);
+                message.clear();
+                for (size_t i = 0; i < count; i++) {
+                    Slot& slot = slots[(tail + i) % RING_SLOTS];
+                    message.append(slot.text, std::min<size_t>(SLOT_CHARS, first.length - i * SLOT_CHARS));
+                }
+                int level = first.level;
+                int64_t timeNs = first.timeNs;
+                for (size_t i = 0; i < count; i++) {
+                    slots[(tail + i) % RING_SLOTS].sequence.store(tail + i + RING_SLOTS, std::memory_order_release);
+                }
+                tail += count;
+                emit(level, timeNs, message);
+            }
+            uint64_t droppedNow = dropped.load(std::memory_order_relaxed);
+            if (droppedNow != reportedDropped) {
+                std::string warning = "Logger: ring full, " + std::to_string(droppedNow - reportedDropped) +
+                                      " message(s) dropped";
+                reportedDropped = droppedNow;
+                emit(GPUCOMPUTE_LOG_LEVEL_WARN, 0, warning);
+            }
+            if (file != nullptr) fflush(file);
+            flushRequested = false;
+            drained.notify_all();
+
+            sleeping.store(true, std::memory_order_seq_cst);
+            wake.wait_for(lock, IDLE_WAIT, [this] { return hasPublished() || flushRequested; });
+            sleeping.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    void emit(int level, int64_t timeNs, const std::string& message) {
+        if (backends & LOG_TO_LOGCAT) writeLogcat(level, message);
+        if (!(backends & (LOG_TO_STDERR | LOG_TO_FILE))) return;
+
+        // "HH:MM:SS.mmm L message"
+        if (timeNs == 0) {
+            timeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+        time_t seconds = (time_t)(timeNs / 1000000000);
+        struct tm local {};
+        localtime_r(&seconds, &local);
+        char prefix[32];
+        snprintf(prefix, sizeof(prefix), "%02d:%02d:%02d.%03d %c", local.tm_hour, local.tm_min, local.tm_sec,
+                 (int)(timeNs / 1000000 % 1000), "DIWE"[std::min(std::max(level, 0), 3)]);
+        if (backends & LOG_TO_STDERR) fprintf(stderr, "%s %s\n", prefix, message.c_str());
+        if ((backends & LOG_TO_FILE) && file != nullptr) fprintf(file, "%s %s\n", prefix, message.c_str());
+    }
+
+    static void writeLogcat(int level, const std::string& message) {
+#ifndef __ANDROID__
+        (void)level;
+        (void)message;
+#else
+        static const int priorities[] = {ANDROID_LOG_DEBUG, ANDROID_LOG_INFO, ANDROID_LOG_WARN, ANDROID_LOG_ERROR};
+        int priority = priorities[std::min(std::max(level, 0), 3)];
+        if (message.size() <= LOGCAT_MAX_CHARS) {
+            __android_log_write(priority, LOG_TAG, message.c_str());
+            return;
+        }
+        // Long tables: split at line ends so logd keeps all of it
+        size_t begin = 0;
+        while (begin < message.size()) {
+            size_t end = std::min(message.size(), begin + LOGCAT_MAX_CHARS);
+            if (end < message.size()) {
+                size_t newline = message.rfind('\n', end);
+                if (newline != std::string::npos && newline > begin) end = newline + 1;
+            }
+            __android_log_write(priority, LOG_TAG, message.substr(begin, end - begin).c_str());
+            begin = end;
+        }
+#endif
+    }
+};
+
+LogState& state() {
+    static LogState* s = new LogState(); // Never destroyed: the drain thread outlives static destruction
+    return *s;
+}
+
+} // namespace
+
+void Logger::write(int level, const char* format, ...) {
+    char inlineText[MAX_INLINE_CHARS];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(inlineText, sizeof(inlineText), format, args);
+    va_end(args);
+    if (length < 0) return;
+    if ((size_t)length < sizeof(inlineText)) {
+        state().push(level, inlineText, (size_t)length);
+        return;
+    }
+
+    // Too long for the stack buffer: format again into the heap
+    std::string text(length + 1, '\0');
+    va_start(args, format);
+    vsnprintf(&text[0], text.size(), format, args);
+    va_end(args);
+    state().push(level, text.c_str(), (size_t)length);
+}
+
+// --- Backends ---
+
+void Logger::setBackends(uint32_t backends) {
+    LogState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.backends = backends;
+}
+
+uint32_t Logger::getBackends() {
+    LogState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.backends;
+}
+
+bool Logger::openFile(const std::string& path) {
+    FILE* file = fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        LOGW("Logger: cannot open %s", path.c_str());
+        return false;
+    }
+    LogState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (s.file != nullptr) fclose(s.file);
+    s.file = file;
+    s.backends |= LOG_TO_FILE;
+    return true;
+}
+
+void Logger::closeFile() {
+    LogState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (s.file != nullptr) fclose(s.file);
+    s.file = nullptr;
+    s.backends &= ~(uint32_t)LOG_TO_FILE;
+}
+
+// --- Draining ---
+
+void Logger::flush() {
+    LogState& s = state();
+    uint64_t target = s.head.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(s.mutex);
+    s.flushRequested = true;
+    s.wake.notify_one();
+    s.drained.wait(lock, [&s, target] { return s.tail >= target; });
+}
+
+uint64_t Logger::getDroppedCount() {
+    return state().dropped.load(std::memory_order_relaxed);
+}
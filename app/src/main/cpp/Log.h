@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#define LOG_TAG "GpuCompute"
+
+// Compile-time log levels: calls below GPUCOMPUTE_LOG_LEVEL are compiled out
+// (arguments are still type-checked, never evaluated)
+#define GPUCOMPUTE_LOG_LEVEL_DEBUG 0
+#define GPUCOMPUTE_LOG_LEVEL_INFO 1
+#define GPUCOMPUTE_LOG_LEVEL_WARN 2
+#define GPUCOMPUTE_LOG_LEVEL_ERROR 3
+#define GPUCOMPUTE_LOG_LEVEL_NONE 4
+
+#ifndef GPUCOMPUTE_LOG_LEVEL
+#define GPUCOMPUTE_LOG_LEVEL GPUCOMPUTE_LOG_LEVEL_INFO
+#endif
+
+// Where the drained messages go; any combination
+enum LogBackend : uint32_t {
+    LOG_TO_LOGCAT = 1,
+    LOG_TO_STDERR = 2,
+    LOG_TO_FILE = 4
+};
+
+// Non-blocking logging for code that is being timed.
+//
+// write() formats the message on the calling thread and copies it into a
+// fixed-size lock-free ring; a background thread drains the ring into the
+// backends. The calling thread never calls the system logger, takes no lock
+// and does not allocate unless the message is longer than MAX_INLINE_CHARS.
+// A full ring drops the message (counted, and reported by the drain thread)
+// rather than blocking the caller. Messages are written in the order their
+// ring slots were claimed.
+class Logger {
+public:
+    static const size_t MAX_INLINE_CHARS = 512;
+
+    static void write(int level, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+    // --- Backends (logcat only by default; stderr only off Android) ---
+    static void setBackends(uint32_t backends);
+    static uint32_t getBackends();
+    // Truncates 'path' and adds LOG_TO_FILE; returns false if it cannot be opened
+    static bool openFile(const std::string& path);
+    static void closeFile();
+
+    // Blocks until every message written before the call has reached the backends
+    static void flush();
+    static uint64_t getDroppedCount();
+};
+
+#define LOG_AT(level, ...) \
+    do { \
+        if (GPUCOMPUTE_LOG_LEVEL <= (level)) Logger::write(level, __VA_ARGS__); \
+    } while (0)
+
+#define LOGD(...) LOG_AT(GPUCOMPUTE_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define LOGI(...) LOG_AT(GPUCOMPUTE_LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOGW(...) LOG_AT(GPUCOMPUTE_LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOGE(...) LOG_AT(GPUCOMPUTE_LOG_LEVEL_ERROR, __VA_ARGS__)
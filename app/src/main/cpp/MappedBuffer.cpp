@@ -0,0 +1,218 @@
+#include "MappedBuffer.h"
+#include <stdexcept>
+#include <algorithm>
+
+void MappedBuffer::create(VulkanContext* context, VkDeviceSize size, VkBufferUsageFlags usage,
+                          MemoryUsage memoryUsage) {
+    if (memoryUsage == MemoryUsage::GPU_ONLY) {
+        throw std::runtime_error("MappedBuffer needs a host-visible memory usage!");
+    }
+    m_context = context;
+    m_size = size;
+    VkDevice device = m_context->getDevice();
+
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = size;
+    bufferInfo.usage = usage;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateBuffer(device, &bufferInfo, nullptr, &m_buffer) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create mapped buffer!");
+    }
+
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(device, m_buffer, &memRequirements);
+
+    uint32_t memoryTypeIndex = m_context->selectMemoryType(memRequirements.memoryTypeBits, memoryUsage);
+    m_memoryFlags = m_context->getMemoryTypeFlags(memoryTypeIndex);
+    m_allocationSize = memRequirements.size;
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = memRequirements.size;
+    allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+    if (vkAllocateMemory(device, &allocInfo, nullptr, &m_memory) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate mapped buffer memory!");
+    }
+    vkBindBufferMemory(device, m_buffer, m_memory, 0);
+
+    // Mapped once, unmapped in destroy()
+    if (vkMapMemory(device, m_memory, 0, VK_WHOLE_SIZE, 0, &m_mapped) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to map buffer memory!");
+    }
+}
+
+void MappedBuffer::destroy() {
+    if (m_context == nullptr) return;
+    VkDevice device = m_context->getDevice();
+    if (m_mapped != nullptr) vkUnmapMemory(device, m_memory);
+    if (m_buffer != VK_NULL_HANDLE) vkDestroyBuffer(device, m_buffer, nullptr);
+    if (m_memory != VK_NULL_HANDLE) vkFreeMemory(device, m_memory, nullptr);
+    m_mapped = nullptr;
+    m_buffer = VK_NULL_HANDLE;
+    m_memory = VK_NULL_HANDLE;
+    m_size = 0;
+    m_allocationSize = 0;
+}
+
+VkMappedMemoryRange MappedBuffer::makeRange(VkDeviceSize offset, VkDeviceSize size) const {
+    VkDeviceSize atom = m_context->getNonCoherentAtomSize();
+
+    VkMappedMemoryRange range{};
+    range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+    range.memory = m_memory;
+    range.offset = (offset / atom) * atom;
+    if (size == VK_WHOLE_SIZE) {
+        range.size = VK_WHOLE_SIZE;
+    } else {
+        // Round the end up to the atom size, but never past the allocation
+        VkDeviceSize end = ((offset + size + atom - 1) / atom) * atom;
+        end = std::min(end, m_allocationSize);
+        range.size = end - range.offset;
+    }
+    return range;
+}
+
+void MappedBuffer::flush(VkDeviceSize offset, VkDeviceSize size) const {
+    if (isCoherent()) return;
+    VkMappedMemoryRange range = makeRange(offset, size);
+    vkFlushMappedMemoryRanges(m_context->getDevice(), 1, &range);
+}
+
+void MappedBuffer::invalidate(VkDeviceSize offset, VkDeviceSize size) const {
+    if (isCoherent()) return;
+    VkMappedMemoryRange range = makeRange(offset, size);
+    vkInvalidateMappedMemoryRanges(m_context->getDevice(), 1, &range);
+}
+
+// --- UploadBuffer ---
+
+void UploadBuffer::create(VulkanContext* context, VkDeviceSize size, VkBufferUsageFlags usage) {
+    m_context = context;
+    m_size = size;
+    m_direct = m_context->isUnifiedMemory();
+
+    if (m_direct) {
+        // The GPU reads the host's writes in place
+        m_host.create(m_context, size, usage, MemoryUsage::STREAMING);
+        return;
+    }
+
+    // Discrete: persistent staging buffer + device-local copy
+    m_host.create(m_context, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, MemoryUsage::UPLOAD);
+
+    VkDevice device = m_context->getDevice();
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = size;
+    bufferInfo.usage = usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if (vkCreateBuffer(device, &bufferInfo, nullptr, &m_deviceBuffer) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create device-local input buffer!");
+    }
+
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(device, m_deviceBuffer, &memRequirements);
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = memRequirements.size;
+    allocInfo.memoryTypeIndex = m_context->selectMemoryType(memRequirements.memoryTypeBits, MemoryUsage::GPU_ONLY);
+    if (vkAllocateMemory(device, &allocInfo, nullptr, &m_deviceMemory) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate device-local input memory!");
+    }
+    vkBindBufferMemory(device, m_deviceBuffer, m_deviceMemory, 0);
+}
+
+void UploadBuffer::destroy() {
+    if (m_context == nullptr) return;
+    VkDevice device = m_context->getDevice();
+    m_host.destroy();
+    if (m_deviceBuffer != VK_NULL_HANDLE) vkDestroyBuffer(device, m_deviceBuffer, nullptr);
+    if (m_deviceMemory != VK_NULL_HANDLE) vkFreeMemory(device, m_deviceMemory, nullptr);
+    m_deviceBuffer = VK_NULL_HANDLE;
+    m_deviceMemory = VK_NULL_HANDLE;
+    m_size = 0;
+}
+
+void UploadBuffer::recordUpload(VkCommandBuffer commandBuffer, VkDeviceSize size) const {
+    if (m_direct) return;
+
+    VkBufferCopy copyRegion{};
+    copyRegion.size = (size == VK_WHOLE_SIZE) ? m_size : std::min(size, m_size);
+    vkCmdCopyBuffer(commandBuffer, m_host.getBuffer(), m_deviceBuffer, 1, &copyRegion);
+
+    // The copy must land before any compute pass reads (or overwrites) the buffer
+    VkBufferMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = m_deviceBuffer;
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 0, nullptr, 1, &barrier, 0, nullptr);
+}
+
+void UploadBuffer::recordTransferUpload(VkCommandBuffer transferCommandBuffer) const {
+    if (m_direct) return;
+
+    // The whole buffer is overwritten, so the transfer family can take it without an acquire
+    VkBufferCopy copyRegion{};
+    copyRegion.size = m_size;
+    vkCmdCopyBuffer(transferCommandBuffer, m_host.getBuffer(), m_deviceBuffer, 1, &copyRegion);
+
+    VkBufferMemoryBarrier release = makeOwnershipBarrier();
+    release.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(transferCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                         0, 0, nullptr, 1, &release, 0, nullptr);
+}
+
+void UploadBuffer::recordAcquire(VkCommandBuffer computeCommandBuffer) const {
+    if (m_direct) return;
+
+    VkBufferMemoryBarrier acquire = makeOwnershipBarrier();
+    acquire.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(computeCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 0, nullptr, 1, &acquire, 0, nullptr);
+}
+
+VkBufferMemoryBarrier UploadBuffer::makeOwnershipBarrier() const {
+    // Release and acquire must name the same families and range
+    VkBufferMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcQueueFamilyIndex = m_context->getTransferQueueFamilyIndex();
+    barrier.dstQueueFamilyIndex = m_context->getComputeQueueFamilyIndex();
+    barrier.buffer = m_deviceBuffer;
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+    return barrier;
+}
+
+// --- MappedRangeBatch ---
+
+void MappedRangeBatch::addFlush(const MappedBuffer& buffer, VkDeviceSize offset, VkDeviceSize size) {
+    if (buffer.isCoherent()) return;
+    m_flushRanges.push_back(buffer.makeRange(offset, size));
+}
+
+void MappedRangeBatch::addInvalidate(const MappedBuffer& buffer, VkDeviceSize offset, VkDeviceSize size) {
+    if (buffer.isCoherent()) return;
+    m_invalidateRanges.push_back(buffer.makeRange(offset, size));
+}
+
+void MappedRangeBatch::submit() {
+    VkDevice device = m_context->getDevice();
+    if (!m_flushRanges.empty()) {
+        vkFlushMappedMemoryRanges(device, static_cast<uint32_t>(m_flushRanges.size()), m_flushRanges.data());
+        m_flushRanges.clear();
+    }
+    if (!m_invalidateRanges.empty()) {
+        vkInvalidateMappedMemoryRanges(device, static_cast<uint32_t>(m_invalidateRanges.size()), m_invalidateRanges.data());
+        m_invalidateRanges.clear();
+    }
+}
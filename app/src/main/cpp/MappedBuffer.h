@@ -0,0 +1,109 @@
+#pragma once
+
+#include "VulkanContext.h"
+#include <vector>
+
+// A host-visible VkBuffer that stays mapped for its whole lifetime.
+//
+// Works with coherent and non-coherent memory: on non-coherent types the
+// caller must flush() after host writes and invalidate() before host reads.
+// Both are no-ops on HOST_COHERENT memory, so callers can always make them.
+class MappedBuffer {
+public:
+    MappedBuffer() = default;
+
+    // 'memoryUsage' must be a host-visible usage (UPLOAD, READBACK or STREAMING)
+    void create(VulkanContext* context, VkDeviceSize size, VkBufferUsageFlags usage,
+                MemoryUsage memoryUsage);
+    void destroy();
+
+    // Host writes -> device (no-op on coherent memory)
+    void flush(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE) const;
+    // Device writes -> host (no-op on coherent memory)
+    void invalidate(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE) const;
+
+    // Range expanded to nonCoherentAtomSize, as vkFlush/InvalidateMappedMemoryRanges require
+    VkMappedMemoryRange makeRange(VkDeviceSize offset, VkDeviceSize size) const;
+
+    // --- Getters ---
+    VkBuffer getBuffer() const { return m_buffer; }
+    VkDeviceMemory getMemory() const { return m_memory; }
+    VkDeviceSize getSize() const { return m_size; }
+    VkDeviceSize getAllocationSize() const { return m_allocationSize; }
+    void* getMapped() const { return m_mapped; }
+    template <typename T> T* data() const { return static_cast<T*>(m_mapped); }
+    VkMemoryPropertyFlags getMemoryFlags() const { return m_memoryFlags; }
+    bool isCoherent() const { return (m_memoryFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0; }
+    bool isCached() const { return (m_memoryFlags & VK_MEMORY_PROPERTY_HOST_CACHED_BIT) != 0; }
+    bool isValid() const { return m_buffer != VK_NULL_HANDLE; }
+
+private:
+    VulkanContext* m_context = nullptr;
+    VkBuffer m_buffer = VK_NULL_HANDLE;
+    VkDeviceMemory m_memory = VK_NULL_HANDLE;
+    VkDeviceSize m_size = 0;           // Requested size
+    VkDeviceSize m_allocationSize = 0; // Actual allocation (>= m_size)
+    VkMemoryPropertyFlags m_memoryFlags = 0;
+    void* m_mapped = nullptr;
+};
+
+// An input the host fills and the GPU reads, placed according to the memory model.
+//
+// Unified memory: a single STREAMING buffer that the host writes in place.
+// Discrete memory: a GPU_ONLY buffer fed from a persistent UPLOAD staging
+// buffer; recordUpload() records the copy at the start of a command buffer.
+// Callers write through data(), flush(), and always call recordUpload().
+class UploadBuffer {
+public:
+    UploadBuffer() = default;
+
+    void create(VulkanContext* context, VkDeviceSize size, VkBufferUsageFlags usage);
+    void destroy();
+
+    template <typename T> T* data() const { return m_host.data<T>(); }
+    void flush(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE) const { m_host.flush(offset, size); }
+
+    // Staging -> device copy + barrier for compute reads (no-op when direct)
+    void recordUpload(VkCommandBuffer commandBuffer, VkDeviceSize size = VK_WHOLE_SIZE) const;
+    // The same copy split across queues (dedicated transfer queue only):
+    // copy + release on the transfer queue, acquire on the compute queue.
+    // The compute submit must wait on a semaphore signaled by the transfer submit.
+    void recordTransferUpload(VkCommandBuffer transferCommandBuffer) const;
+    void recordAcquire(VkCommandBuffer computeCommandBuffer) const;
+
+    // The buffer shaders should bind
+    VkBuffer getBuffer() const { return m_direct ? m_host.getBuffer() : m_deviceBuffer; }
+    // Host side: the buffer itself when direct, the staging buffer otherwise
+    const MappedBuffer& getHostBuffer() const { return m_host; }
+    VkDeviceSize getSize() const { return m_size; }
+    bool isDirect() const { return m_direct; }
+
+private:
+    VkBufferMemoryBarrier makeOwnershipBarrier() const;
+
+    VulkanContext* m_context = nullptr;
+    MappedBuffer m_host;
+    VkBuffer m_deviceBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory m_deviceMemory = VK_NULL_HANDLE;
+    VkDeviceSize m_size = 0;
+    bool m_direct = true;
+};
+
+// Collects flush/invalidate ranges from several buffers so a whole
+// iteration costs one vkFlushMappedMemoryRanges and one
+// vkInvalidateMappedMemoryRanges call. Coherent buffers are skipped.
+class MappedRangeBatch {
+public:
+    explicit MappedRangeBatch(VulkanContext* context) : m_context(context) {}
+
+    void addFlush(const MappedBuffer& buffer, VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+    void addInvalidate(const MappedBuffer& buffer, VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+
+    // Issues the pending flushes, then the pending invalidates, and clears the batch
+    void submit();
+
+private:
+    VulkanContext* m_context;
+    std::vector<VkMappedMemoryRange> m_flushRanges;
+    std::vector<VkMappedMemoryRange> m_invalidateRanges;
+};
@@ -0,0 +1,620 @@
+#include "OutOfCoreReduceTask.h"
+#include "GpuOptimizedReduceTask.h" // PushData
+#include <vector>
+#include <stdexcept>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+OutOfCoreReduceTask::OutOfCoreReduceTask(AAssetManager* assetManager, const std::string& path,
+                                         uint32_t chunkElements, uint32_t slotCount)
+        : BaseComputeTask(assetManager), m_path(path), m_chunkElements(chunkElements), m_slotCount(slotCount) {
+    if (m_chunkElements == 0) {
+        throw std::runtime_error("OutOfCoreReduceTask needs a chunk size > 0!");
+    }
+    m_slotCount = std::max(2u, std::min(m_slotCount, MAX_SLOTS));
+    m_gpuTimestampPeriod = m_context->getTimeStampPeriod();
+    LOGI("OutOfCoreReduceTask created. File=%s, Chunk=%u elements, Slots=%u",
+         m_path.c_str(), m_chunkElements, m_slotCount);
+}
+
+OutOfCoreReduceTask::~OutOfCoreReduceTask() {
+    LOGI("OutOfCoreReduceTask destroyed");
+}
+
+void OutOfCoreReduceTask::setReference(double sum, double absSum) {
+    m_expected = sum;
+    // Float chunk sums in a different order: allow a relative error on the magnitudes
+    m_tolerance = std::max(0.01, 1e-4 * absSum);
+}
+
+// --- Overridden init() ---
+void OutOfCoreReduceTask::init() {
+    LOGI("OutOfCoreReduceTask::init() starting...");
+
+    m_fd = open(m_path.c_str(), O_RDONLY);
+    if (m_fd < 0) {
+        LOGE("Cannot open %s: %s", m_path.c_str(), strerror(errno));
+        throw std::runtime_error("Failed to open input file!");
+    }
+    struct stat fileInfo{};
+    if (fstat(m_fd, &fileInfo) != 0 || fileInfo.st_size < (off_t)sizeof(float)) {
+        throw std::runtime_error("Input file is empty or unreadable!");
+    }
+    m_elements = (uint64_t)fileInfo.st_size / sizeof(float);
+    if ((uint64_t)fileInfo.st_size % sizeof(float) != 0) {
+        LOGW("%s: ignoring %u trailing bytes", m_path.c_str(), (unsigned)(fileInfo.st_size % sizeof(float)));
+    }
+    // Small files do not need full-size slots
+    m_chunkElements = (uint32_t)std::min<uint64_t>(m_chunkElements, m_elements);
+
+    VkDevice device = m_context->getDevice();
+    m_slots.resize(m_slotCount);
+
+    // Staged inputs are copied on the transfer queue when the device has a dedicated one
+    m_transferUploads = m_context->hasDedicatedTransferQueue() && !m_context->isUnifiedMemory();
+    if (m_transferUploads && m_gpuTimestampPeriod > 0) {
+        uint32_t familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(m_context->getPhysicalDevice(), &familyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(m_context->getPhysicalDevice(), &familyCount, families.data());
+        m_transferTimestamps = families[m_context->getTransferQueueFamilyIndex()].timestampValidBits > 0;
+    }
+
+    createBuffers();
+    createDescriptorSetLayout();
+    createDescriptorPool();
+    createDescriptorSet();
+
+    createPipelineLayout(sizeof(PushData));
+    m_pipeline = createComputePipeline(getShaderPath());
+
+    // Task-owned pools: the pre-recorded buffers outlive any one calling thread
+    VkCommandPoolCreateInfo commandPoolInfo{};
+    commandPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    commandPoolInfo.queueFamilyIndex = m_context->getComputeQueueFamilyIndex();
+    if (vkCreateCommandPool(device, &commandPoolInfo, nullptr, &m_commandPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create out-of-core command pool!");
+    }
+    if (m_transferUploads) {
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.queueFamilyIndex = m_context->getTransferQueueFamilyIndex();
+        if (vkCreateCommandPool(device, &poolInfo, nullptr, &m_transferPool) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create transfer command pool!");
+        }
+    }
+
+    VkQueryPoolCreateInfo queryPoolInfo{};
+    queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+
+    for (Slot& slot : m_slots) {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = m_commandPool;
+        allocInfo.commandBufferCount = 2;
+        if (vkAllocateCommandBuffers(device, &allocInfo, slot.commandBuffers) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to allocate slot command buffers!");
+        }
+
+        if (m_gpuTimestampPeriod > 0) {
+            queryPoolInfo.queryCount = 3;
+            if (vkCreateQueryPool(device, &queryPoolInfo, nullptr, &slot.queryPool) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to create slot query pool!");
+            }
+        }
+
+        if (m_transferUploads) {
+            allocInfo.commandPool = m_transferPool;
+            if (vkAllocateCommandBuffers(device, &allocInfo, slot.uploadCommandBuffers) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to allocate slot upload command buffers!");
+            }
+            VkSemaphoreCreateInfo semaphoreInfo{};
+            semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+            if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &slot.uploadDone) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to create slot upload semaphore!");
+            }
+            if (m_transferTimestamps) {
+                queryPoolInfo.queryCount = 2;
+                for (VkQueryPool& pool : slot.uploadQueryPools) {
+                    if (vkCreateQueryPool(device, &queryPoolInfo, nullptr, &pool) != VK_SUCCESS) {
+                        throw std::runtime_error("Failed to create slot upload query pool!");
+                    }
+                }
+            }
+        }
+
+        recordSlot(slot, 0);
+        recordSlot(slot, 1);
+    }
+
+    if (m_transferTimestamps) {
+        // Upload pools start out reset; from then on each compute buffer resets the next one
+        VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+        for (Slot& slot : m_slots) {
+            for (VkQueryPool pool : slot.uploadQueryPools) {
+                vkCmdResetQueryPool(commandBuffer, pool, 0, 2);
+            }
+        }
+        endSingleTimeCommands(commandBuffer);
+    }
+
+    LOGI("OutOfCoreReduceTask::init() finished. %llu elements, %s uploads",
+         (unsigned long long)m_elements,
+         m_context->isUnifiedMemory() ? "no" : (m_transferUploads ? "transfer-queue" : "inline"));
+}
+
+void OutOfCoreReduceTask::cleanup() {
+    LOGI("OutOfCoreReduceTask::cleanup()");
+    for (Slot& slot : m_slots) {
+        if (slot.state == SlotState::IN_FLIGHT) {
+            slot.ticket.wait();
+            slot.state = SlotState::FREE;
+        }
+    }
+    cleanupSlots();
+
+    if (m_fd >= 0) {
+        close(m_fd);
+        m_fd = -1;
+    }
+
+    BaseComputeTask::cleanup();
+}
+
+void OutOfCoreReduceTask::cleanupSlots() {
+    VkDevice device = m_context->getDevice();
+    for (Slot& slot : m_slots) {
+        if (slot.uploadDone != VK_NULL_HANDLE) vkDestroySemaphore(device, slot.uploadDone, nullptr);
+        if (slot.queryPool != VK_NULL_HANDLE) vkDestroyQueryPool(device, slot.queryPool, nullptr);
+        for (VkQueryPool pool : slot.uploadQueryPools) {
+            if (pool != VK_NULL_HANDLE) vkDestroyQueryPool(device, pool, nullptr);
+        }
+        slot.input.destroy();
+        slot.partials.destroy();
+    }
+    // Descriptor sets go away with the pool in BaseComputeTask::cleanup()
+    m_slots.clear();
+
+    // Destroying the pools frees the slots' command buffers
+    if (m_commandPool != VK_NULL_HANDLE) {
+        vkDestroyCommandPool(device, m_commandPool, nullptr);
+        m_commandPool = VK_NULL_HANDLE;
+    }
+    if (m_transferPool != VK_NULL_HANDLE) {
+        vkDestroyCommandPool(device, m_transferPool, nullptr);
+        m_transferPool = VK_NULL_HANDLE;
+    }
+}
+
+// --- "Fill-in-the-blank" Implementations ---
+
+std::string OutOfCoreReduceTask::getShaderPath() {
+    return "shaders/reduce_optimized.spv";
+}
+
+void OutOfCoreReduceTask::createDescriptorSetLayout() {
+    // Same layout as GpuOptimizedReduceTask: 0 = in, 1 = out
+    std::vector<VkDescriptorSetLayoutBinding> bindings(2);
+    for (uint32_t i = 0; i < bindings.size(); i++) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+    if (vkCreateDescriptorSetLayout(m_context->getDevice(), &layoutInfo, nullptr, &m_descriptorSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create descriptor set layout!");
+    }
+}
+
+void OutOfCoreReduceTask::createBuffers() {
+    VkDeviceSize chunkSize = sizeof(float) * (VkDeviceSize)m_chunkElements;
+    VkDeviceSize partialsSize = sizeof(float) * ((m_chunkElements + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE);
+
+    for (Slot& slot : m_slots) {
+        // The reader writes through the persistent mapping (in place on unified memory);
+        // TRANSFER_SRC for the result copy when the sum ends up in the input
+        slot.input.create(m_context, chunkSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+        slot.partials.create(m_context, partialsSize,
+                             VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                             MemoryUsage::READBACK);
+    }
+}
+
+void OutOfCoreReduceTask::createDescriptorPool() {
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = 4 * m_slotCount;
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    poolInfo.maxSets = 2 * m_slotCount;
+    if (vkCreateDescriptorPool(m_context->getDevice(), &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create descriptor pool!");
+    }
+}
+
+void OutOfCoreReduceTask::createDescriptorSet() {
+    VkDevice device = m_context->getDevice();
+
+    for (Slot& slot : m_slots) {
+        VkDescriptorSetLayout layouts[2] = {m_descriptorSetLayout, m_descriptorSetLayout};
+        VkDescriptorSet sets[2];
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = m_descriptorPool;
+        allocInfo.descriptorSetCount = 2;
+        allocInfo.pSetLayouts = layouts;
+        if (vkAllocateDescriptorSets(device, &allocInfo, sets) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to allocate slot descriptor sets!");
+        }
+        slot.setInToPartials = sets[0];
+        slot.setPartialsToIn = sets[1];
+
+        VkDescriptorBufferInfo inputInfo{};
+        inputInfo.buffer = slot.input.getBuffer();
+        inputInfo.offset = 0;
+        inputInfo.range = VK_WHOLE_SIZE;
+        VkDescriptorBufferInfo partialsInfo{};
+        partialsInfo.buffer = slot.partials.getBuffer();
+        partialsInfo.offset = 0;
+        partialsInfo.range = VK_WHOLE_SIZE;
+
+        // in->partials: binding 0 = input, binding 1 = partials. partials->in: the reverse.
+        std::vector<VkWriteDescriptorSet> writes(4);
+        for (uint32_t i = 0; i < 4; i++) {
+            writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[i].dstSet = (i < 2) ? slot.setInToPartials : slot.setPartialsToIn;
+            writes[i].dstBinding = i % 2;
+            writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[i].descriptorCount = 1;
+        }
+        writes[0].pBufferInfo = &inputInfo;
+        writes[1].pBufferInfo = &partialsInfo;
+        writes[2].pBufferInfo = &partialsInfo;
+        writes[3].pBufferInfo = &inputInfo;
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+}
+
+// --- Slot Helpers ---
+
+void OutOfCoreReduceTask::recordSlot(Slot& slot, uint32_t parity) {
+    // No ONE_TIME_SUBMIT: these buffers are submitted once per chunk
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+
+    // --- Stage 2 on the transfer queue: copy, release to compute ---
+    if (m_transferUploads) {
+        VkCommandBuffer uploadCommands = slot.uploadCommandBuffers[parity];
+        VkQueryPool uploadPool = slot.uploadQueryPools[parity];
+        vkBeginCommandBuffer(uploadCommands, &beginInfo);
+        if (uploadPool != VK_NULL_HANDLE) {
+            vkCmdWriteTimestamp(uploadCommands, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, uploadPool, 0);
+        }
+        slot.input.recordTransferUpload(uploadCommands);
+        if (uploadPool != VK_NULL_HANDLE) {
+            vkCmdWriteTimestamp(uploadCommands, VK_PIPELINE_STAGE_TRANSFER_BIT, uploadPool, 1);
+        }
+        vkEndCommandBuffer(uploadCommands);
+    }
+
+    VkCommandBuffer commandBuffer = slot.commandBuffers[parity];
+    vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+    if (slot.queryPool != VK_NULL_HANDLE) {
+        vkCmdResetQueryPool(commandBuffer, slot.queryPool, 0, 3);
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, slot.queryPool, 0);
+    }
+    // (Host writes made before vkQueueSubmit are visible without a barrier)
+    if (m_transferUploads) {
+        slot.input.recordAcquire(commandBuffer); // Copied on the transfer queue
+    } else {
+        slot.input.recordUpload(commandBuffer);  // No-op on unified memory
+    }
+    if (slot.queryPool != VK_NULL_HANDLE) {
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, slot.queryPool, 1);
+    }
+
+    // --- Stage 3: a whole chunk every time (the reader zero-pads a short last chunk) ---
+    VkBuffer input = slot.input.getBuffer();
+    VkBuffer partials = slot.partials.getBuffer();
+    m_graph.clear();
+
+    PushData pushData{};
+    pushData.passType = 0;
+    pushData.numElements = m_chunkElements;
+    uint32_t remaining = (m_chunkElements + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+    m_graph.addDispatch("local", m_pipeline, m_pipelineLayout, slot.setInToPartials, &pushData, sizeof(PushData),
+                        remaining, {{input, GraphAccess::READ}, {partials, GraphAccess::WRITE}});
+
+    bool resultInPartials = true;
+    pushData.passType = 1;
+    while (remaining > 1) {
+        pushData.numElements = remaining;
+        remaining = (remaining + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+        VkBuffer in = resultInPartials ? partials : input;
+        VkBuffer out = resultInPartials ? input : partials;
+        m_graph.addDispatch("tree", m_pipeline, m_pipelineLayout,
+                            resultInPartials ? slot.setPartialsToIn : slot.setInToPartials, &pushData,
+                            sizeof(PushData), remaining, {{in, GraphAccess::READ}, {out, GraphAccess::WRITE}});
+        resultInPartials = !resultInPartials;
+    }
+    if (!resultInPartials) {
+        m_graph.addCopy("result-copy", input, partials, sizeof(float));
+    }
+    m_graph.addHostRead(partials);
+    m_graph.record(commandBuffer);
+
+    if (slot.queryPool != VK_NULL_HANDLE) {
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, slot.queryPool, 2);
+    }
+    // The host has read the other upload pool before this buffer can be submitted
+    if (slot.uploadQueryPools[1 - parity] != VK_NULL_HANDLE) {
+        vkCmdResetQueryPool(commandBuffer, slot.uploadQueryPools[1 - parity], 0, 2);
+    }
+
+    vkEndCommandBuffer(commandBuffer);
+}
+
+void OutOfCoreReduceTask::readerLoop(uint32_t chunkCount) {
+    const size_t chunkBytes = sizeof(float) * (size_t)m_chunkElements;
+
+    for (uint32_t c = 0; c < chunkCount; c++) {
+        Slot& slot = m_slots[c % m_slotCount];
+        {
+            std::unique_lock<std::mutex> lock(m_slotMutex);
+            m_slotChanged.wait(lock, [&]() {
+                return slot.state == SlotState::FREE || m_readFailed.load() || m_readStopped.load();
+            });
+            if (m_readFailed.load() || m_readStopped.load()) return;
+        }
+
+        // --- Stage 1: file -> mapping (the slot is ours until it is marked FILLED) ---
+        auto readStart = std::chrono::high_resolution_clock::now();
+        uint64_t first = (uint64_t)c * m_chunkElements;
+        size_t bytes = sizeof(float) * (size_t)std::min<uint64_t>(m_chunkElements, m_elements - first);
+        char* dst = slot.input.data<char>();
+        size_t done = 0;
+        while (done < bytes) {
+            ssize_t count = pread(m_fd, dst + done, bytes - done, (off_t)(first * sizeof(float) + done));
+            if (count < 0 && errno == EINTR) continue;
+            if (count <= 0) {
+                LOGE("Reading %s failed at chunk %u: %s", m_path.c_str(), c, count < 0 ? strerror(errno) : "EOF");
+                m_readFailed = true;
+                m_slotChanged.notify_all();
+                return;
+            }
+            done += (size_t)count;
+        }
+        if (bytes < chunkBytes) {
+            // Zeros add nothing, so the pre-recorded full-chunk passes stay correct
+            std::memset(dst + bytes, 0, chunkBytes - bytes);
+        }
+        slot.input.flush();
+        auto readEnd = std::chrono::high_resolution_clock::now();
+
+        {
+            std::lock_guard<std::mutex> lock(m_slotMutex);
+            slot.chunk = c;
+            slot.readUs = (double)std::chrono::duration_cast<std::chrono::microseconds>(readEnd - readStart).count();
+            slot.state = SlotState::FILLED;
+        }
+        m_slotChanged.notify_all();
+    }
+}
+
+void OutOfCoreReduceTask::submitSlot(Slot& slot) {
+    SubmitQueue* submitQueue = m_context->getSubmitQueue();
+    uint32_t parity = slot.parity;
+
+    SubmitRequest compute;
+    compute.queue = getTaskQueue();
+    compute.commandBuffers.push_back(slot.commandBuffers[parity]);
+
+    if (m_transferUploads) {
+        // Pushed first, so the signal is always submitted before the wait
+        SubmitRequest upload;
+        upload.queue = m_context->getTransferQueue();
+        upload.commandBuffers.push_back(slot.uploadCommandBuffers[parity]);
+        upload.signalSemaphores.push_back(slot.uploadDone);
+        submitQueue->submit(std::move(upload));
+
+        compute.waitSemaphores.push_back(slot.uploadDone);
+        compute.waitStages.push_back(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+    }
+
+    slot.ticket = submitQueue->submit(std::move(compute));
+    slot.submittedParity = parity;
+    slot.parity = 1 - parity;
+
+    std::lock_guard<std::mutex> lock(m_slotMutex);
+    slot.state = SlotState::IN_FLIGHT;
+}
+
+void OutOfCoreReduceTask::collectSlot(Slot& slot, double& sum) {
+    slot.ticket.wait();
+
+    slot.partials.invalidate(0, sizeof(float));
+    sum += *slot.partials.data<float>();
+    m_stats.readUs += slot.readUs;
+
+    // A stage whose timestamps fail once is reported as unknown
+    auto addGpuTime = [this](double& stageUs, VkQueryPool pool, uint32_t first, uint32_t last, uint32_t count) {
+        if (stageUs < 0.0) return;
+        uint64_t timestamps[3] = {0, 0, 0};
+        if (pool == VK_NULL_HANDLE ||
+            vkGetQueryPoolResults(m_context->getDevice(), pool, 0, count, sizeof(uint64_t) * count, timestamps,
+                                  sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS ||
+            timestamps[last] < timestamps[first]) {
+            stageUs = -1.0;
+            return;
+        }
+        stageUs += (double)(timestamps[last] - timestamps[first]) * m_gpuTimestampPeriod / 1000.0;
+    };
+    if (m_transferUploads) {
+        addGpuTime(m_stats.uploadUs, slot.uploadQueryPools[slot.submittedParity], 0, 1, 2);
+    } else {
+        addGpuTime(m_stats.uploadUs, slot.queryPool, 0, 1, 3);
+    }
+    addGpuTime(m_stats.reduceUs, slot.queryPool, 1, 2, 3);
+
+    {
+        std::lock_guard<std::mutex> lock(m_slotMutex);
+        slot.state = SlotState::FREE;
+    }
+    m_slotChanged.notify_all();
+}
+
+// --- Pipeline ---
+
+OutOfCoreStats OutOfCoreReduceTask::run() {
+    uint32_t chunkCount = (uint32_t)((m_elements + m_chunkElements - 1) / m_chunkElements);
+    m_stats = OutOfCoreStats();
+    m_stats.elements = m_elements;
+    m_stats.bytes = sizeof(float) * m_elements;
+    m_stats.chunks = chunkCount;
+    m_stats.slotCount = m_slotCount;
+    m_stats.transferQueue = m_transferUploads;
+    m_readFailed = false;
+    m_readStopped = false;
+    for (Slot& slot : m_slots) {
+        slot.state = SlotState::FREE;
+    }
+
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(m_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    std::thread reader(&OutOfCoreReduceTask::readerLoop, this, chunkCount);
+
+    double sum = 0.0;
+    uint32_t collected = 0;
+    for (uint32_t c = 0; c < chunkCount; c++) {
+        if (m_stopCheck && m_stopCheck()) {
+            m_stats.stopped = true;
+            m_readStopped = true;
+            m_slotChanged.notify_all();
+            break;
+        }
+        Slot& slot = m_slots[c % m_slotCount];
+        {
+            std::unique_lock<std::mutex> lock(m_slotMutex);
+            m_slotChanged.wait(lock, [&]() { return slot.state == SlotState::FILLED || m_readFailed.load(); });
+            if (m_readFailed.load()) break;
+        }
+        submitSlot(slot);
+
+        // Once the ring is full, hand the oldest chunk's slot back to the reader
+        if (c + 1 >= m_slotCount) {
+            collectSlot(m_slots[collected % m_slotCount], sum);
+            collected++;
+        }
+    }
+    // Drain in submission order
+    while (collected < chunkCount) {
+        Slot& slot = m_slots[collected % m_slotCount];
+        if (slot.state != SlotState::IN_FLIGHT) break; // Only after a read failure or a stop
+        collectSlot(slot, sum);
+        collected++;
+    }
+    reader.join();
+    auto endTime = std::chrono::high_resolution_clock::now();
+
+    if (m_readFailed.load()) {
+        throw std::runtime_error("Failed to read input file!");
+    }
+
+    m_stats.totalTimeUs = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+    m_stats.endToEndGBs = m_stats.totalTimeUs > 0 ? (double)m_stats.bytes / (m_stats.totalTimeUs * 1000.0) : 0.0;
+    m_stats.sum = sum;
+    m_stats.valid = !m_stats.stopped && (m_tolerance < 0.0 || std::fabs(sum - m_expected) <= m_tolerance);
+
+    // In a pipeline the busiest stage sets the pace
+    double busiest = m_stats.readUs;
+    m_stats.bottleneck = "read";
+    if (m_stats.uploadUs > busiest) {
+        busiest = m_stats.uploadUs;
+        m_stats.bottleneck = "upload";
+    }
+    if (m_stats.reduceUs > busiest) {
+        m_stats.bottleneck = "reduce";
+    }
+    return m_stats;
+}
+
+long long OutOfCoreReduceTask::dispatch() {
+    OutOfCoreStats stats = run();
+    logStats(stats);
+    return stats.totalTimeUs;
+}
+
+void OutOfCoreReduceTask::logStats(const OutOfCoreStats& stats) {
+    auto stageGBs = [&stats](double us) { return us > 0.0 ? (double)stats.bytes / (us * 1000.0) : 0.0; };
+    LOGI("--- OUT-OF-CORE (%llu elements, %u chunks, %u slots, %s uploads) ---",
+         (unsigned long long)stats.elements, stats.chunks, stats.slotCount,
+         stats.transferQueue ? "transfer-queue" : "inline");
+    LOGI("End-to-end: %lld us, %.2f GB/s", stats.totalTimeUs, stats.endToEndGBs);
+    LOGI("Read:   %.0f us busy (%.2f GB/s)", stats.readUs, stageGBs(stats.readUs));
+    LOGI("Upload: %.0f us busy (%.2f GB/s)", stats.uploadUs, stageGBs(stats.uploadUs));
+    LOGI("Reduce: %.0f us busy (%.2f GB/s)", stats.reduceUs, stageGBs(stats.reduceUs));
+    LOGI("Bottleneck: %s", stats.bottleneck);
+    if (stats.stopped) {
+        LOGI("STOPPED (partial sum %.3f)", stats.sum);
+    } else if (stats.valid) {
+        LOGI("SUCCESS (sum %.3f)", stats.sum);
+    } else {
+        LOGE("FAILED (sum %.3f)", stats.sum);
+    }
+}
+
+// --- Test Data ---
+
+bool OutOfCoreReduceTask::writeTestFile(const std::string& path, uint64_t count, const InputDistribution& distribution,
+                                        double& sum, double& absSum, const StopCheck& stopCheck) {
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        LOGE("Cannot create %s: %s", path.c_str(), strerror(errno));
+        throw std::runtime_error("Failed to create test file!");
+    }
+
+    // Same values as InputGenerator would put at the same indices
+    const uint64_t blockElements = 1024 * 1024;
+    std::vector<float> block(blockElements);
+    sum = 0.0;
+    absSum = 0.0;
+    for (uint64_t first = 0; first < count; first += blockElements) {
+        if (stopCheck && stopCheck()) {
+            fclose(file);
+            std::remove(path.c_str());
+            return false;
+        }
+        size_t n = (size_t)std::min(blockElements, count - first);
+        for (size_t i = 0; i < n; i++) {
+            block[i] = InputGenerator::hostValue(distribution, (uint32_t)(first + i));
+            sum += block[i];
+            absSum += std::fabs(block[i]);
+        }
+        if (fwrite(block.data(), sizeof(float), n, file) != n) {
+            fclose(file);
+            throw std::runtime_error("Failed to write test file!");
+        }
+    }
+    fclose(file);
+    return true;
+}
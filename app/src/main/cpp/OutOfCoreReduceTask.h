@@ -0,0 +1,143 @@
+#pragma once
+
+#include "BaseComputeTask.h"
+#include "MappedBuffer.h"
+#include "ComputeGraph.h"
+#include "SubmitQueue.h"
+#include "InputGenerator.h"
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+// Results of one pass over the file
+struct OutOfCoreStats {
+    uint64_t elements = 0;
+    uint64_t bytes = 0;
+    uint32_t chunks = 0;
+    uint32_t slotCount = 0;
+    bool transferQueue = false;       // Uploads ran on the dedicated transfer queue
+    long long totalTimeUs = 0;        // Open to last partial collected
+    double endToEndGBs = 0.0;
+    // Busy time of each stage, summed over chunks (us, <0 if unknown)
+    double readUs = 0.0;              // File -> host mapping (reader thread)
+    double uploadUs = 0.0;            // Staging -> device copy (0 on unified memory)
+    double reduceUs = 0.0;            // Reduction passes
+    const char* bottleneck = "unknown"; // The stage with the most busy time
+    double sum = 0.0;
+    bool valid = true;
+    bool stopped = false; // The stop check fired: the sum covers only the chunks before it (and is not valid)
+};
+
+// Sum of a raw little-endian float file that may not fit in device memory.
+//
+// The file is reduced in fixed-size chunks through a ring of slots, each with
+// its own input buffer, partials, pre-recorded command buffer(s) and query
+// pool. Three stages overlap:
+//   1. read:   a reader thread pread()s chunk k+1 straight into a free slot's mapping
+//   2. upload: staging -> device copy, on the transfer queue when the device has one
+//   3. reduce: the reduce_optimized.comp passes, one float per chunk
+// The chunk sums are combined on the host in double precision.
+//
+// Plain POSIX file I/O (open/pread/fstat): nothing here depends on Android.
+class OutOfCoreReduceTask : public BaseComputeTask {
+public:
+    OutOfCoreReduceTask(AAssetManager* assetManager, const std::string& path,
+                        uint32_t chunkElements = DEFAULT_CHUNK_ELEMENTS, uint32_t slotCount = 3);
+    ~OutOfCoreReduceTask();
+
+    // --- ComputeTask Interface ---
+    void init() override;
+    long long dispatch() override; // One pass over the file, returns total time
+    void cleanup() override;
+
+    // One pass over the file; the file is re-read every call
+    OutOfCoreStats run();
+    const OutOfCoreStats& getLastStats() const { return m_stats; }
+    static void logStats(const OutOfCoreStats& stats);
+
+    // Checks run() against a reference sum (call any time)
+    void setReference(double sum, double absSum);
+    // Polled before every chunk; once it returns true, run() drains what is in flight and returns early
+    using StopCheck = std::function<bool()>;
+    void setStopCheck(const StopCheck& stopCheck) { m_stopCheck = stopCheck; }
+
+    // Writes 'count' floats of 'distribution' to 'path' and returns their reference sums.
+    // False (and no file) if 'stopCheck' fired first; it is polled every 1M elements.
+    static bool writeTestFile(const std::string& path, uint64_t count, const InputDistribution& distribution,
+                              double& sum, double& absSum, const StopCheck& stopCheck = nullptr);
+
+    static const uint32_t DEFAULT_CHUNK_ELEMENTS = 4 * 1024 * 1024; // 16 MiB
+
+protected:
+    // --- BaseComputeTask "Fill-in-the-blanks" ---
+    std::string getShaderPath() override;
+    void createDescriptorSetLayout() override;
+    void createBuffers() override;
+    void createDescriptorPool() override;
+    void createDescriptorSet() override;
+
+private:
+    enum class SlotState { FREE, FILLED, IN_FLIGHT };
+
+    struct Slot {
+        UploadBuffer input;   // Chunk (staged on discrete GPUs)
+        MappedBuffer partials; // Ping-pong partner, holds the chunk's sum at the end
+        VkDescriptorSet setInToPartials = VK_NULL_HANDLE;
+        VkDescriptorSet setPartialsToIn = VK_NULL_HANDLE;
+
+        // Two of each, used alternately: transfer queues cannot reset query pools,
+        // so the compute buffer of one use resets the upload pool of the next
+        VkCommandBuffer commandBuffers[2] = {VK_NULL_HANDLE, VK_NULL_HANDLE};
+        VkCommandBuffer uploadCommandBuffers[2] = {VK_NULL_HANDLE, VK_NULL_HANDLE}; // Transfer-queue uploads only
+        VkQueryPool uploadQueryPools[2] = {VK_NULL_HANDLE, VK_NULL_HANDLE};         // Start, end
+        VkSemaphore uploadDone = VK_NULL_HANDLE;
+        VkQueryPool queryPool = VK_NULL_HANDLE; // Start, uploaded, reduced
+        uint32_t parity = 0;                    // Which of the pairs the next use takes
+        uint32_t submittedParity = 0;
+        SubmitTicket ticket;
+
+        // Guarded by m_slotMutex
+        SlotState state = SlotState::FREE;
+        uint32_t chunk = 0;
+        double readUs = 0.0;
+    };
+
+    void recordSlot(Slot& slot, uint32_t parity);
+    void readerLoop(uint32_t chunkCount);
+    void submitSlot(Slot& slot);
+    // Waits for the slot and adds its chunk sum and stage times to m_stats
+    void collectSlot(Slot& slot, double& sum);
+    void cleanupSlots();
+
+    std::string m_path;
+    int m_fd = -1;
+    uint64_t m_elements = 0;
+    uint32_t m_chunkElements;
+    uint32_t m_slotCount;
+    std::vector<Slot> m_slots;
+    bool m_transferUploads = false;
+    bool m_transferTimestamps = false;
+
+    // --- Reader thread handshake ---
+    std::mutex m_slotMutex;
+    std::condition_variable m_slotChanged;
+    std::atomic<bool> m_readFailed{false};
+    std::atomic<bool> m_readStopped{false}; // run() stopped early: the reader fills no more slots
+    StopCheck m_stopCheck;
+
+    double m_expected = 0.0;
+    double m_tolerance = -1.0; // <0: no reference
+    OutOfCoreStats m_stats;
+
+    VkCommandPool m_commandPool = VK_NULL_HANDLE;
+    VkCommandPool m_transferPool = VK_NULL_HANDLE;
+    float m_gpuTimestampPeriod = 0.0f;
+    ComputeGraph m_graph;
+
+    static const uint32_t WORKGROUP_SIZE = 256;
+    static constexpr uint32_t MAX_SLOTS = 4;
+};
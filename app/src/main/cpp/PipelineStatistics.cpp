@@ -0,0 +1,93 @@
+#include "PipelineStatistics.h"
+#include <sstream>
+#include <stdexcept>
+
+// --- PassStats ---
+
+double PassStats::bandwidthGBs() const {
+    if (gpuUs <= 0.0) return -1.0;
+    return (double)(bytesRead + bytesWritten) / (gpuUs * 1000.0); // B/us / 1000 = GB/s
+}
+
+double PassStats::arithmeticIntensity() const {
+    uint64_t bytes = bytesRead + bytesWritten;
+    return bytes > 0 ? (double)operations / (double)bytes : 0.0;
+}
+
+std::string PassStats::toString(const std::vector<PassStats>& passes) {
+    std::ostringstream out;
+    out << "Pass,Workgroups,Invocations,Measured_invocations,Bytes_read,Bytes_written,Ops,Barriers_before,"
+           "GPU_us,GB_per_s,Ops_per_byte";
+    for (const PassStats& pass : passes) {
+        out << "\n" << pass.name << "," << pass.workgroups << "," << pass.invocations << ","
+            << pass.measuredInvocations << "," << pass.bytesRead << "," << pass.bytesWritten << ","
+            << pass.operations << "," << pass.barriersBefore << "," << pass.gpuUs << ","
+            << pass.bandwidthGBs() << "," << pass.arithmeticIntensity();
+    }
+    return out.str();
+}
+
+// --- PipelineStatistics ---
+
+void PipelineStatistics::init(VulkanContext* context, uint32_t maxPasses) {
+    m_context = context;
+    if (!context->hasPipelineStatistics()) {
+        LOGI("PipelineStatistics: not supported by the device, disabled");
+        return;
+    }
+    m_maxQueries = maxPasses;
+
+    VkQueryPoolCreateInfo queryPoolInfo{};
+    queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryPoolInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+    queryPoolInfo.queryCount = m_maxQueries;
+    queryPoolInfo.pipelineStatistics = VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+    if (vkCreateQueryPool(context->getDevice(), &queryPoolInfo, nullptr, &m_queryPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create the pipeline statistics query pool!");
+    }
+}
+
+void PipelineStatistics::cleanup() {
+    if (m_queryPool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(m_context->getDevice(), m_queryPool, nullptr);
+        m_queryPool = VK_NULL_HANDLE;
+    }
+    m_used = 0;
+}
+
+// --- Recording ---
+
+void PipelineStatistics::reset(VkCommandBuffer commandBuffer) {
+    m_used = 0;
+    if (m_queryPool != VK_NULL_HANDLE) {
+        vkCmdResetQueryPool(commandBuffer, m_queryPool, 0, m_maxQueries);
+    }
+}
+
+uint32_t PipelineStatistics::begin(VkCommandBuffer commandBuffer) {
+    if (m_queryPool == VK_NULL_HANDLE || m_used >= m_maxQueries) return UINT32_MAX;
+    vkCmdBeginQuery(commandBuffer, m_queryPool, m_used, 0);
+    return m_used++;
+}
+
+void PipelineStatistics::end(VkCommandBuffer commandBuffer, uint32_t pass) {
+    if (pass >= m_used) return;
+    vkCmdEndQuery(commandBuffer, m_queryPool, pass);
+}
+
+// --- Reading ---
+
+std::vector<int64_t> PipelineStatistics::resolve() {
+    std::vector<int64_t> invocations(m_used, -1);
+    if (m_queryPool == VK_NULL_HANDLE || m_used == 0) return invocations;
+
+    // One statistic per query: value + availability
+    std::vector<uint64_t> results(2 * m_used, 0);
+    vkGetQueryPoolResults(m_context->getDevice(), m_queryPool, 0, m_used, results.size() * sizeof(uint64_t),
+                          results.data(), 2 * sizeof(uint64_t),
+                          VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    for (uint32_t i = 0; i < m_used; i++) {
+        if (results[2 * i + 1] != 0) invocations[i] = (int64_t)results[2 * i];
+    }
+    return invocations;
+}
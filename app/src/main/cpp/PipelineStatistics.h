@@ -0,0 +1,61 @@
+#pragma once
+
+#include "VulkanContext.h"
+#include <string>
+#include <vector>
+
+// What one pass of a ComputeGraph does. The analytic counts come from what the
+// task declared when it added the pass; the measured ones come from the GPU
+// and are -1 when unavailable.
+struct PassStats {
+    std::string name;
+    uint32_t workgroups = 0;
+    uint64_t invocations = 0;          // workgroups * local size
+    uint64_t bytesRead = 0;
+    uint64_t bytesWritten = 0;
+    uint64_t operations = 0;           // Arithmetic operations (adds, for a reduction)
+    uint32_t barriersBefore = 0;       // Buffer barriers recorded ahead of the pass
+    int64_t measuredInvocations = -1;  // Compute shader invocations, from PipelineStatistics
+    double gpuUs = -1.0;               // From the graph's GpuProfiler, when the region is plausible
+
+    // Achieved bandwidth in GB/s (-1 without a GPU time)
+    double bandwidthGBs() const;
+    // Operations per byte moved (0 for pure copies)
+    double arithmeticIntensity() const;
+
+    // CSV, one line per pass with a header
+    static std::string toString(const std::vector<PassStats>& passes);
+};
+
+// Compute shader invocations per pass, from VK_QUERY_TYPE_PIPELINE_STATISTICS.
+//
+// Pipeline statistics queries cannot nest, so unlike GpuProfiler regions each
+// pass gets its own query around its commands and nothing else. ComputeGraph
+// opens one per node when given an instance (see ComputeGraph::setStatistics).
+// Needs the pipelineStatisticsQuery device feature; without it the instance
+// stays disabled and every call is a no-op.
+class PipelineStatistics {
+public:
+    PipelineStatistics() = default;
+
+    void init(VulkanContext* context, uint32_t maxPasses = 32);
+    void cleanup();
+    bool isEnabled() const { return m_queryPool != VK_NULL_HANDLE; }
+
+    // --- Recording ---
+    // Resets the queries; call first in every command buffer
+    void reset(VkCommandBuffer commandBuffer);
+    // Returns the pass's index (UINT32_MAX when disabled or out of queries)
+    uint32_t begin(VkCommandBuffer commandBuffer);
+    void end(VkCommandBuffer commandBuffer, uint32_t pass);
+
+    // --- Reading ---
+    // Once the submission has completed: invocations per begin() index, -1 where not available
+    std::vector<int64_t> resolve();
+
+private:
+    VulkanContext* m_context = nullptr;
+    VkQueryPool m_queryPool = VK_NULL_HANDLE;
+    uint32_t m_maxQueries = 0;
+    uint32_t m_used = 0;
+};
@@ -0,0 +1,162 @@
+#include "ReduceCache.h"
+#include <stdexcept>
+#include <chrono>
+#include <cstring>
+
+namespace {
+// Runs the caller's release callback once, also on the way out of a throw
+class ReleaseGuard {
+public:
+    explicit ReleaseGuard(const std::function<void()>& release) : m_release(release) {}
+    ~ReleaseGuard() {
+        if (m_release) m_release();
+    }
+private:
+    const std::function<void()>& m_release;
+};
+}
+
+uint32_t ReduceCache::sizeClass(uint32_t count) {
+    uint32_t size = MIN_SIZE_CLASS;
+    while (size < count) size <<= 1;
+    return size;
+}
+
+HostReduceResult ReduceCache::reduce(FusedOp op, const float* data, uint32_t count) {
+    if (data == nullptr) {
+        throw std::runtime_error("ReduceCache needs data!");
+    }
+    return run(op, count, data, nullptr, nullptr);
+}
+
+HostReduceResult ReduceCache::reduce(FusedOp op, uint32_t count, const std::function<const float*()>& acquireInput,
+                                     const std::function<void()>& releaseInput) {
+    if (!acquireInput) {
+        throw std::runtime_error("ReduceCache needs an input source!");
+    }
+    return run(op, count, nullptr, acquireInput, releaseInput);
+}
+
+HostReduceResult ReduceCache::run(FusedOp op, uint32_t count, const float* data,
+                                  const std::function<const float*()>& acquireInput,
+                                  const std::function<void()>& releaseInput) {
+    if (count == 0 || count > MAX_ELEMENTS) {
+        throw std::runtime_error("ReduceCache needs 0 < count <= 2^23!");
+    }
+    if (op == FusedOp::DOT) {
+        throw std::runtime_error("ReduceCache supports single-input ops only!");
+    }
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    FusedReduceTask* task = acquireTask(op, count);
+    task->setElementCount(count);
+
+    HostReduceResult result;
+    const HostBuffer* import = (data != nullptr) ? findImport(data, count) : nullptr;
+    if (import != nullptr) {
+        task->setExternalInput(import->getBuffer());
+        result.path = HostBufferPath::IMPORTED;
+    } else {
+        task->setExternalInput(VK_NULL_HANDLE);
+        auto copyStart = std::chrono::high_resolution_clock::now();
+        {
+            // Held for the copy alone: the GPU reads the task's own input
+            const float* input = (data != nullptr) ? data : acquireInput();
+            if (input == nullptr) {
+                throw std::runtime_error("ReduceCache could not acquire its input!");
+            }
+            ReleaseGuard release(releaseInput);
+            std::memcpy(task->getHostInput(), input, sizeof(float) * (size_t)count);
+        }
+        task->flushHostInput(count);
+        result.copyUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::high_resolution_clock::now() - copyStart).count();
+    }
+
+    task->dispatch();
+    TaskResult taskResult = task->readResult();
+
+    result.value = taskResult.value;
+    result.variance = task->getVariance();
+    result.gpuTimeUs = taskResult.gpuTimeUs;
+    result.valid = taskResult.valid;
+    result.hostTimeUs = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - startTime).count();
+    return result;
+}
+
+FusedReduceTask* ReduceCache::acquireTask(FusedOp op, uint32_t count) {
+    std::pair<FusedOp, uint32_t> key(op, sizeClass(count));
+    auto it = m_tasks.find(key);
+    if (it != m_tasks.end()) return it->second.get();
+
+    LOGI("ReduceCache: new %s task for size class %u", FusedReduceTask::getOpName(op), key.second);
+    std::unique_ptr<FusedReduceTask> task(new FusedReduceTask(m_assetManager, op, key.second, FusedInput::HOST));
+    task->init();
+    FusedReduceTask* raw = task.get();
+    m_tasks[key] = std::move(task);
+    return raw;
+}
+
+const HostBuffer* ReduceCache::findImport(const float* data, uint32_t count) {
+    auto it = m_imports.find(const_cast<float*>(data));
+    if (it == m_imports.end() || it->second->getSize() < sizeof(float) * (VkDeviceSize)count) {
+        return nullptr;
+    }
+    return it->second.get();
+}
+
+bool ReduceCache::registerHostMemory(void* data, size_t bytes) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_imports.count(data) != 0) return true;
+
+    // Only whole alignment units can be imported; the tail past them is not needed
+    VulkanContext* context = VulkanContext::getInstance();
+    VkDeviceSize alignment = context->getMinImportedHostPointerAlignment();
+    VkDeviceSize importBytes = alignment > 0 ? (VkDeviceSize)bytes / alignment * alignment : bytes;
+    if (importBytes == 0) {
+        LOGI("ReduceCache: %zu bytes at %p are too small to import", bytes, data);
+        return false;
+    }
+
+    std::unique_ptr<HostBuffer> hostBuffer(new HostBuffer());
+    hostBuffer->create(context, data, importBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    if (!hostBuffer->isImported()) {
+        // A registered copy would buy nothing over the task's own mapped input
+        LOGI("ReduceCache: not registering %p (%s)", data, hostBuffer->getFallbackReason());
+        hostBuffer->destroy();
+        return false;
+    }
+    m_imports[data] = std::move(hostBuffer);
+    return true;
+}
+
+void ReduceCache::unregisterHostMemory(void* data) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_imports.find(data);
+    if (it == m_imports.end()) return;
+    // Descriptor sets must not keep pointing at a destroyed buffer
+    for (auto& entry : m_tasks) {
+        entry.second->setExternalInput(VK_NULL_HANDLE);
+    }
+    it->second->destroy();
+    m_imports.erase(it);
+}
+
+void ReduceCache::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& entry : m_tasks) {
+        entry.second->cleanup();
+    }
+    m_tasks.clear();
+    for (auto& entry : m_imports) {
+        entry.second->destroy();
+    }
+    m_imports.clear();
+}
+
+size_t ReduceCache::getTaskCount() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_tasks.size();
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "FusedReduceTask.h"
+#include "HostBuffer.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <functional>
+
+// Result of one ReduceCache::reduce() call
+struct HostReduceResult {
+    double value = 0.0;
+    double variance = 0.0;     // MEAN_VARIANCE only
+    double gpuTimeUs = -1.0;   // <0 when timestamps are unavailable
+    long long copyUs = 0;      // Caller memory -> mapped input (0 when imported)
+    long long hostTimeUs = 0;  // The whole call
+    HostBufferPath path = HostBufferPath::STAGED_COPY;
+    bool valid = false;
+};
+
+// Long-lived reductions over memory the caller owns (the JNI data path).
+//
+// Tasks are FusedReduceTasks with host input, created on first use and kept
+// per (op, size class), where the size class is the count rounded up to a
+// power of two: a call costs one copy into the task's mapped input and one
+// dispatch, never a pipeline or allocation after the first call of a class.
+//
+// Memory the caller will pass again and again (a direct ByteBuffer it keeps)
+// can be registered: if it can be imported (see HostBuffer), reduce() on that
+// pointer binds the import and skips the copy altogether.
+//
+// Thread-safe; calls are serialized, since a cached task runs one dispatch at a time.
+class ReduceCache {
+public:
+    explicit ReduceCache(AAssetManager* assetManager) : m_assetManager(assetManager) {}
+    ~ReduceCache() { clear(); }
+
+    // Reduces 'count' floats at 'data', memory that stays where it is for the
+    // whole call (a direct buffer, a native array)
+    HostReduceResult reduce(FusedOp op, const float* data, uint32_t count);
+
+    // Reduces 'count' floats that may only be held briefly (a pinned Java array).
+    // 'acquireInput' runs once the call holds its lock and its task is ready,
+    // right before the copy; 'releaseInput' runs right after the copy, or if it
+    // throws. Neither runs around the wait, the task creation or the GPU work.
+    HostReduceResult reduce(FusedOp op, uint32_t count, const std::function<const float*()>& acquireInput,
+                            const std::function<void()>& releaseInput);
+
+    // Imports 'bytes' at 'data' for later reduce() calls starting at 'data'.
+    // Returns false (and keeps nothing) when the memory cannot be imported.
+    // The caller keeps the memory alive until unregisterHostMemory() or clear().
+    bool registerHostMemory(void* data, size_t bytes);
+    void unregisterHostMemory(void* data);
+
+    // Destroys every cached task and registration (before the context goes away)
+    void clear();
+
+    size_t getTaskCount();
+    static uint32_t sizeClass(uint32_t count);
+
+    static const uint32_t MIN_SIZE_CLASS = 4096;
+    static const uint32_t MAX_ELEMENTS = 1u << 23; // Largest class FusedReduceTask accepts
+
+private:
+    // Either 'data' is set, or 'acquireInput' provides it just before the copy
+    HostReduceResult run(FusedOp op, uint32_t count, const float* data,
+                         const std::function<const float*()>& acquireInput,
+                         const std::function<void()>& releaseInput);
+    FusedReduceTask* acquireTask(FusedOp op, uint32_t count);
+    const HostBuffer* findImport(const float* data, uint32_t count);
+
+    AAssetManager* m_assetManager;
+    std::mutex m_mutex;
+    std::map<std::pair<FusedOp, uint32_t>, std::unique_ptr<FusedReduceTask>> m_tasks;
+    std::map<void*, std::unique_ptr<HostBuffer>> m_imports;
+};
@@ -0,0 +1,304 @@
+#include "ReduceDispatcher.h"
+#include "CpuReduceTask.h"
+#include "GpuOptimizedReduceTask.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <limits>
+
+const std::vector<uint32_t> ReduceDispatcher::CALIBRATION_SIZES = {
+        4 * 1024, 16 * 1024, 64 * 1024, 256 * 1024, 1024 * 1024};
+
+// Version 1 files hold GPU models fitted to dispatches that also regenerated the input: never reused
+static const char* const CACHE_HEADER = "reduce-dispatcher 2";
+
+// --- ReduceCostModel ---
+
+ReduceCostModel ReduceCostModel::fit(const std::vector<std::pair<uint32_t, double>>& samples) {
+    ReduceCostModel model;
+    if (samples.size() < 2) return model;
+
+    double meanX = 0.0, meanY = 0.0;
+    for (const auto& sample : samples) {
+        meanX += sizeof(float) * (double)sample.first;
+        meanY += sample.second;
+    }
+    meanX /= samples.size();
+    meanY /= samples.size();
+
+    double covariance = 0.0, variance = 0.0;
+    for (const auto& sample : samples) {
+        double dx = sizeof(float) * (double)sample.first - meanX;
+        covariance += dx * (sample.second - meanY);
+        variance += dx * dx;
+    }
+    // A flat (or noisy, falling) curve is all overhead: cap the bandwidth at 1 TB/s
+    double usPerByte = std::max(variance > 0.0 ? covariance / variance : 0.0, 1e-6);
+    model.bytesPerUs = 1.0 / usPerByte;
+    model.overheadUs = std::max(0.0, meanY - usPerByte * meanX);
+
+    double squaredError = 0.0;
+    for (const auto& sample : samples) {
+        double error = model.predictUs(sample.first) - sample.second;
+        squaredError += error * error;
+    }
+    model.rmsErrorUs = std::sqrt(squaredError / samples.size());
+    return model;
+}
+
+// --- ReduceDispatcherMetrics ---
+
+std::string ReduceDispatcherMetrics::toJson() const {
+    std::ostringstream out;
+    auto model = [&out](const char* name, const ReduceCostModel& m) {
+        out << "\"" << name << "\":{\"overhead_us\":" << m.overheadUs << ",\"bytes_per_us\":" << m.bytesPerUs
+            << ",\"rms_error_us\":" << m.rmsErrorUs << "}";
+    };
+    out << "{";
+    model("cpu", cpu);
+    out << ",";
+    model("gpu", gpu);
+    out << ",\"crossover_n\":";
+    if (crossoverN == std::numeric_limits<uint64_t>::max()) {
+        out << "null";
+    } else {
+        out << crossoverN;
+    }
+    out << ",\"cpu_requests\":" << cpuRequests << ",\"gpu_requests\":" << gpuRequests
+        << ",\"calibrations\":" << calibrations << ",\"loaded_from_cache\":" << (loadedFromCache ? "true" : "false")
+        << ",\"thermal_status\":" << thermalStatus << ",\"calibrated_thermal_status\":" << calibratedThermalStatus
+        << ",\"mean_abs_error_pct\":" << meanAbsErrorPct << ",\"last_recalibration\":\"" << lastRecalibrationReason
+        << "\"}";
+    return out.str();
+}
+
+// --- ReduceDispatcher ---
+
+ReduceDispatcher::ReduceDispatcher(AAssetManager* assetManager) : m_assetManager(assetManager) {
+    LOGI("ReduceDispatcher created");
+}
+
+ReduceDispatcher::~ReduceDispatcher() {
+    LOGI("ReduceDispatcher destroyed");
+}
+
+const char* ReduceDispatcher::getBackendName(ReduceBackend backend) {
+    return backend == ReduceBackend::GPU ? "gpu" : "cpu";
+}
+
+void ReduceDispatcher::init() {
+    m_cpuTask.reset(new CpuReduceTask(CALIBRATION_SIZES.front()));
+    m_cpuTask->init();
+    m_gpuTask.reset(new GpuOptimizedReduceTask(m_assetManager, CALIBRATION_SIZES.front()));
+    m_gpuTask->init();
+}
+
+void ReduceDispatcher::cleanup() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_cpuTask) m_cpuTask->cleanup();
+    if (m_gpuTask) m_gpuTask->cleanup();
+    m_cpuTask.reset();
+    m_gpuTask.reset();
+}
+
+// --- Calibration ---
+
+double ReduceDispatcher::timeBackend(ComputeTask* task, uint32_t n) {
+    // Any input (re)generation happens here, outside the timed dispatches, for both backends alike
+    task->resize(n);
+    task->dispatch(); // Warm-up at this size
+    std::vector<double> times;
+    for (uint32_t i = 0; i < CALIBRATION_RUNS; i++) {
+        times.push_back((double)task->dispatch());
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+void ReduceDispatcher::loadOrCalibrate(const std::string& cachePath) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cachePath = cachePath;
+    if (!cachePath.empty() && load(cachePath)) {
+        LOGI("ReduceDispatcher: models loaded from %s", cachePath.c_str());
+        return;
+    }
+    calibrateLocked("startup");
+}
+
+void ReduceDispatcher::calibrate(const std::string& reason) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    calibrateLocked(reason);
+}
+
+void ReduceDispatcher::setStopCheck(const StopCheck& stopCheck) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopCheck = stopCheck;
+}
+
+void ReduceDispatcher::calibrateLocked(const std::string& reason) {
+    LOGI("ReduceDispatcher: calibrating (%s)...", reason.c_str());
+
+    std::vector<std::pair<uint32_t, double>> cpuSamples;
+    std::vector<std::pair<uint32_t, double>> gpuSamples;
+    for (uint32_t n : CALIBRATION_SIZES) {
+        if (m_stopCheck && m_stopCheck()) {
+            LOGI("ReduceDispatcher: calibration stopped, models unchanged");
+            return;
+        }
+        cpuSamples.emplace_back(n, timeBackend(m_cpuTask.get(), n));
+        gpuSamples.emplace_back(n, timeBackend(m_gpuTask.get(), n));
+    }
+    m_metrics.cpu = ReduceCostModel::fit(cpuSamples);
+    m_metrics.gpu = ReduceCostModel::fit(gpuSamples);
+    m_metrics.calibrations++;
+    m_metrics.loadedFromCache = false;
+    m_metrics.calibratedThermalStatus = m_thermalStatus.load();
+    m_metrics.lastRecalibrationReason = reason;
+    m_stale = false;
+    m_driftCount = 0;
+    updateCrossover();
+
+    LOGI("ReduceDispatcher: cpu %.1f us + %.1f B/us, gpu %.1f us + %.1f B/us, crossover N=%llu",
+         m_metrics.cpu.overheadUs, m_metrics.cpu.bytesPerUs, m_metrics.gpu.overheadUs, m_metrics.gpu.bytesPerUs,
+         (unsigned long long)m_metrics.crossoverN);
+    if (!m_cachePath.empty()) save(m_cachePath);
+}
+
+void ReduceDispatcher::updateCrossover() {
+    // GPU wins where oG + b * sG < oC + b * sC (s = us per byte)
+    const ReduceCostModel& cpu = m_metrics.cpu;
+    const ReduceCostModel& gpu = m_metrics.gpu;
+    double slopeCpu = 1.0 / cpu.bytesPerUs;
+    double slopeGpu = 1.0 / gpu.bytesPerUs;
+    if (gpu.overheadUs <= cpu.overheadUs) {
+        m_metrics.crossoverN = 0;
+    } else if (slopeCpu > slopeGpu) {
+        double bytes = (gpu.overheadUs - cpu.overheadUs) / (slopeCpu - slopeGpu);
+        m_metrics.crossoverN = (uint64_t)std::ceil(bytes / sizeof(float));
+    } else {
+        m_metrics.crossoverN = std::numeric_limits<uint64_t>::max();
+    }
+}
+
+// --- Cache file: a device key, the thermal status, then one model per line ---
+
+std::string ReduceDispatcher::deviceKey() {
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(VulkanContext::getInstance()->getPhysicalDevice(), &properties);
+    std::ostringstream key;
+    key << properties.deviceName << "|" << properties.driverVersion << "|" << std::thread::hardware_concurrency();
+    return key.str();
+}
+
+bool ReduceDispatcher::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    std::string header, key;
+    int thermalStatus = -1;
+    ReduceCostModel cpu, gpu;
+    std::getline(in, header);
+    std::getline(in, key);
+    in >> thermalStatus >> cpu.overheadUs >> cpu.bytesPerUs >> cpu.rmsErrorUs
+       >> gpu.overheadUs >> gpu.bytesPerUs >> gpu.rmsErrorUs;
+    if (!in || header != CACHE_HEADER || key != deviceKey()) {
+        LOGI("ReduceDispatcher: cache %s is for another device or version", path.c_str());
+        return false;
+    }
+    if (thermalStatus != m_thermalStatus.load() || !cpu.isValid() || !gpu.isValid()) {
+        LOGI("ReduceDispatcher: cached models were measured at thermal status %d", thermalStatus);
+        return false;
+    }
+
+    m_metrics.cpu = cpu;
+    m_metrics.gpu = gpu;
+    m_metrics.loadedFromCache = true;
+    m_metrics.calibratedThermalStatus = thermalStatus;
+    m_metrics.lastRecalibrationReason = "cache";
+    m_stale = false;
+    updateCrossover();
+    return true;
+}
+
+void ReduceDispatcher::save(const std::string& path) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) {
+        LOGW("ReduceDispatcher: cannot write %s", path.c_str());
+        return;
+    }
+    out << CACHE_HEADER << "\n" << deviceKey() << "\n" << m_metrics.calibratedThermalStatus << "\n";
+    out.precision(17);
+    out << m_metrics.cpu.overheadUs << " " << m_metrics.cpu.bytesPerUs << " " << m_metrics.cpu.rmsErrorUs << "\n";
+    out << m_metrics.gpu.overheadUs << " " << m_metrics.gpu.bytesPerUs << " " << m_metrics.gpu.rmsErrorUs << "\n";
+}
+
+// --- Routing ---
+
+ReduceBackend ReduceDispatcher::route(uint32_t n) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return routeLocked(n);
+}
+
+ReduceBackend ReduceDispatcher::routeLocked(uint32_t n) {
+    if (!m_metrics.cpu.isValid() || !m_metrics.gpu.isValid()) {
+        throw std::runtime_error("ReduceDispatcher is not calibrated!");
+    }
+    if (n > GpuOptimizedReduceTask::getMaxElementCount()) {
+        return ReduceBackend::CPU; // One dispatch of the GPU task cannot cover N
+    }
+    return m_metrics.gpu.predictUs(n) < m_metrics.cpu.predictUs(n) ? ReduceBackend::GPU : ReduceBackend::CPU;
+}
+
+ReduceDispatch ReduceDispatcher::reduce(uint32_t n) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    int thermalStatus = m_thermalStatus.load();
+    if (thermalStatus != m_metrics.calibratedThermalStatus) {
+        calibrateLocked("thermal status " + std::to_string(m_metrics.calibratedThermalStatus) + " -> " +
+                        std::to_string(thermalStatus));
+    } else if (m_stale) {
+        calibrateLocked(m_staleReason);
+    }
+    ReduceBackend backend = routeLocked(n);
+
+    ReduceDispatch dispatch;
+    dispatch.backend = backend;
+    const ReduceCostModel& chosen = (backend == ReduceBackend::GPU) ? m_metrics.gpu : m_metrics.cpu;
+    const ReduceCostModel& other = (backend == ReduceBackend::GPU) ? m_metrics.cpu : m_metrics.gpu;
+    dispatch.predictedUs = chosen.predictUs(n);
+    dispatch.otherUs = other.predictUs(n);
+
+    ComputeTask* task = (backend == ReduceBackend::GPU) ? m_gpuTask.get() : m_cpuTask.get();
+    task->resize(n);
+    long long hostUs = task->dispatch();
+    if (task->isRecordable()) dispatch.result = task->readResult();
+    dispatch.result.hostTimeUs = hostUs;
+    (backend == ReduceBackend::GPU ? m_metrics.gpuRequests : m_metrics.cpuRequests)++;
+
+    // Prediction quality; a model that stays far off is stale (throttling, background load, ...)
+    double errorPct = 100.0 * std::fabs(hostUs - dispatch.predictedUs) / std::max(1.0, dispatch.predictedUs);
+    m_errorSumPct += errorPct;
+    m_metrics.meanAbsErrorPct = m_errorSumPct / (m_metrics.cpuRequests + m_metrics.gpuRequests);
+    bool drifted = hostUs > dispatch.predictedUs * DRIFT_FACTOR || hostUs * DRIFT_FACTOR < dispatch.predictedUs;
+    m_driftCount = drifted ? m_driftCount + 1 : 0;
+    if (m_driftCount >= DRIFT_REQUESTS) {
+        m_stale = true;
+        m_staleReason = "prediction drift";
+    }
+    return dispatch;
+}
+
+// Lock-free so the UI thread never waits out a calibration; reduce() compares it with the calibrated status
+void ReduceDispatcher::setThermalStatus(int status) {
+    int previous = m_thermalStatus.exchange(status);
+    if (previous != status) LOGI("ReduceDispatcher: thermal status %d -> %d", previous, status);
+}
+
+ReduceDispatcherMetrics ReduceDispatcher::getMetrics() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ReduceDispatcherMetrics metrics = m_metrics;
+    metrics.thermalStatus = m_thermalStatus.load();
+    return metrics;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "ComputeTask.h"
+#include <android/asset_manager.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <utility>
+#include <functional>
+
+// Where a ReduceDispatcher sends a request
+enum class ReduceBackend { CPU, GPU };
+
+// Latency model of one backend: fixed overhead + bytes / bandwidth
+struct ReduceCostModel {
+    double overheadUs = 0.0;
+    double bytesPerUs = 0.0; // 0 = not calibrated
+    double rmsErrorUs = 0.0; // Residual of the fit
+
+    bool isValid() const { return bytesPerUs > 0.0; }
+    double predictUs(uint32_t n) const { return overheadUs + sizeof(float) * (double)n / bytesPerUs; }
+    // Least-squares line through (elements, us) samples
+    static ReduceCostModel fit(const std::vector<std::pair<uint32_t, double>>& samples);
+};
+
+// What the dispatcher knows and has done, for metrics
+struct ReduceDispatcherMetrics {
+    ReduceCostModel cpu;
+    ReduceCostModel gpu;
+    uint64_t crossoverN = 0;        // Smallest N the GPU is predicted to win (0: always, UINT64_MAX: never)
+    uint64_t cpuRequests = 0;
+    uint64_t gpuRequests = 0;
+    uint32_t calibrations = 0;      // Including the first (0 if loaded from the cache)
+    bool loadedFromCache = false;
+    int thermalStatus = 0;          // Last reported (PowerManager.THERMAL_STATUS_*)
+    int calibratedThermalStatus = 0;
+    double meanAbsErrorPct = 0.0;   // |actual - predicted| / predicted over routed requests
+    std::string lastRecalibrationReason;
+
+    std::string toJson() const;
+};
+
+// The outcome of one routed request
+struct ReduceDispatch {
+    ReduceBackend backend = ReduceBackend::CPU;
+    double predictedUs = 0.0; // For the chosen backend
+    double otherUs = 0.0;     // For the one not chosen
+    TaskResult result;
+};
+
+// Routes each sum reduction to the backend its cost model predicts is faster.
+//
+// Owns one long-lived, resizable task per backend (CpuReduceTask and
+// GpuOptimizedReduceTask). calibrate() times both over CALIBRATION_SIZES and
+// fits a ReduceCostModel to each, wall time per dispatch as the caller sees
+// it. Both tasks generate their input at init() and when resize() grows it,
+// and dispatches only read it, so the two models price the same work: N
+// floats read, plus each backend's fixed cost. The models can be saved to and loaded from a file, keyed by the
+// GPU's name and driver version, so a start-up with a valid cache does not
+// calibrate.
+//
+// The models go stale when the device throttles: a change of the reported
+// thermal status, or predictions that stay off by more than DRIFT_FACTOR for
+// DRIFT_REQUESTS requests in a row, recalibrate before the next request.
+//
+// Thread-safe; requests are serialized.
+class ReduceDispatcher {
+public:
+    explicit ReduceDispatcher(AAssetManager* assetManager);
+    ~ReduceDispatcher();
+
+    void init();
+    void cleanup();
+
+    // Loads the cached models if they match this device and thermal status, otherwise calibrates
+    // (and saves, if 'cachePath' is not empty)
+    void loadOrCalibrate(const std::string& cachePath);
+    void calibrate(const std::string& reason);
+    // Polled between calibration sizes; once it returns true, a calibration in progress gives up
+    // and keeps the previous models (none before the first calibration: reduce() then throws)
+    using StopCheck = std::function<bool()>;
+    void setStopCheck(const StopCheck& stopCheck);
+
+    ReduceBackend route(uint32_t n);
+    // Routes, resizes the chosen task and runs it
+    ReduceDispatch reduce(uint32_t n);
+
+    // From PowerManager (THERMAL_STATUS_NONE = 0 ... SHUTDOWN = 6); the next reduce() recalibrates if it changed.
+    // Call before loadOrCalibrate() so a cache measured at another status is not used.
+    void setThermalStatus(int status);
+
+    ReduceDispatcherMetrics getMetrics();
+    static const char* getBackendName(ReduceBackend backend);
+
+private:
+    // With m_mutex held
+    void calibrateLocked(const std::string& reason);
+    ReduceBackend routeLocked(uint32_t n);
+    double timeBackend(ComputeTask* task, uint32_t n);
+    void updateCrossover();
+    bool load(const std::string& path);
+    void save(const std::string& path);
+    std::string deviceKey();
+
+    AAssetManager* m_assetManager;
+    std::unique_ptr<ComputeTask> m_cpuTask;
+    std::unique_ptr<ComputeTask> m_gpuTask;
+    std::string m_cachePath;
+    StopCheck m_stopCheck;
+
+    std::atomic<int> m_thermalStatus{0};
+    std::mutex m_mutex;
+    ReduceDispatcherMetrics m_metrics;
+    bool m_stale = false;
+    std::string m_staleReason;
+    uint32_t m_driftCount = 0;
+    double m_errorSumPct = 0.0;
+
+    static const std::vector<uint32_t> CALIBRATION_SIZES;
+    static const uint32_t CALIBRATION_RUNS = 5;  // Median of these per size
+    static constexpr double DRIFT_FACTOR = 2.0;
+    static const uint32_t DRIFT_REQUESTS = 8;
+};
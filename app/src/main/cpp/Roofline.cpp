@@ -0,0 +1,103 @@
+#include "Roofline.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <sstream>
+
+namespace {
+const BandwidthKernel ALL_KERNELS[] = {BandwidthKernel::COPY, BandwidthKernel::READ, BandwidthKernel::WRITE,
+                                       BandwidthKernel::STRIDED, BandwidthKernel::RANDOM};
+const BandwidthKernel STREAMING_KERNELS[] = {BandwidthKernel::COPY, BandwidthKernel::READ, BandwidthKernel::WRITE};
+}
+
+const char* getBandwidthKernelName(BandwidthKernel kernel) {
+    switch (kernel) {
+        case BandwidthKernel::COPY: return "copy";
+        case BandwidthKernel::READ: return "read";
+        case BandwidthKernel::WRITE: return "write";
+        case BandwidthKernel::STRIDED: return "strided";
+        case BandwidthKernel::RANDOM: return "random";
+    }
+    return "unknown";
+}
+
+uint64_t getBandwidthBytesPerElement(BandwidthKernel kernel) {
+    return kernel == BandwidthKernel::COPY ? 32 : 16;
+}
+
+// --- Lookups ---
+
+double Roofline::kernelGBs(const std::string& processor, BandwidthKernel kernel, uint64_t workingSetBytes) const {
+    // The kernel's curve, sorted by size
+    std::vector<std::pair<uint64_t, double>> curve;
+    for (const BandwidthSample& sample : m_samples) {
+        if (sample.processor == processor && sample.kernel == kernel) {
+            curve.emplace_back(sample.workingSetBytes, sample.gbPerS());
+        }
+    }
+    if (curve.empty()) return 0.0;
+    std::sort(curve.begin(), curve.end());
+
+    if (workingSetBytes <= curve.front().first) return curve.front().second;
+    if (workingSetBytes >= curve.back().first) return curve.back().second;
+    for (size_t i = 1; i < curve.size(); i++) {
+        if (workingSetBytes <= curve[i].first) {
+            double t = std::log((double)workingSetBytes / curve[i - 1].first) /
+                       std::log((double)curve[i].first / curve[i - 1].first);
+            return curve[i - 1].second + t * (curve[i].second - curve[i - 1].second);
+        }
+    }
+    return curve.back().second;
+}
+
+double Roofline::attainableGBs(const std::string& processor, uint64_t workingSetBytes) const {
+    double best = 0.0;
+    for (BandwidthKernel kernel : STREAMING_KERNELS) {
+        best = std::max(best, kernelGBs(processor, kernel, workingSetBytes));
+    }
+    return best;
+}
+
+double Roofline::peakGBs(const std::string& processor) const {
+    double best = 0.0;
+    for (const BandwidthSample& sample : m_samples) {
+        if (sample.processor == processor && sample.kernel != BandwidthKernel::STRIDED &&
+            sample.kernel != BandwidthKernel::RANDOM) {
+            best = std::max(best, sample.gbPerS());
+        }
+    }
+    return best;
+}
+
+double Roofline::percentOf(const std::string& processor, uint64_t workingSetBytes, double achievedGBs) const {
+    double roof = attainableGBs(processor, workingSetBytes);
+    return (roof > 0.0 && achievedGBs > 0.0) ? 100.0 * achievedGBs / roof : -1.0;
+}
+
+// --- Output ---
+
+std::string Roofline::toString() const {
+    // processor -> working set -> GB/s per kernel (0 where not measured)
+    std::map<std::string, std::map<uint64_t, std::vector<double>>> table;
+    for (const BandwidthSample& sample : m_samples) {
+        std::vector<double>& row = table[sample.processor][sample.workingSetBytes];
+        row.resize(sizeof(ALL_KERNELS) / sizeof(ALL_KERNELS[0]), 0.0);
+        row[static_cast<uint32_t>(sample.kernel)] = sample.gbPerS();
+    }
+
+    std::ostringstream out;
+    out << "Processor,Working_set_bytes";
+    for (BandwidthKernel kernel : ALL_KERNELS) {
+        out << "," << getBandwidthKernelName(kernel) << "_GB_per_s";
+    }
+    for (const auto& processor : table) {
+        for (const auto& row : processor.second) {
+            out << "\n" << processor.first << "," << row.first;
+            for (double gbPerS : row.second) {
+                out << "," << gbPerS;
+            }
+        }
+        out << "\n" << processor.first << ",peak," << peakGBs(processor.first);
+    }
+    return out.str();
+}
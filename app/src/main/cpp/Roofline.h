@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// The bandwidth microbenchmarks (values match bandwidth.comp's KERNEL)
+enum class BandwidthKernel : uint32_t {
+    COPY = 0,    // dst = src
+    READ = 1,    // sum of src, sequential
+    WRITE = 2,   // dst = constant
+    STRIDED = 3, // sum of src, 256-byte steps (a new cache line every read)
+    RANDOM = 4   // sum of src, scattered permutation
+};
+
+const char* getBandwidthKernelName(BandwidthKernel kernel);
+// Bytes one visited 16-byte element costs (copy reads and writes it)
+uint64_t getBandwidthBytesPerElement(BandwidthKernel kernel);
+
+// One point of a bandwidth-vs-size curve
+struct BandwidthSample {
+    std::string processor;         // "gpu" or "cpu"
+    BandwidthKernel kernel = BandwidthKernel::READ;
+    uint64_t workingSetBytes = 0;  // What the kernel sweeps over, repeatedly
+    uint64_t bytesMoved = 0;       // Per timed run
+    double us = 0.0;               // Best of the timed runs
+    bool gpuTimed = false;         // 'us' came from GPU timestamps (else from the CPU clock)
+
+    double gbPerS() const { return us > 0.0 ? (double)bytesMoved / (us * 1000.0) : 0.0; }
+};
+
+// The measured memory roofline of each processor: bandwidth against working
+// set size, per kernel, from GpuBandwidthTask and CpuBandwidthTask.
+//
+// What a workload can attain at a given working set is the best streaming
+// kernel (copy, read or write) there, interpolated on a log scale between the
+// measured sizes and clamped at both ends. Strided and random reads are kept
+// for the curves, not for the roof.
+class Roofline {
+public:
+    void clear() { m_samples.clear(); }
+    void add(const BandwidthSample& sample) { m_samples.push_back(sample); }
+    bool isEmpty() const { return m_samples.empty(); }
+    const std::vector<BandwidthSample>& getSamples() const { return m_samples; }
+
+    // GB/s, 0 if nothing was measured for the processor
+    double attainableGBs(const std::string& processor, uint64_t workingSetBytes) const;
+    double peakGBs(const std::string& processor) const;
+    // 'achievedGBs' as a percentage of attainableGBs(), -1 without a roof or an achieved rate (<= 0: untimed)
+    double percentOf(const std::string& processor, uint64_t workingSetBytes, double achievedGBs) const;
+
+    // CSV: one line per processor and working set, one GB/s column per kernel
+    std::string toString() const;
+
+private:
+    double kernelGBs(const std::string& processor, BandwidthKernel kernel, uint64_t workingSetBytes) const;
+
+    std::vector<BandwidthSample> m_samples;
+};
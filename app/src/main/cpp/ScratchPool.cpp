@@ -0,0 +1,110 @@
+#include "ScratchPool.h"
+#include <stdexcept>
+#include <algorithm>
+
+void ScratchPool::create(VulkanContext* context, VkDeviceSize capacity) {
+    m_context = context;
+    // 16 keeps vec4 partials aligned even where the device allows less
+    m_alignment = std::max<VkDeviceSize>(16, m_context->getMinStorageBufferOffsetAlignment());
+    m_capacity = align(capacity);
+    VkDevice device = m_context->getDevice();
+
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = m_capacity;
+    // Storage for the passes; transfer for result copies and clears
+    bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                       VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if (vkCreateBuffer(device, &bufferInfo, nullptr, &m_buffer) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create scratch pool buffer!");
+    }
+
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(device, m_buffer, &memRequirements);
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = memRequirements.size;
+    allocInfo.memoryTypeIndex = m_context->selectMemoryType(memRequirements.memoryTypeBits, MemoryUsage::GPU_ONLY);
+    if (vkAllocateMemory(device, &allocInfo, nullptr, &m_memory) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate scratch pool memory!");
+    }
+    vkBindBufferMemory(device, m_buffer, m_memory, 0);
+
+    m_freeBlocks.clear();
+    m_freeBlocks[0] = m_capacity;
+    m_used = 0;
+    LOGI("Scratch pool created: %llu bytes, alignment %llu",
+         (unsigned long long)m_capacity, (unsigned long long)m_alignment);
+}
+
+void ScratchPool::destroy() {
+    if (m_context == nullptr) return;
+    if (m_used > 0) {
+        LOGW("Scratch pool destroyed with %llu bytes still allocated", (unsigned long long)m_used);
+    }
+    VkDevice device = m_context->getDevice();
+    if (m_buffer != VK_NULL_HANDLE) vkDestroyBuffer(device, m_buffer, nullptr);
+    if (m_memory != VK_NULL_HANDLE) vkFreeMemory(device, m_memory, nullptr);
+    m_buffer = VK_NULL_HANDLE;
+    m_memory = VK_NULL_HANDLE;
+    m_freeBlocks.clear();
+    m_context = nullptr;
+}
+
+ScratchRange ScratchPool::allocate(VkDeviceSize size) {
+    VkDeviceSize alignedSize = align(std::max<VkDeviceSize>(size, 1));
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // First fit: offsets and sizes are both multiples of the alignment
+    for (auto it = m_freeBlocks.begin(); it != m_freeBlocks.end(); ++it) {
+        if (it->second < alignedSize) continue;
+
+        ScratchRange range;
+        range.buffer = m_buffer;
+        range.offset = it->first;
+        range.size = alignedSize;
+
+        VkDeviceSize remaining = it->second - alignedSize;
+        VkDeviceSize next = it->first + alignedSize;
+        m_freeBlocks.erase(it);
+        if (remaining > 0) m_freeBlocks[next] = remaining;
+        m_used += alignedSize;
+        return range;
+    }
+    throw std::runtime_error("Scratch pool exhausted!");
+}
+
+void ScratchPool::release(ScratchRange& range) {
+    if (!range.isValid()) return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    VkDeviceSize offset = range.offset;
+    VkDeviceSize size = range.size;
+    m_used -= size;
+
+    // Merge with the following free block
+    auto next = m_freeBlocks.find(offset + size);
+    if (next != m_freeBlocks.end()) {
+        size += next->second;
+        m_freeBlocks.erase(next);
+    }
+    // ...and with the preceding one
+    auto it = m_freeBlocks.lower_bound(offset);
+    if (it != m_freeBlocks.begin()) {
+        auto previous = std::prev(it);
+        if (previous->first + previous->second == offset) {
+            previous->second += size;
+            range = ScratchRange{};
+            return;
+        }
+    }
+    m_freeBlocks[offset] = size;
+    range = ScratchRange{};
+}
+
+VkDeviceSize ScratchPool::getUsed() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_used;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "VulkanContext.h"
+#include <map>
+#include <mutex>
+
+// A sub-range of the scratch pool's buffer
+struct ScratchRange {
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;
+    bool isValid() const { return buffer != VK_NULL_HANDLE; }
+};
+
+// One small device-only buffer that tasks carve their scratch space from.
+//
+// Ranges are aligned to minStorageBufferOffsetAlignment, so they can be bound
+// as storage-buffer descriptors directly. First-fit over a free list; released
+// ranges are merged with their neighbours. Thread-safe.
+//
+// Meant for O(workgroups) scratch (partials and the like): a task that needs
+// more than the pool has should allocate its own buffer.
+class ScratchPool {
+public:
+    ScratchPool() = default;
+
+    void create(VulkanContext* context, VkDeviceSize capacity);
+    void destroy();
+
+    // Throws when no free block is large enough
+    ScratchRange allocate(VkDeviceSize size);
+    void release(ScratchRange& range);
+
+    // Rounds a size or offset up to the range alignment
+    VkDeviceSize align(VkDeviceSize value) const { return (value + m_alignment - 1) / m_alignment * m_alignment; }
+    VkDeviceSize getAlignment() const { return m_alignment; }
+    VkBuffer getBuffer() const { return m_buffer; }
+    VkDeviceSize getCapacity() const { return m_capacity; }
+    VkDeviceSize getUsed();
+
+private:
+    VulkanContext* m_context = nullptr;
+    VkBuffer m_buffer = VK_NULL_HANDLE;
+    VkDeviceMemory m_memory = VK_NULL_HANDLE;
+    VkDeviceSize m_capacity = 0;
+    VkDeviceSize m_alignment = 16;
+
+    std::mutex m_mutex;
+    std::map<VkDeviceSize, VkDeviceSize> m_freeBlocks; // offset -> size, sorted for merging
+    VkDeviceSize m_used = 0;
+};
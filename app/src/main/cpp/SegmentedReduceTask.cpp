@@ -0,0 +1,342 @@
+#include "SegmentedReduceTask.h"
+#include "UploadRing.h"
+#include <vector>
+#include <stdexcept>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+SegmentedReduceTask::SegmentedReduceTask(AAssetManager* assetManager, std::vector<float> values,
+                                         std::vector<uint32_t> offsets)
+        : BaseComputeTask(assetManager), m_values(std::move(values)), m_offsets(std::move(offsets)) {
+    planMapping();
+}
+
+SegmentedReduceTask::SegmentedReduceTask(AAssetManager* assetManager, std::vector<float> values,
+                                         uint32_t segmentLength)
+        : BaseComputeTask(assetManager), m_values(std::move(values)), m_segmentLength(segmentLength) {
+    planMapping();
+}
+
+SegmentedReduceTask::~SegmentedReduceTask() {
+    LOGI("SegmentedReduceTask destroyed");
+}
+
+// --- Mapping ---
+
+void SegmentedReduceTask::planMapping() {
+    const uint32_t total = static_cast<uint32_t>(m_values.size());
+    if (total == 0) {
+        throw std::runtime_error("SegmentedReduceTask needs at least one value!");
+    }
+
+    // Segment bounds, from the offsets or the uniform length
+    std::vector<uint32_t> bounds;
+    if (m_segmentLength > 0) {
+        for (uint32_t begin = 0; begin < total; begin += m_segmentLength) bounds.push_back(begin);
+        bounds.push_back(total);
+    } else {
+        if (m_offsets.size() < 2 || m_offsets.back() != total) {
+            throw std::runtime_error("Segment offsets must end at the number of values!");
+        }
+        for (size_t i = 1; i < m_offsets.size(); i++) {
+            if (m_offsets[i] < m_offsets[i - 1]) {
+                throw std::runtime_error("Segment offsets must be non-decreasing!");
+            }
+        }
+        bounds = m_offsets;
+    }
+    m_segmentCount = static_cast<uint32_t>(bounds.size() - 1);
+
+    // CPU reference (double accumulation), and the longest segment
+    uint32_t maxLength = 0;
+    m_expected.assign(m_segmentCount, 0.0);
+    m_tolerances.assign(m_segmentCount, 0.0);
+    for (uint32_t s = 0; s < m_segmentCount; s++) {
+        double magnitude = 0.0;
+        for (uint32_t i = bounds[s]; i < bounds[s + 1]; i++) {
+            m_expected[s] += m_values[i];
+            magnitude += std::fabs(m_values[i]);
+        }
+        // Float sums in a different order: allow a relative error on the magnitudes
+        m_tolerances[s] = 1e-4 * std::max(1.0, magnitude);
+        maxLength = std::max(maxLength, bounds[s + 1] - bounds[s]);
+    }
+
+    // Chunk size that gives roughly TARGET_WORKGROUPS workgroups for the whole input
+    uint32_t chunk = (total + TARGET_WORKGROUPS - 1) / TARGET_WORKGROUPS;
+    chunk = std::min(std::max(chunk, MIN_CHUNK), MAX_CHUNK);
+
+    m_itemRanges.clear();
+    m_segmentRanges.clear();
+    if (maxLength <= THREAD_SEGMENT_MAX) {
+        m_mapping = SegmentMapping::THREAD_PER_SEGMENT;
+    } else if (maxLength <= chunk) {
+        m_mapping = SegmentMapping::WORKGROUP_PER_SEGMENT;
+    } else {
+        // Some segment would keep one workgroup busy while the rest of the GPU idles
+        m_mapping = SegmentMapping::SPLIT_SEGMENTS;
+    }
+
+    if (m_mapping == SegmentMapping::SPLIT_SEGMENTS) {
+        for (uint32_t s = 0; s < m_segmentCount; s++) {
+            uint32_t firstChunk = static_cast<uint32_t>(m_itemRanges.size() / 2);
+            for (uint32_t begin = bounds[s]; begin < bounds[s + 1]; begin += chunk) {
+                m_itemRanges.push_back(begin);
+                m_itemRanges.push_back(std::min(begin + chunk, bounds[s + 1]));
+            }
+            m_segmentRanges.push_back(firstChunk);
+            m_segmentRanges.push_back(static_cast<uint32_t>(m_itemRanges.size() / 2));
+        }
+        m_itemCount = static_cast<uint32_t>(m_itemRanges.size() / 2);
+    } else {
+        // Uniform lengths are computed in the shader; otherwise one range per segment
+        if (m_segmentLength == 0) {
+            for (uint32_t s = 0; s < m_segmentCount; s++) {
+                m_itemRanges.push_back(bounds[s]);
+                m_itemRanges.push_back(bounds[s + 1]);
+            }
+        }
+        m_itemCount = m_segmentCount;
+    }
+
+    LOGI("SegmentedReduceTask created. N=%u, Segments=%u, MaxLen=%u, Mapping=%s, Items=%u",
+         total, m_segmentCount, maxLength, getMappingName(m_mapping), m_itemCount);
+}
+
+const char* SegmentedReduceTask::getMappingName(SegmentMapping mapping) {
+    switch (mapping) {
+        case SegmentMapping::THREAD_PER_SEGMENT: return "thread-per-segment";
+        case SegmentMapping::WORKGROUP_PER_SEGMENT: return "workgroup-per-segment";
+        case SegmentMapping::SPLIT_SEGMENTS: return "split-segments";
+    }
+    return "unknown";
+}
+
+uint32_t SegmentedReduceTask::groupCount(uint32_t mode, uint32_t itemCount) const {
+    // The shader loops over items, so the grid can be capped
+    uint32_t groups = (mode == 1) ? (itemCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE : itemCount;
+    return std::max(1u, std::min(groups, MAX_GROUPS));
+}
+
+// --- Overridden init() ---
+void SegmentedReduceTask::init() {
+    LOGI("SegmentedReduceTask::init() starting...");
+
+    createBuffers();
+    // Values and ranges go out as one upload batch
+    m_context->getUploadRing()->submit();
+    createDescriptorSetLayout();
+    createDescriptorPool();
+    createDescriptorSet();
+
+    createPipelineLayout(sizeof(SegmentPushData));
+    m_pipeline = createComputePipeline(getShaderPath());
+
+    m_profiler.init(m_context, 1); // Disabled if the compute queue has no timestamps
+
+    LOGI("SegmentedReduceTask::init() finished.");
+}
+
+void SegmentedReduceTask::cleanup() {
+    LOGI("SegmentedReduceTask::cleanup()");
+    VkDevice device = m_context->getDevice();
+
+    m_profiler.cleanup();
+
+    VkBuffer buffers[] = {m_valuesBuffer, m_rangesBuffer, m_segmentRangesBuffer, m_partialsBuffer};
+    VkDeviceMemory memories[] = {m_valuesMemory, m_rangesMemory, m_segmentRangesMemory, m_partialsMemory};
+    for (VkBuffer buffer : buffers) {
+        if (buffer != VK_NULL_HANDLE) vkDestroyBuffer(device, buffer, nullptr);
+    }
+    for (VkDeviceMemory memory : memories) {
+        if (memory != VK_NULL_HANDLE) vkFreeMemory(device, memory, nullptr);
+    }
+    m_valuesBuffer = m_rangesBuffer = m_segmentRangesBuffer = m_partialsBuffer = VK_NULL_HANDLE;
+    m_valuesMemory = m_rangesMemory = m_segmentRangesMemory = m_partialsMemory = VK_NULL_HANDLE;
+    m_resultBuffer.destroy();
+
+    // Descriptor sets go away with the pool
+    BaseComputeTask::cleanup();
+}
+
+// --- "Fill-in-the-blank" Implementations ---
+
+std::string SegmentedReduceTask::getShaderPath() {
+    return "shaders/segmented_reduce.spv";
+}
+
+void SegmentedReduceTask::createDescriptorSetLayout() {
+    // 0 = input, 1 = ranges, 2 = one sum per item
+    std::vector<VkDescriptorSetLayoutBinding> bindings(3);
+    for (uint32_t i = 0; i < bindings.size(); i++) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+    if (vkCreateDescriptorSetLayout(m_context->getDevice(), &layoutInfo, nullptr, &m_descriptorSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create descriptor set layout!");
+    }
+}
+
+void SegmentedReduceTask::createBuffers() {
+    // Inputs never change after init, so they live in GPU memory (filled via the upload ring)
+    createStagingBuffer(m_valuesBuffer, m_valuesMemory, sizeof(float) * m_values.size(), m_values.data());
+
+    // Uniform segments need no ranges, but binding 1 must still point at a buffer
+    std::vector<uint32_t> itemRanges = m_itemRanges;
+    if (itemRanges.empty()) itemRanges.assign(2, 0);
+    createStagingBuffer(m_rangesBuffer, m_rangesMemory, sizeof(uint32_t) * itemRanges.size(), itemRanges.data());
+
+    if (m_mapping == SegmentMapping::SPLIT_SEGMENTS) {
+        createStagingBuffer(m_segmentRangesBuffer, m_segmentRangesMemory,
+                            sizeof(uint32_t) * m_segmentRanges.size(), m_segmentRanges.data());
+        createBuffer(m_partialsBuffer, m_partialsMemory, sizeof(float) * m_itemCount,
+                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryUsage::GPU_ONLY);
+    }
+
+    m_resultBuffer.create(m_context, sizeof(float) * m_segmentCount,
+                          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryUsage::READBACK);
+}
+
+void SegmentedReduceTask::createDescriptorPool() {
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = 6;
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    poolInfo.maxSets = 2;
+    if (vkCreateDescriptorPool(m_context->getDevice(), &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create descriptor pool!");
+    }
+}
+
+void SegmentedReduceTask::createDescriptorSet() {
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_descriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &m_descriptorSetLayout;
+    if (vkAllocateDescriptorSets(m_context->getDevice(), &allocInfo, &m_descriptorSet) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate descriptor set!");
+    }
+
+    if (m_mapping != SegmentMapping::SPLIT_SEGMENTS) {
+        // One pass: values -> sums
+        writeDescriptorSet(m_descriptorSet, m_valuesBuffer, m_rangesBuffer, m_resultBuffer.getBuffer());
+        return;
+    }
+
+    // Pass 1: values -> partials (one per chunk); pass 2: partials -> sums
+    if (vkAllocateDescriptorSets(m_context->getDevice(), &allocInfo, &m_reduceSet) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate descriptor set!");
+    }
+    writeDescriptorSet(m_descriptorSet, m_valuesBuffer, m_rangesBuffer, m_partialsBuffer);
+    writeDescriptorSet(m_reduceSet, m_partialsBuffer, m_segmentRangesBuffer, m_resultBuffer.getBuffer());
+}
+
+void SegmentedReduceTask::writeDescriptorSet(VkDescriptorSet set, VkBuffer in, VkBuffer ranges, VkBuffer out) {
+    VkBuffer buffers[3] = {in, ranges, out};
+    VkDescriptorBufferInfo bufferInfos[3]{};
+    std::vector<VkWriteDescriptorSet> writes(3);
+    for (uint32_t i = 0; i < 3; i++) {
+        bufferInfos[i].buffer = buffers[i];
+        bufferInfos[i].offset = 0;
+        bufferInfos[i].range = VK_WHOLE_SIZE;
+
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = set;
+        writes[i].dstBinding = i;
+        writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[i].descriptorCount = 1;
+        writes[i].pBufferInfo = &bufferInfos[i];
+    }
+    vkUpdateDescriptorSets(m_context->getDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+}
+
+// --- Dispatch ---
+
+long long SegmentedReduceTask::dispatch() {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    double submitUs = GpuProfiler::nowUs();
+    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+    record(commandBuffer);
+    endSingleTimeCommands(commandBuffer);
+    m_hostSubmitUs = submitUs;
+    m_hostCompleteUs = GpuProfiler::nowUs();
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+
+    return duration.count(); // Return the CPU-side time; the caller reads the sums back with readResult()
+}
+
+void SegmentedReduceTask::record(VkCommandBuffer commandBuffer) {
+    m_hostSubmitUs = -1.0; // Whoever submits this may not be dispatch()
+    m_hostCompleteUs = -1.0;
+    m_profiler.reset(commandBuffer);
+    uint32_t region = m_profiler.beginRegion(commandBuffer, "reduce");
+
+    VkBuffer results = m_resultBuffer.getBuffer();
+    bool split = (m_mapping == SegmentMapping::SPLIT_SEGMENTS);
+    m_graph.clear();
+
+    // --- 1. Pass 1: segments (or chunks of them) -> one sum each ---
+    SegmentPushData pushData{};
+    pushData.mode = (m_mapping == SegmentMapping::THREAD_PER_SEGMENT) ? 1 : 0;
+    pushData.itemCount = m_itemCount;
+    pushData.segmentLength = m_itemRanges.empty() ? m_segmentLength : 0;
+    pushData.totalElements = static_cast<uint32_t>(m_values.size());
+    m_graph.addDispatch("segments", m_pipeline, m_pipelineLayout, m_descriptorSet, &pushData, sizeof(SegmentPushData),
+                        groupCount(pushData.mode, pushData.itemCount),
+                        {{m_valuesBuffer, GraphAccess::READ}, {m_rangesBuffer, GraphAccess::READ},
+                         {split ? m_partialsBuffer : results, GraphAccess::WRITE}});
+
+    // --- 2. Pass 2 (split only): each segment's chunk partials -> its sum ---
+    if (split) {
+        pushData.mode = 0;
+        pushData.itemCount = m_segmentCount;
+        pushData.segmentLength = 0;
+        pushData.totalElements = m_itemCount;
+        m_graph.addDispatch("partials", m_pipeline, m_pipelineLayout, m_reduceSet, &pushData, sizeof(SegmentPushData),
+                            groupCount(0, m_segmentCount),
+                            {{m_partialsBuffer, GraphAccess::READ}, {m_segmentRangesBuffer, GraphAccess::READ},
+                             {results, GraphAccess::WRITE}});
+    }
+
+    // --- 3. Make the sums visible to the host ---
+    m_graph.addHostRead(results);
+    m_graph.record(commandBuffer);
+
+    m_profiler.endRegion(commandBuffer, region);
+}
+
+TaskResult SegmentedReduceTask::readResult() {
+    TaskResult result;
+
+    // Non-coherent (e.g. HOST_CACHED) memory must be invalidated before the CPU reads it
+    m_resultBuffer.invalidate();
+    const float* sums = m_resultBuffer.data<float>();
+    m_results.assign(sums, sums + m_segmentCount);
+
+    for (uint32_t s = 0; s < m_segmentCount; s++) {
+        result.value += m_results[s];
+        if (std::fabs(m_results[s] - m_expected[s]) > m_tolerances[s]) {
+            if (result.valid) {
+                LOGE("Segment %u: %.3f (Expected: %.3f)", s, m_results[s], m_expected[s]);
+            }
+            result.valid = false;
+        }
+    }
+
+    // <0 unless every reading passed the profiler's checks (valid bits, availability, order, CPU bracket)
+    result.gpuTimeUs = m_profiler.resolve(m_hostSubmitUs, m_hostCompleteUs).durationUs("reduce");
+    return result;
+}
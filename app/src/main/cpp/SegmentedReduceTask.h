@@ -0,0 +1,106 @@
+#pragma once
+
+#include "BaseComputeTask.h"
+#include "MappedBuffer.h"
+#include "ComputeGraph.h"
+#include <vector>
+
+// This struct MUST match the layout in segmented_reduce.comp
+struct SegmentPushData {
+    uint32_t mode;          // 0 = workgroup per item, 1 = thread per item
+    uint32_t itemCount;
+    uint32_t segmentLength; // > 0: uniform items, no range buffer
+    uint32_t totalElements;
+};
+
+// How segments are mapped onto the GPU, picked from the length distribution
+enum class SegmentMapping {
+    THREAD_PER_SEGMENT,    // Many tiny segments: one invocation sums a whole segment
+    WORKGROUP_PER_SEGMENT, // Typical: one workgroup per segment, one dispatch
+    SPLIT_SEGMENTS         // Few large segments: chunks -> partials, then partials -> sums (two dispatches)
+};
+
+// Reduces many independent segments of one packed values buffer in one or two
+// dispatches, writing one sum per segment. Segment i is
+// values[offsets[i], offsets[i + 1]), or values[i * len, (i + 1) * len) with a
+// uniform length (the last segment may be shorter).
+//
+// Replaces one task (and one ~600 us submit/wait) per small array.
+class SegmentedReduceTask : public BaseComputeTask {
+public:
+    SegmentedReduceTask(AAssetManager* assetManager, std::vector<float> values, std::vector<uint32_t> offsets);
+    SegmentedReduceTask(AAssetManager* assetManager, std::vector<float> values, uint32_t segmentLength);
+    ~SegmentedReduceTask();
+
+    // --- ComputeTask Interface ---
+    void init() override;
+    long long dispatch() override;
+    void cleanup() override;
+
+    // --- Batching ---
+    bool isRecordable() override { return true; }
+    void record(VkCommandBuffer commandBuffer) override;
+    // value = sum of all segments; valid = every segment matches the CPU reference
+    TaskResult readResult() override;
+
+    // Per-segment sums of the last readResult()
+    const std::vector<float>& getResults() const { return m_results; }
+    uint32_t getSegmentCount() const { return m_segmentCount; }
+    SegmentMapping getMapping() const { return m_mapping; }
+    static const char* getMappingName(SegmentMapping mapping);
+
+protected:
+    // --- BaseComputeTask "Fill-in-the-blanks" ---
+    std::string getShaderPath() override;
+    void createDescriptorSetLayout() override;
+    void createBuffers() override;
+    void createDescriptorPool() override;
+    void createDescriptorSet() override;
+
+private:
+    // Validates the segments, computes the CPU reference and picks the mapping
+    void planMapping();
+    void writeDescriptorSet(VkDescriptorSet set, VkBuffer in, VkBuffer ranges, VkBuffer out);
+    uint32_t groupCount(uint32_t mode, uint32_t itemCount) const;
+
+    // --- Segments ---
+    std::vector<float> m_values;
+    std::vector<uint32_t> m_offsets;  // Empty when the length is uniform
+    uint32_t m_segmentLength = 0;
+    uint32_t m_segmentCount = 0;
+    std::vector<double> m_expected;   // CPU reference sums
+    std::vector<double> m_tolerances; // Per segment, scaled by its sum of magnitudes
+    std::vector<float> m_results;
+
+    // --- Mapping ---
+    SegmentMapping m_mapping = SegmentMapping::WORKGROUP_PER_SEGMENT;
+    std::vector<uint32_t> m_itemRanges;    // Pass 1 (begin, end) pairs; empty when uniform
+    std::vector<uint32_t> m_segmentRanges; // Pass 2 chunk ranges per segment (split only)
+    uint32_t m_itemCount = 0;              // Pass 1 work items (segments or chunks)
+
+    // --- Buffers ---
+    VkBuffer m_valuesBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory m_valuesMemory = VK_NULL_HANDLE;
+    VkBuffer m_rangesBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory m_rangesMemory = VK_NULL_HANDLE;
+    VkBuffer m_segmentRangesBuffer = VK_NULL_HANDLE; // Split only
+    VkDeviceMemory m_segmentRangesMemory = VK_NULL_HANDLE;
+    VkBuffer m_partialsBuffer = VK_NULL_HANDLE;      // Split only
+    VkDeviceMemory m_partialsMemory = VK_NULL_HANDLE;
+    MappedBuffer m_resultBuffer;
+
+    VkDescriptorSet m_reduceSet = VK_NULL_HANDLE; // Pass 2: partials -> sums
+    ComputeGraph m_graph;
+
+    // "reduce" region, checked against dispatch()'s CPU-side bracket
+    GpuProfiler m_profiler;
+    double m_hostSubmitUs = -1.0;
+    double m_hostCompleteUs = -1.0;
+
+    static const uint32_t WORKGROUP_SIZE = 256;
+    static constexpr uint32_t MAX_GROUPS = 65535;          // Spec minimum for maxComputeWorkGroupCount[0]
+    static const uint32_t THREAD_SEGMENT_MAX = 64;     // Longest segment one invocation sums alone
+    static const uint32_t TARGET_WORKGROUPS = 256;     // Enough to fill a mobile GPU
+    static constexpr uint32_t MIN_CHUNK = WORKGROUP_SIZE * 4;
+    static constexpr uint32_t MAX_CHUNK = WORKGROUP_SIZE * 64;
+};
@@ -0,0 +1,530 @@
+#include "StreamingReduceTask.h"
+#include <vector>
+#include <stdexcept>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+StreamingReduceTask::StreamingReduceTask(AAssetManager* assetManager, uint32_t n,
+                                         uint32_t slotCount, uint32_t iterations, uint32_t queueCount)
+        : BaseComputeTask(assetManager), m_n(n), m_slotCount(slotCount), m_iterations(iterations), m_queueCount(queueCount) {
+    if (m_slotCount < 2) m_slotCount = 2;
+    if (m_slotCount > MAX_SLOTS) m_slotCount = MAX_SLOTS;
+    // More queues than slots (or than the device has) cannot add concurrency
+    m_queueCount = std::max(1u, std::min({m_queueCount, m_slotCount, m_context->getComputeQueueCount()}));
+    LOGI("StreamingReduceTask created. N=%u, Slots=%u, Queues=%u", m_n, m_slotCount, m_queueCount);
+    m_gpuTimestampPeriod = m_context->getTimeStampPeriod();
+}
+
+StreamingReduceTask::~StreamingReduceTask() {
+    LOGI("StreamingReduceTask destroyed");
+}
+
+// --- Overridden init() ---
+void StreamingReduceTask::init() {
+    LOGI("StreamingReduceTask::init() starting...");
+    m_slots.resize(m_slotCount);
+
+    m_pattern.resize(m_n);
+    InputGenerator::hostFill(m_distribution, m_pattern.data(), m_n);
+    double absSum = 0.0;
+    InputGenerator::hostReference(m_distribution, m_n, m_expected, absSum);
+    m_tolerance = std::max(0.01, 1e-4 * absSum);
+
+    createBuffers();
+    createDescriptorSetLayout();
+    createDescriptorPool();
+    createDescriptorSet();
+
+    createPipelineLayout(sizeof(PushData));
+    m_pipeline = createComputePipeline(getShaderPath());
+
+    VkDevice device = m_context->getDevice();
+
+    // One command buffer per slot, recorded once and re-submitted every iteration
+    VkCommandPoolCreateInfo commandPoolInfo{};
+    commandPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    commandPoolInfo.queueFamilyIndex = m_context->getComputeQueueFamilyIndex();
+    if (vkCreateCommandPool(device, &commandPoolInfo, nullptr, &m_commandPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create streaming command pool!");
+    }
+
+    std::vector<VkCommandBuffer> commandBuffers(m_slotCount);
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandPool = m_commandPool;
+    allocInfo.commandBufferCount = m_slotCount;
+    if (vkAllocateCommandBuffers(device, &allocInfo, commandBuffers.data()) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate streaming command buffers!");
+    }
+
+    // Staged inputs go through the transfer queue when the device has a dedicated one
+    bool transferUploads = m_context->hasDedicatedTransferQueue() && !m_slots[0].bufferA.isDirect();
+    if (transferUploads) {
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.queueFamilyIndex = m_context->getTransferQueueFamilyIndex();
+        if (vkCreateCommandPool(device, &poolInfo, nullptr, &m_transferPool) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create transfer command pool!");
+        }
+    }
+
+    for (uint32_t i = 0; i < m_slotCount; i++) {
+        Slot& slot = m_slots[i];
+        slot.commandBuffer = commandBuffers[i];
+        slot.queue = m_context->getComputeQueue((m_queueIndex + i) % m_queueCount);
+
+        if (transferUploads) {
+            VkCommandBufferAllocateInfo uploadAllocInfo{};
+            uploadAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            uploadAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            uploadAllocInfo.commandPool = m_transferPool;
+            uploadAllocInfo.commandBufferCount = 1;
+            if (vkAllocateCommandBuffers(device, &uploadAllocInfo, &slot.uploadCommandBuffer) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to allocate slot upload command buffer!");
+            }
+            VkSemaphoreCreateInfo semaphoreInfo{};
+            semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+            if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &slot.uploadDone) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to create slot upload semaphore!");
+            }
+
+            // Recorded once: copy the whole staging buffer and release it to compute
+            VkCommandBufferBeginInfo beginInfo{};
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            vkBeginCommandBuffer(slot.uploadCommandBuffer, &beginInfo);
+            slot.bufferA.recordTransferUpload(slot.uploadCommandBuffer);
+            vkEndCommandBuffer(slot.uploadCommandBuffer);
+        }
+
+        if (m_gpuTimestampPeriod > 0) {
+            VkQueryPoolCreateInfo queryPoolInfo{};
+            queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+            queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+            queryPoolInfo.queryCount = 2; // Start, end
+            if (vkCreateQueryPool(device, &queryPoolInfo, nullptr, &slot.queryPool) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to create slot query pool!");
+            }
+        }
+
+        recordSlot(slot);
+    }
+
+    LOGI("StreamingReduceTask::init() finished.");
+}
+
+void StreamingReduceTask::cleanup() {
+    LOGI("StreamingReduceTask::cleanup()");
+    for (Slot& slot : m_slots) {
+        if (slot.inFlight) {
+            slot.ticket.wait();
+            slot.inFlight = false;
+        }
+    }
+    cleanupSlots();
+
+    BaseComputeTask::cleanup();
+}
+
+void StreamingReduceTask::cleanupSlots() {
+    VkDevice device = m_context->getDevice();
+    for (Slot& slot : m_slots) {
+        if (slot.uploadDone != VK_NULL_HANDLE) vkDestroySemaphore(device, slot.uploadDone, nullptr);
+        if (slot.queryPool != VK_NULL_HANDLE) vkDestroyQueryPool(device, slot.queryPool, nullptr);
+        slot.bufferA.destroy();
+        slot.bufferB.destroy();
+    }
+    // Descriptor sets go away with the pool in BaseComputeTask::cleanup()
+    m_slots.clear();
+
+    // Destroying the pools frees the slots' command buffers
+    if (m_commandPool != VK_NULL_HANDLE) {
+        vkDestroyCommandPool(device, m_commandPool, nullptr);
+        m_commandPool = VK_NULL_HANDLE;
+    }
+    if (m_transferPool != VK_NULL_HANDLE) {
+        vkDestroyCommandPool(device, m_transferPool, nullptr);
+        m_transferPool = VK_NULL_HANDLE;
+    }
+}
+
+// --- "Fill-in-the-blank" Implementations ---
+
+std::string StreamingReduceTask::getShaderPath() {
+    return "shaders/reduce_optimized.spv";
+}
+
+void StreamingReduceTask::createDescriptorSetLayout() {
+    std::vector<VkDescriptorSetLayoutBinding> bindings(2);
+    bindings[0].binding = 0;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    bindings[1].binding = 1;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[1].descriptorCount = 1;
+    bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+    if (vkCreateDescriptorSetLayout(m_context->getDevice(), &layoutInfo, nullptr, &m_descriptorSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create descriptor set layout!");
+    }
+}
+
+void StreamingReduceTask::createBuffers() {
+    VkDeviceSize dataSize = sizeof(float) * m_n;
+    uint32_t partialCount = (m_n + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+    VkDeviceSize intermediateSize = sizeof(float) * partialCount;
+
+    for (Slot& slot : m_slots) {
+        // The ring refills A through its persistent mapping every iteration
+        // (in place on unified memory, via the slot's staging buffer otherwise)
+        slot.bufferA.create(m_context, dataSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+        // The result is read back from B (or A), so cached memory helps here
+        slot.bufferB.create(m_context, intermediateSize,
+                            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                            MemoryUsage::READBACK);
+
+        fillSlot(slot);
+    }
+}
+
+void StreamingReduceTask::createDescriptorPool() {
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = 4 * m_slotCount;
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    poolInfo.maxSets = 2 * m_slotCount;
+    if (vkCreateDescriptorPool(m_context->getDevice(), &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create descriptor pool!");
+    }
+}
+
+void StreamingReduceTask::createDescriptorSet() {
+    VkDevice device = m_context->getDevice();
+
+    for (Slot& slot : m_slots) {
+        VkDescriptorSetLayout layouts[2] = {m_descriptorSetLayout, m_descriptorSetLayout};
+        VkDescriptorSet sets[2];
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = m_descriptorPool;
+        allocInfo.descriptorSetCount = 2;
+        allocInfo.pSetLayouts = layouts;
+        if (vkAllocateDescriptorSets(device, &allocInfo, sets) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to allocate slot descriptor sets!");
+        }
+        slot.setA_to_B = sets[0];
+        slot.setB_to_A = sets[1];
+
+        VkDescriptorBufferInfo bufferInfoA{};
+        bufferInfoA.buffer = slot.bufferA.getBuffer();
+        bufferInfoA.offset = 0;
+        bufferInfoA.range = VK_WHOLE_SIZE;
+        VkDescriptorBufferInfo bufferInfoB{};
+        bufferInfoB.buffer = slot.bufferB.getBuffer();
+        bufferInfoB.offset = 0;
+        bufferInfoB.range = VK_WHOLE_SIZE;
+
+        // A->B: binding 0 = A, binding 1 = B.  B->A: the reverse.
+        std::vector<VkWriteDescriptorSet> writes(4);
+        for (uint32_t i = 0; i < 4; i++) {
+            writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[i].dstSet = (i < 2) ? slot.setA_to_B : slot.setB_to_A;
+            writes[i].dstBinding = i % 2;
+            writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[i].descriptorCount = 1;
+        }
+        writes[0].pBufferInfo = &bufferInfoA;
+        writes[1].pBufferInfo = &bufferInfoB;
+        writes[2].pBufferInfo = &bufferInfoB;
+        writes[3].pBufferInfo = &bufferInfoA;
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+}
+
+// --- Slot Helpers ---
+
+void StreamingReduceTask::recordSlot(Slot& slot) {
+    VkCommandBuffer commandBuffer = slot.commandBuffer;
+
+    // No ONE_TIME_SUBMIT: this buffer is submitted once per iteration
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+    // (Host writes made before vkQueueSubmit are visible without a barrier)
+    if (slot.uploadCommandBuffer != VK_NULL_HANDLE) {
+        slot.bufferA.recordAcquire(commandBuffer); // Copied on the transfer queue
+    } else {
+        slot.bufferA.recordUpload(commandBuffer);
+    }
+
+    if (slot.queryPool != VK_NULL_HANDLE) {
+        vkCmdResetQueryPool(commandBuffer, slot.queryPool, 0, 2);
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, slot.queryPool, 0);
+    }
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline);
+
+    // --- Pass 1: Local Reduce (A -> B) ---
+    PushData pushData{};
+    pushData.passType = 0;
+    pushData.numElements = m_n;
+    vkCmdPushConstants(commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushData), &pushData);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout, 0, 1, &slot.setA_to_B, 0, nullptr);
+    uint32_t numWorkgroups = (m_n + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+    vkCmdDispatch(commandBuffer, numWorkgroups, 1, 1);
+
+    // --- Pass 2...N: 256-to-1 tree passes, ping-ponging B <-> A ---
+    bool readFromB_writeToA = true;
+    while (numWorkgroups > 1) {
+        addBufferBarrier(commandBuffer, readFromB_writeToA ? slot.bufferB.getBuffer() : slot.bufferA.getBuffer(),
+                         VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+        pushData.passType = 1;
+        pushData.numElements = numWorkgroups;
+        vkCmdPushConstants(commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushData), &pushData);
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout, 0, 1,
+                                readFromB_writeToA ? &slot.setB_to_A : &slot.setA_to_B, 0, nullptr);
+
+        numWorkgroups = (numWorkgroups + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+        vkCmdDispatch(commandBuffer, numWorkgroups, 1, 1);
+        readFromB_writeToA = !readFromB_writeToA;
+    }
+
+    // After the last pass, the result lives in whatever was written last
+    bool resultInA = !readFromB_writeToA;
+    slot.result = &slot.bufferB;
+    if (resultInA && !slot.bufferA.isDirect()) {
+        // A is device-only memory: move the sum into B[0]
+        recordResultCopy(commandBuffer, slot.bufferA.getBuffer(), slot.bufferB.getBuffer(), sizeof(float));
+    } else {
+        if (resultInA) slot.result = &slot.bufferA.getHostBuffer();
+        addBufferBarrier(commandBuffer, slot.result->getBuffer(),
+                         VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_HOST_READ_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_HOST_BIT);
+    }
+
+    if (slot.queryPool != VK_NULL_HANDLE) {
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, slot.queryPool, 1);
+    }
+
+    vkEndCommandBuffer(commandBuffer);
+}
+
+void StreamingReduceTask::fillSlot(Slot& slot) {
+    // One streaming write of the input into this slot's mapping
+    std::copy(m_pattern.begin(), m_pattern.end(), slot.bufferA.data<float>());
+    slot.bufferA.flush();
+}
+
+void StreamingReduceTask::submitSlot(Slot& slot) {
+    SubmitQueue* submitQueue = m_context->getSubmitQueue();
+
+    SubmitRequest compute;
+    compute.queue = slot.queue;
+    compute.commandBuffers.push_back(slot.commandBuffer);
+
+    if (slot.uploadCommandBuffer != VK_NULL_HANDLE) {
+        // Upload on the transfer queue; the compute submit waits for it on the GPU, not the CPU.
+        // Pushed first, so the signal is always submitted before the wait.
+        SubmitRequest upload;
+        upload.queue = m_context->getTransferQueue();
+        upload.commandBuffers.push_back(slot.uploadCommandBuffer);
+        upload.signalSemaphores.push_back(slot.uploadDone);
+        submitQueue->submit(std::move(upload));
+
+        compute.waitSemaphores.push_back(slot.uploadDone);
+        compute.waitStages.push_back(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+    }
+
+    slot.ticket = submitQueue->submit(std::move(compute));
+    slot.inFlight = true;
+}
+
+double StreamingReduceTask::collectSlot(Slot& slot, StreamingStats& stats, long long& waitUs) {
+    VkDevice device = m_context->getDevice();
+
+    auto waitStart = std::chrono::high_resolution_clock::now();
+    slot.ticket.wait();
+    auto waitEnd = std::chrono::high_resolution_clock::now();
+    waitUs += std::chrono::duration_cast<std::chrono::microseconds>(waitEnd - waitStart).count();
+    slot.inFlight = false;
+
+    slot.result->invalidate(0, sizeof(float));
+    float result = *slot.result->data<float>();
+    if (std::fabs(result - m_expected) > m_tolerance) {
+        LOGE("Streaming result mismatch: %.3f (Expected: %.3f)", result, m_expected);
+        stats.allCorrect = false;
+    }
+
+    if (slot.queryPool == VK_NULL_HANDLE) {
+        return -1.0;
+    }
+    uint64_t timestamps[2] = {0, 0};
+    VkResult queryResult = vkGetQueryPoolResults(device, slot.queryPool, 0, 2,
+                                                 sizeof(timestamps), timestamps, sizeof(uint64_t),
+                                                 VK_QUERY_RESULT_64_BIT);
+    // PowerVR has been seen returning 0 or repeating values; treat those as unknown
+    if (queryResult != VK_SUCCESS || timestamps[0] == 0 || timestamps[1] <= timestamps[0]) {
+        return -1.0;
+    }
+    return (double)(timestamps[1] - timestamps[0]) * m_gpuTimestampPeriod / 1000.0;
+}
+
+// --- Iteration Loops ---
+
+StreamingStats StreamingReduceTask::runSerial(uint32_t iterations) {
+    StreamingStats stats;
+    stats.iterations = iterations;
+    stats.queueCount = 1;
+    Slot& slot = m_slots[0];
+
+    long long fillUs = 0;
+    long long waitUs = 0;
+    double gpuUs = 0.0;
+    uint32_t gpuSamples = 0;
+    const uint32_t rampUp = 1;
+    std::chrono::high_resolution_clock::time_point steadyStart;
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < iterations; i++) {
+        if (i == rampUp) steadyStart = std::chrono::high_resolution_clock::now();
+
+        // 1. Refill (GPU idle)
+        auto fillStart = std::chrono::high_resolution_clock::now();
+        fillSlot(slot);
+        auto fillEnd = std::chrono::high_resolution_clock::now();
+        fillUs += std::chrono::duration_cast<std::chrono::microseconds>(fillEnd - fillStart).count();
+
+        // 2. Submit and wait (CPU idle)
+        submitSlot(slot);
+        double slotGpuUs = collectSlot(slot, stats, waitUs);
+        if (slotGpuUs >= 0.0) {
+            gpuUs += slotGpuUs;
+            gpuSamples++;
+        }
+    }
+    auto endTime = std::chrono::high_resolution_clock::now();
+
+    stats.totalTimeUs = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+    if (iterations > rampUp) {
+        double steadyUs = (double)std::chrono::duration_cast<std::chrono::microseconds>(endTime - steadyStart).count();
+        stats.iterationsPerSecond = steadyUs > 0 ? (iterations - rampUp) * 1.0e6 / steadyUs : 0.0;
+    }
+    stats.avgHostFillUs = iterations ? (double)fillUs / iterations : 0.0;
+    stats.avgHostWaitUs = iterations ? (double)waitUs / iterations : 0.0;
+
+    // In the serial loop the fence wait is an upper bound on GPU busy time
+    m_serialGpuUs = stats.avgHostWaitUs;
+    stats.gpuTimeFromTimestamps = gpuSamples == iterations && iterations > 0;
+    stats.avgGpuUs = stats.gpuTimeFromTimestamps ? gpuUs / gpuSamples : m_serialGpuUs;
+    stats.gpuUtilization = stats.totalTimeUs > 0 ? stats.avgGpuUs * iterations / (double)stats.totalTimeUs : 0.0;
+    return stats;
+}
+
+StreamingStats StreamingReduceTask::runStreaming(uint32_t iterations) {
+    StreamingStats stats;
+    stats.iterations = iterations;
+    stats.queueCount = m_queueCount;
+
+    long long fillUs = 0;
+    long long waitUs = 0;
+    double gpuUs = 0.0;
+    uint32_t gpuSamples = 0;
+    // The ring is only in steady state once every slot has been submitted
+    const uint32_t rampUp = m_slotCount;
+    std::chrono::high_resolution_clock::time_point steadyStart;
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < iterations; i++) {
+        if (i == rampUp) steadyStart = std::chrono::high_resolution_clock::now();
+        Slot& slot = m_slots[i % m_slotCount];
+
+        // 1. Reclaim the slot (its previous reduction has had a whole ring to finish)
+        if (slot.inFlight) {
+            double slotGpuUs = collectSlot(slot, stats, waitUs);
+            if (slotGpuUs >= 0.0) {
+                gpuUs += slotGpuUs;
+                gpuSamples++;
+            }
+        }
+
+        // 2. Refill it while the GPU works on the other slots
+        auto fillStart = std::chrono::high_resolution_clock::now();
+        fillSlot(slot);
+        auto fillEnd = std::chrono::high_resolution_clock::now();
+        fillUs += std::chrono::duration_cast<std::chrono::microseconds>(fillEnd - fillStart).count();
+
+        // 3. Hand it to the GPU without waiting
+        submitSlot(slot);
+    }
+
+    // Drain the ring in submission order
+    for (uint32_t i = 0; i < m_slotCount; i++) {
+        Slot& slot = m_slots[(iterations + i) % m_slotCount];
+        if (slot.inFlight) {
+            double slotGpuUs = collectSlot(slot, stats, waitUs);
+            if (slotGpuUs >= 0.0) {
+                gpuUs += slotGpuUs;
+                gpuSamples++;
+            }
+        }
+    }
+    auto endTime = std::chrono::high_resolution_clock::now();
+
+    stats.totalTimeUs = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+    if (iterations > rampUp) {
+        double steadyUs = (double)std::chrono::duration_cast<std::chrono::microseconds>(endTime - steadyStart).count();
+        stats.iterationsPerSecond = steadyUs > 0 ? (iterations - rampUp) * 1.0e6 / steadyUs : 0.0;
+    }
+    stats.avgHostFillUs = iterations ? (double)fillUs / iterations : 0.0;
+    stats.avgHostWaitUs = iterations ? (double)waitUs / iterations : 0.0;
+
+    stats.gpuTimeFromTimestamps = gpuSamples == iterations && iterations > 0;
+    if (stats.gpuTimeFromTimestamps) {
+        stats.avgGpuUs = gpuUs / gpuSamples;
+    } else {
+        // Fall back to the serial loop's measurement; without one the busy time is unknown
+        stats.avgGpuUs = m_serialGpuUs;
+    }
+    stats.gpuUtilization = stats.totalTimeUs > 0 && stats.avgGpuUs >= 0.0
+                               ? stats.avgGpuUs * iterations / (double)stats.totalTimeUs
+                               : -1.0;
+    return stats;
+}
+
+long long StreamingReduceTask::dispatch() {
+    StreamingStats stats = runStreaming(m_iterations);
+    logStats("STREAMING", stats);
+    return stats.totalTimeUs;
+}
+
+void StreamingReduceTask::logStats(const char* label, const StreamingStats& stats) {
+    LOGI("--- %s (%u iterations, %u queue(s)) ---", label, stats.iterations, stats.queueCount);
+    LOGI("Total Loop Time: %lld us", stats.totalTimeUs);
+    LOGI("Steady-State Throughput: %.1f iterations/s", stats.iterationsPerSecond);
+    LOGI("Avg Host Fill: %.1f us, Avg Fence Wait: %.1f us", stats.avgHostFillUs, stats.avgHostWaitUs);
+    if (stats.gpuUtilization < 0.0) {
+        LOGI("Avg GPU Time: unknown (no timestamps and no serial run to estimate from)");
+        LOGI("GPU Utilization: unknown");
+    } else {
+        LOGI("Avg GPU Time: %.1f us (%s)", stats.avgGpuUs,
+             stats.gpuTimeFromTimestamps ? "timestamps" : "serial fence-wait estimate");
+        LOGI("GPU Utilization: %.1f%%", stats.gpuUtilization * 100.0);
+    }
+    if (stats.allCorrect) {
+        LOGI("SUCCESS");
+    } else {
+        LOGE("FAILED");
+    }
+}
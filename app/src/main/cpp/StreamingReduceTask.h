@@ -0,0 +1,116 @@
+#pragma once
+
+#include "BaseComputeTask.h"
+#include "GpuOptimizedReduceTask.h" // For PushData (same reduce_optimized.comp layout)
+#include "MappedBuffer.h"
+#include "SubmitQueue.h"
+#include "InputGenerator.h"
+#include <vector>
+
+// Results of one iterative run (serial or streaming)
+struct StreamingStats {
+    uint32_t iterations = 0;
+    uint32_t queueCount = 1;          // Compute queues the slots were spread over
+    long long totalTimeUs = 0;        // Wall time of the whole loop
+    double iterationsPerSecond = 0.0; // Steady state (ramp-up iterations excluded)
+    double avgHostFillUs = 0.0;       // CPU time spent refilling inputs
+    double avgHostWaitUs = 0.0;       // CPU time spent blocked on fences
+    double avgGpuUs = 0.0;            // GPU busy time per iteration (<0 if unknown)
+    double gpuUtilization = 0.0;      // GPU busy time / wall time (<0 if unknown)
+    bool gpuTimeFromTimestamps = false;
+    bool allCorrect = true;
+};
+
+// Iterative reduction that keeps the GPU fed.
+//
+// The serial loop (reset() then dispatch()) leaves the GPU idle while the
+// host refills the input. This task owns a ring of 2-3 "slots", each with its
+// own input buffer, ping-pong buffer, descriptor sets, pre-recorded command
+// buffer and fence. The host fills slot k+1 while the GPU reduces slot k, and
+// results are collected when a slot's fence signals.
+//
+// Multi-queue: with queueCount > 1 the slots are spread round-robin over the
+// context's compute queues, so independent reductions can overlap on the GPU.
+// On discrete GPUs with a dedicated transfer queue, each slot's input upload
+// runs there (release/acquire + a semaphore) instead of inside the compute
+// command buffer.
+class StreamingReduceTask : public BaseComputeTask {
+public:
+    StreamingReduceTask(AAssetManager* assetManager, uint32_t n,
+                        uint32_t slotCount = 2, uint32_t iterations = 100, uint32_t queueCount = 1);
+    ~StreamingReduceTask();
+
+    // --- ComputeTask Interface ---
+    void init() override;
+    long long dispatch() override; // Runs the streaming loop, returns total time
+    void cleanup() override;
+
+    // Baseline: fill, submit, wait (GPU idles during the fill)
+    StreamingStats runSerial(uint32_t iterations);
+    // Ring: fill slot k+1 while the GPU reduces slot k
+    StreamingStats runStreaming(uint32_t iterations);
+
+    static void logStats(const char* label, const StreamingStats& stats);
+
+    // Values the host streams in every iteration (call before init()). This task
+    // measures host -> GPU streaming, so the values are written by the CPU: the
+    // pattern is generated once and copied into each slot.
+    void setInputDistribution(const InputDistribution& distribution) { m_distribution = distribution; }
+
+protected:
+    // --- BaseComputeTask "Fill-in-the-blanks" ---
+    std::string getShaderPath() override;
+    void createDescriptorSetLayout() override;
+    void createBuffers() override;
+    void createDescriptorPool() override;
+    void createDescriptorSet() override;
+
+private:
+    struct Slot {
+        // Host sides stay mapped for the slot's lifetime
+        UploadBuffer bufferA; // Input / ping-pong (staged on discrete GPUs)
+        MappedBuffer bufferB; // Partials / ping-pong, read back by the host
+
+        VkDescriptorSet setA_to_B = VK_NULL_HANDLE;
+        VkDescriptorSet setB_to_A = VK_NULL_HANDLE;
+
+        VkQueue queue = VK_NULL_HANDLE;
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        // Transfer-queue upload (dedicated transfer queue + staged input only)
+        VkCommandBuffer uploadCommandBuffer = VK_NULL_HANDLE;
+        VkSemaphore uploadDone = VK_NULL_HANDLE;
+        SubmitTicket ticket; // Completion of the slot's last submission
+        VkQueryPool queryPool = VK_NULL_HANDLE;
+
+        bool inFlight = false;
+        const MappedBuffer* result = nullptr; // Where the host reads the final sum
+    };
+
+    void recordSlot(Slot& slot);
+    void fillSlot(Slot& slot);
+    void submitSlot(Slot& slot);
+    // Waits for the slot's ticket, verifies the result and returns GPU time (us, <0 if unknown)
+    double collectSlot(Slot& slot, StreamingStats& stats, long long& waitUs);
+
+    void cleanupSlots();
+
+    std::vector<Slot> m_slots;
+    uint32_t m_n;
+    uint32_t m_slotCount;
+    uint32_t m_iterations;
+    uint32_t m_queueCount;
+    InputDistribution m_distribution; // All 1.0 by default
+    std::vector<float> m_pattern;
+    double m_expected = 0.0;
+    double m_tolerance = 0.0;
+    // Task-owned pools: the slots' command buffers outlive any one calling thread
+    VkCommandPool m_commandPool = VK_NULL_HANDLE;
+    VkCommandPool m_transferPool = VK_NULL_HANDLE; // Only when uploads use the transfer queue
+    float m_gpuTimestampPeriod = 0.0f;
+
+    // Serial-loop GPU time, used as the busy estimate when timestamps are unusable (<0 until runSerial())
+    double m_serialGpuUs = -1.0;
+
+    static const uint32_t WORKGROUP_SIZE = 256;
+    static const uint32_t MAX_SLOTS = 3;
+};
@@ -0,0 +1,200 @@
+#include "SubmitQueue.h"
+#include "Trace.h"
+#include <stdexcept>
+#include <algorithm>
+#include <chrono>
+
+// --- SubmitFence / SubmitTicket ---
+
+SubmitFence::~SubmitFence() {
+    if (fence != VK_NULL_HANDLE) {
+        vkDestroyFence(device, fence, nullptr);
+    }
+}
+
+void SubmitTicket::wait() const {
+    if (!m_future.valid()) return;
+    TRACE_SCOPE("fence wait", "vulkan");
+    // get() blocks until the submitter has made the vkQueueSubmit call (and rethrows its errors)
+    const std::shared_ptr<SubmitFence>& submitFence = m_future.get();
+    vkWaitForFences(submitFence->device, 1, &submitFence->fence, VK_TRUE, UINT64_MAX);
+}
+
+bool SubmitTicket::isComplete() const {
+    if (!m_future.valid()) return true;
+    if (m_future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return false;
+    const std::shared_ptr<SubmitFence>& submitFence = m_future.get();
+    return vkGetFenceStatus(submitFence->device, submitFence->fence) == VK_SUCCESS;
+}
+
+// --- SubmitQueue ---
+
+void SubmitQueue::start(VulkanContext* context) {
+    m_context = context;
+    m_stopRequested = false;
+    m_thread = std::thread(&SubmitQueue::run, this);
+    LOGI("Submit queue started.");
+}
+
+void SubmitQueue::stop() {
+    if (!m_thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stopRequested = true;
+    }
+    m_wakeCondition.notify_one();
+    m_thread.join();
+
+    LOGI("Submit queue stopped: %llu requests in %llu vkQueueSubmit calls",
+         (unsigned long long)getRequestCount(), (unsigned long long)getSubmitCount());
+    m_context = nullptr;
+}
+
+SubmitTicket SubmitQueue::submit(VkQueue queue, VkCommandBuffer commandBuffer) {
+    SubmitRequest request;
+    request.queue = queue;
+    request.commandBuffers.push_back(commandBuffer);
+    return submit(std::move(request));
+}
+
+SubmitTicket SubmitQueue::submit(SubmitRequest request) {
+    Node* node = new Node();
+    node->request = std::move(request);
+    SubmitTicket ticket(node->promise.get_future().share());
+
+    // Lock-free push (Treiber stack). The submitter takes the whole list with
+    // one exchange, so there is no ABA problem on the pop side.
+    Node* head = m_head.load(std::memory_order_relaxed);
+    do {
+        node->next = head;
+    } while (!m_head.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+    m_requestCount.fetch_add(1, std::memory_order_relaxed);
+
+    // Only the push that makes the list non-empty can find the submitter asleep
+    if (head == nullptr) {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_wakeCondition.notify_one();
+    }
+    return ticket;
+}
+
+// --- Submitter Thread ---
+
+void SubmitQueue::run() {
+    TRACE_THREAD_NAME("submit queue");
+    while (true) {
+        bool stopping;
+        {
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            m_wakeCondition.wait(lock, [this] {
+                return m_stopRequested || m_head.load(std::memory_order_acquire) != nullptr;
+            });
+            stopping = m_stopRequested;
+        }
+
+        // Take everything pushed so far and restore push order
+        Node* list = m_head.exchange(nullptr, std::memory_order_acquire);
+        std::vector<Node*> ordered;
+        for (Node* node = list; node != nullptr; node = node->next) {
+            ordered.push_back(node);
+        }
+        std::reverse(ordered.begin(), ordered.end());
+
+        // Consecutive requests for the same queue share one vkQueueSubmit
+        std::vector<Node*> run;
+        for (Node* node : ordered) {
+            if (!run.empty() && run.front()->request.queue != node->request.queue) {
+                submitRun(run);
+                run.clear();
+            }
+            run.push_back(node);
+        }
+        if (!run.empty()) submitRun(run);
+        for (Node* node : ordered) delete node;
+
+        pruneInFlight(false);
+
+        if (stopping && m_head.load(std::memory_order_acquire) == nullptr) break;
+    }
+
+    pruneInFlight(true);
+    m_freeFences.clear();
+}
+
+void SubmitQueue::submitRun(const std::vector<Node*>& run) {
+    std::vector<VkSubmitInfo> submitInfos(run.size());
+    for (size_t i = 0; i < run.size(); i++) {
+        const SubmitRequest& request = run[i]->request;
+        submitInfos[i].sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfos[i].waitSemaphoreCount = static_cast<uint32_t>(request.waitSemaphores.size());
+        submitInfos[i].pWaitSemaphores = request.waitSemaphores.data();
+        submitInfos[i].pWaitDstStageMask = request.waitStages.data();
+        submitInfos[i].commandBufferCount = static_cast<uint32_t>(request.commandBuffers.size());
+        submitInfos[i].pCommandBuffers = request.commandBuffers.data();
+        submitInfos[i].signalSemaphoreCount = static_cast<uint32_t>(request.signalSemaphores.size());
+        submitInfos[i].pSignalSemaphores = request.signalSemaphores.data();
+    }
+
+    std::shared_ptr<SubmitFence> submitFence;
+    VkResult result = VK_ERROR_INITIALIZATION_FAILED;
+    try {
+        submitFence = acquireFence();
+        TRACE_SCOPE("vkQueueSubmit", "vulkan");
+        result = vkQueueSubmit(run.front()->request.queue, static_cast<uint32_t>(submitInfos.size()),
+                               submitInfos.data(), submitFence->fence);
+    } catch (const std::exception& e) {
+        LOGE("Submit queue: %s", e.what());
+    }
+    m_submitCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (result != VK_SUCCESS) {
+        LOGE("vkQueueSubmit failed with error code: %d", result);
+        for (Node* node : run) {
+            node->promise.set_exception(std::make_exception_ptr(std::runtime_error("Failed to submit command buffer!")));
+        }
+        return;
+    }
+
+    m_inFlight.push_back(submitFence);
+    for (Node* node : run) {
+        node->promise.set_value(submitFence);
+    }
+}
+
+std::shared_ptr<SubmitFence> SubmitQueue::acquireFence() {
+    if (!m_freeFences.empty()) {
+        std::shared_ptr<SubmitFence> submitFence = m_freeFences.back();
+        m_freeFences.pop_back();
+        return submitFence;
+    }
+
+    auto submitFence = std::make_shared<SubmitFence>();
+    submitFence->device = m_context->getDevice();
+    VkFenceCreateInfo fenceInfo{};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    if (vkCreateFence(submitFence->device, &fenceInfo, nullptr, &submitFence->fence) != VK_SUCCESS) {
+        submitFence->fence = VK_NULL_HANDLE;
+        throw std::runtime_error("Failed to create submit fence!");
+    }
+    return submitFence;
+}
+
+void SubmitQueue::pruneInFlight(bool waitAll) {
+    for (size_t i = 0; i < m_inFlight.size();) {
+        SubmitFence& submitFence = *m_inFlight[i];
+        if (waitAll) {
+            vkWaitForFences(submitFence.device, 1, &submitFence.fence, VK_TRUE, UINT64_MAX);
+        } else if (vkGetFenceStatus(submitFence.device, submitFence.fence) != VK_SUCCESS) {
+            i++;
+            continue;
+        }
+
+        // Reuse the fence only once no ticket can still wait on it
+        if (m_inFlight[i].use_count() == 1) {
+            vkResetFences(submitFence.device, 1, &submitFence.fence);
+            m_freeFences.push_back(m_inFlight[i]);
+        }
+        m_inFlight[i] = m_inFlight.back();
+        m_inFlight.pop_back();
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "VulkanContext.h"
+#include <vector>
+#include <memory>
+#include <future>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+// One submission: what a single VkSubmitInfo would hold
+struct SubmitRequest {
+    VkQueue queue = VK_NULL_HANDLE;
+    std::vector<VkCommandBuffer> commandBuffers;
+    std::vector<VkSemaphore> waitSemaphores;
+    std::vector<VkPipelineStageFlags> waitStages; // One per wait semaphore
+    std::vector<VkSemaphore> signalSemaphores;
+};
+
+// Fence shared by every request of one vkQueueSubmit call
+struct SubmitFence {
+    VkDevice device = VK_NULL_HANDLE;
+    VkFence fence = VK_NULL_HANDLE;
+    ~SubmitFence();
+};
+
+// Completion handle returned by SubmitQueue::submit()
+class SubmitTicket {
+public:
+    SubmitTicket() = default;
+
+    // Blocks until the request has been submitted AND has finished on the GPU
+    void wait() const;
+    // Non-blocking
+    bool isComplete() const;
+    bool isValid() const { return m_future.valid(); }
+
+private:
+    friend class SubmitQueue;
+    explicit SubmitTicket(std::shared_future<std::shared_ptr<SubmitFence>> future) : m_future(std::move(future)) {}
+
+    std::shared_future<std::shared_ptr<SubmitFence>> m_future;
+};
+
+// Multi-producer, single-consumer submission queue.
+//
+// VkQueue is externally synchronized, so instead of a lock around every
+// vkQueueSubmit, any thread pushes requests onto a lock-free list and one
+// submitter thread owns the queues. Each time it wakes it takes the whole
+// list, keeps submission order, and turns every run of consecutive requests
+// for the same VkQueue into ONE vkQueueSubmit with ONE fence.
+//
+// Requests from one thread are submitted in the order they were pushed, so
+// a semaphore signal pushed before its wait is always submitted first.
+class SubmitQueue {
+public:
+    SubmitQueue() = default;
+
+    void start(VulkanContext* context);
+    // Submits what is left, waits for all in-flight work and joins the thread
+    void stop();
+
+    SubmitTicket submit(SubmitRequest request);
+    SubmitTicket submit(VkQueue queue, VkCommandBuffer commandBuffer);
+
+    // Requests pushed / vkQueueSubmit calls made so far
+    uint64_t getRequestCount() const { return m_requestCount.load(std::memory_order_relaxed); }
+    uint64_t getSubmitCount() const { return m_submitCount.load(std::memory_order_relaxed); }
+
+private:
+    struct Node {
+        SubmitRequest request;
+        std::promise<std::shared_ptr<SubmitFence>> promise;
+        Node* next = nullptr;
+    };
+
+    void run();
+    // Submits one run of requests that target the same queue
+    void submitRun(const std::vector<Node*>& run);
+    std::shared_ptr<SubmitFence> acquireFence();
+    // Recycles the fences of finished batches nobody else is holding
+    void pruneInFlight(bool waitAll);
+
+    VulkanContext* m_context = nullptr;
+
+    // --- Lock-free producer side ---
+    std::atomic<Node*> m_head{nullptr}; // LIFO; the submitter reverses it
+    std::atomic<uint64_t> m_requestCount{0};
+    std::atomic<uint64_t> m_submitCount{0};
+
+    // --- Sleep / wake-up only (producers lock it only on an empty -> non-empty push) ---
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+    bool m_stopRequested = false;
+
+    // --- Submitter thread only ---
+    std::thread m_thread;
+    std::vector<std::shared_ptr<SubmitFence>> m_inFlight;
+    std::vector<std::shared_ptr<SubmitFence>> m_freeFences;
+};
@@ -0,0 +1,98 @@
+#include "TaskBatch.h"
+#include "SubmitQueue.h"
+#include <stdexcept>
+#include <chrono>
+#include <exception>
+
+TaskBatch::TaskBatch(VkQueue queue) {
+    m_context = VulkanContext::getInstance();
+    m_queue = (queue != VK_NULL_HANDLE) ? queue : m_context->getQueue();
+}
+
+void TaskBatch::add(ComputeTask* task) {
+    if (task == nullptr) {
+        throw std::runtime_error("TaskBatch::add() got a null task!");
+    }
+    m_tasks.push_back(task);
+}
+
+std::vector<TaskResult> TaskBatch::run() {
+    std::vector<TaskResult> results(m_tasks.size());
+    if (m_tasks.empty()) return results;
+
+    VkDevice device = m_context->getDevice();
+    VkCommandPool commandPool = m_context->getCommandPool();
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    // --- 1. Record every GPU task into its own command buffer ---
+    std::vector<size_t> gpuTasks;
+    for (size_t i = 0; i < m_tasks.size(); i++) {
+        if (m_tasks[i]->isRecordable()) gpuTasks.push_back(i);
+    }
+
+    SubmitRequest request;
+    request.queue = m_queue;
+    request.commandBuffers.resize(gpuTasks.size());
+    if (!gpuTasks.empty()) {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = commandPool;
+        allocInfo.commandBufferCount = static_cast<uint32_t>(gpuTasks.size());
+        if (vkAllocateCommandBuffers(device, &allocInfo, request.commandBuffers.data()) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to allocate batch command buffers!");
+        }
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        for (size_t i = 0; i < gpuTasks.size(); i++) {
+            vkBeginCommandBuffer(request.commandBuffers[i], &beginInfo);
+            m_tasks[gpuTasks[i]]->record(request.commandBuffers[i]);
+            vkEndCommandBuffer(request.commandBuffers[i]);
+        }
+    }
+
+    // --- 2. One submission for all of them (no wait yet) ---
+    SubmitTicket ticket;
+    if (!gpuTasks.empty()) {
+        ticket = m_context->getSubmitQueue()->submit(request);
+    }
+
+    // --- 3. CPU tasks overlap with the GPU ---
+    // A failure is rethrown only after the GPU is done with the command buffers
+    std::exception_ptr error;
+    try {
+        for (size_t i = 0; i < m_tasks.size(); i++) {
+            if (m_tasks[i]->isRecordable()) continue;
+            long long hostTimeUs = m_tasks[i]->dispatch();
+            results[i] = m_tasks[i]->readResult();
+            results[i].hostTimeUs = hostTimeUs;
+        }
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    // --- 4. One wait, then read back ---
+    if (!gpuTasks.empty()) {
+        try {
+            ticket.wait();
+        } catch (...) {
+            if (!error) error = std::current_exception();
+        }
+        vkFreeCommandBuffers(device, commandPool, static_cast<uint32_t>(request.commandBuffers.size()),
+                             request.commandBuffers.data());
+    }
+    if (error) std::rethrow_exception(error);
+    auto gpuDoneTime = std::chrono::high_resolution_clock::now();
+    long long gpuWallUs = std::chrono::duration_cast<std::chrono::microseconds>(gpuDoneTime - startTime).count();
+
+    for (size_t index : gpuTasks) {
+        results[index] = m_tasks[index]->readResult();
+        results[index].hostTimeUs = gpuWallUs; // Tasks of one submission finish together
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    m_lastRunTimeUs = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+    return results;
+}
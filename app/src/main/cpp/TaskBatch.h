@@ -0,0 +1,35 @@
+#pragma once
+
+#include "ComputeTask.h"
+#include <vector>
+
+// Runs many independent tasks with ONE vkQueueSubmit and ONE fence.
+//
+// Every recordable task records into its own command buffer; all of them go
+// out as a single submission and the host waits once. Tasks that cannot
+// record (CPU tasks) run through dispatch() on the calling thread while the
+// GPU works. Results come back in add() order.
+//
+// The tasks must already be init()'ed, must not share buffers, and should be
+// on the batch's queue (their init-time uploads are ordered on that queue).
+class TaskBatch {
+public:
+    // queue: where the batch is submitted (default: compute queue 0)
+    explicit TaskBatch(VkQueue queue = VK_NULL_HANDLE);
+
+    void add(ComputeTask* task);
+    void clear() { m_tasks.clear(); }
+    size_t size() const { return m_tasks.size(); }
+
+    // Records, submits once, waits once, then reads every task's result
+    std::vector<TaskResult> run();
+
+    // Wall time of the last run(), from the first record to the last readback
+    long long getLastRunTimeUs() const { return m_lastRunTimeUs; }
+
+private:
+    VulkanContext* m_context;
+    VkQueue m_queue;
+    std::vector<ComputeTask*> m_tasks;
+    long long m_lastRunTimeUs = 0;
+};
@@ -0,0 +1,254 @@
+#include "Trace.h"
+#include "GpuProfiler.h"
+#include "VulkanContext.h" // LOGI/LOGW
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    const char* category;
+    int64_t startNs;
+    int64_t durationNs; // <0: instant
+};
+
+// One timeline row. Only the thread holding it appends, so appends take no lock.
+struct ThreadBuffer {
+    static const size_t CHUNK_EVENTS = 1024;
+    static const size_t MAX_CHUNKS = 256; // 256K events per row, the rest is dropped
+
+    uint32_t rowId = 0;
+    const char* name = nullptr;
+    std::vector<std::unique_ptr<TraceEvent[]>> chunks;
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> dropped{0};
+
+    void append(const TraceEvent& event) {
+        uint64_t index = count.load(std::memory_order_relaxed);
+        size_t chunk = index / CHUNK_EVENTS;
+        if (chunk >= MAX_CHUNKS) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (chunk == chunks.size()) chunks.emplace_back(new TraceEvent[CHUNK_EVENTS]);
+        chunks[chunk][index % CHUNK_EVENTS] = event;
+        count.store(index + 1, std::memory_order_release);
+    }
+};
+
+struct TraceState {
+    std::mutex mutex; // Guards the lists below, not the appends
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::vector<ThreadBuffer*> freeBuffers; // Their threads exited
+    std::vector<TraceEvent> gpuEvents;      // From any thread that resolves a profile
+    std::set<std::string> names;            // intern()
+    uint64_t gpuDropped = 0;
+};
+
+TraceState& state() {
+    static TraceState* s = new TraceState(); // Never destroyed: threads may exit after static destruction
+    return *s;
+}
+
+// Hands the row back when the thread exits
+struct ThreadSlot {
+    ThreadBuffer* buffer = nullptr;
+    const char* name = nullptr; // Kept here until the thread first records
+    ~ThreadSlot() {
+        if (buffer == nullptr) return;
+        std::lock_guard<std::mutex> lock(state().mutex);
+        buffer->name = nullptr; // The next owner names the row
+        state().freeBuffers.push_back(buffer);
+    }
+};
+thread_local ThreadSlot t_slot;
+
+ThreadBuffer* threadBuffer() {
+    if (t_slot.buffer != nullptr) return t_slot.buffer;
+    TraceState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (!s.freeBuffers.empty()) {
+        t_slot.buffer = s.freeBuffers.back();
+        s.freeBuffers.pop_back();
+    } else {
+        s.buffers.emplace_back(new ThreadBuffer());
+        s.buffers.back()->rowId = static_cast<uint32_t>(s.buffers.size());
+        t_slot.buffer = s.buffers.back().get();
+    }
+    t_slot.buffer->name = t_slot.name;
+    return t_slot.buffer;
+}
+
+const int GPU_ROW = 0;
+const size_t MAX_GPU_EVENTS = 256 * 1024;
+
+void writeJsonString(FILE* file, const char* value) {
+    fputc('"', file);
+    for (const char* c = value; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') fputc('\\', file);
+        fputc(static_cast<unsigned char>(*c) < 0x20 ? ' ' : *c, file);
+    }
+    fputc('"', file);
+}
+
+void writeEvent(FILE* file, const TraceEvent& event, int pid, uint32_t tid, bool& first) {
+    fputs(first ? "\n" : ",\n", file);
+    first = false;
+    fputs("{\"name\":", file);
+    writeJsonString(file, event.name);
+    fputs(",\"cat\":", file);
+    writeJsonString(file, event.category);
+    // Chrome trace times are in us
+    if (event.durationNs >= 0) {
+        fprintf(file, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f", event.startNs / 1000.0, event.durationNs / 1000.0);
+    } else {
+        fprintf(file, ",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f", event.startNs / 1000.0);
+    }
+    fprintf(file, ",\"pid\":%d,\"tid\":%u}", pid, tid);
+}
+
+void writeName(FILE* file, const char* kind, int pid, uint32_t tid, const char* name, bool& first) {
+    fputs(first ? "\n" : ",\n", file);
+    first = false;
+    fprintf(file, "{\"name\":\"%s\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,\"args\":{\"name\":", kind, pid, tid);
+    writeJsonString(file, name);
+    fputs("}}", file);
+}
+
+} // namespace
+
+std::atomic<bool> Tracer::s_enabled{false};
+
+int64_t Tracer::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Tracer::start() {
+    TraceState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    for (auto& buffer : s.buffers) {
+        buffer->count.store(0, std::memory_order_relaxed);
+        buffer->dropped.store(0, std::memory_order_relaxed);
+    }
+    s.gpuEvents.clear();
+    s.gpuDropped = 0;
+    s_enabled.store(true);
+    LOGI("Tracer: recording");
+}
+
+void Tracer::stop() {
+    s_enabled.store(false);
+}
+
+// --- Recording ---
+
+void Tracer::complete(const char* name, const char* category, int64_t startNs, int64_t endNs) {
+    if (!isEnabled()) return;
+    threadBuffer()->append({name, category, startNs, endNs - startNs});
+}
+
+void Tracer::instant(const char* name, const char* category) {
+    if (!isEnabled()) return;
+    threadBuffer()->append({name, category, nowNs(), -1});
+}
+
+void Tracer::setThreadName(const char* name) {
+    // No row is taken for it: threads that never record while tracing cost nothing
+    t_slot.name = name;
+    if (t_slot.buffer != nullptr) t_slot.buffer->name = name;
+}
+
+void Tracer::gpuProfile(const GpuProfile& profile, double hostCompleteUs) {
+    if (!isEnabled() || profile.regions.empty()) return;
+
+    // Uncalibrated: the outermost regions end when the CPU saw the submission complete
+    double offsetUs = 0.0;
+    if (!profile.calibrated) {
+        if (hostCompleteUs < 0.0) return; // Nowhere to put it
+        double endUs = 0.0;
+        for (const GpuRegion& region : profile.regions) {
+            endUs = std::max(endUs, region.startUs + region.durationUs);
+        }
+        offsetUs = hostCompleteUs - endUs;
+    }
+
+    TraceState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    for (const GpuRegion& region : profile.regions) {
+        if (s.gpuEvents.size() >= MAX_GPU_EVENTS) {
+            s.gpuDropped++;
+            continue;
+        }
+        double startUs = profile.calibrated ? region.hostStartUs : offsetUs + region.startUs;
+        auto interned = s.names.insert(region.name).first;
+        const char* category = profile.trustworthy && region.plausible ? "gpu" : "gpu,untrusted";
+        s.gpuEvents.push_back({interned->c_str(), category, (int64_t)(startUs * 1000.0),
+                               (int64_t)(std::max(0.0, region.durationUs) * 1000.0)});
+    }
+}
+
+const char* Tracer::intern(const std::string& name) {
+    TraceState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.names.insert(name).first->c_str();
+}
+
+// --- Export ---
+
+bool Tracer::writeChromeJson(const std::string& path) {
+    FILE* file = fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        LOGW("Tracer: cannot write %s", path.c_str());
+        return false;
+    }
+
+    TraceState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    bool first = true;
+    fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", file);
+
+    // pid 1: the app's threads, one row per buffer; pid 2: the GPU
+    writeName(file, "process_name", 1, 0, "CPU", first);
+    writeName(file, "process_name", 2, 0, "GPU", first);
+    writeName(file, "thread_name", 2, GPU_ROW, "compute queue", first);
+    for (const auto& buffer : s.buffers) {
+        std::string rowName = buffer->name != nullptr ? buffer->name : "thread " + std::to_string(buffer->rowId);
+        writeName(file, "thread_name", 1, buffer->rowId, rowName.c_str(), first);
+
+        uint64_t count = buffer->count.load(std::memory_order_acquire);
+        for (uint64_t i = 0; i < count; i++) {
+            const TraceEvent& event = buffer->chunks[i / ThreadBuffer::CHUNK_EVENTS][i % ThreadBuffer::CHUNK_EVENTS];
+            writeEvent(file, event, 1, buffer->rowId, first);
+        }
+    }
+    for (const TraceEvent& event : s.gpuEvents) {
+        writeEvent(file, event, 2, GPU_ROW, first);
+    }
+    fputs("\n]}\n", file);
+    bool ok = ferror(file) == 0;
+    fclose(file);
+    return ok;
+}
+
+uint64_t Tracer::getEventCount() {
+    TraceState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    uint64_t count = s.gpuEvents.size();
+    for (const auto& buffer : s.buffers) count += buffer->count.load(std::memory_order_acquire);
+    return count;
+}
+
+uint64_t Tracer::getDroppedCount() {
+    TraceState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    uint64_t dropped = s.gpuDropped;
+    for (const auto& buffer : s.buffers) dropped += buffer->dropped.load(std::memory_order_relaxed);
+    return dropped;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+struct GpuProfile;
+
+// Timeline tracing: CPU zones per thread plus GPU intervals, exported as
+// Chrome trace JSON (opens in ui.perfetto.dev and chrome://tracing).
+//
+// Recording is per thread and lock-free: each thread appends to its own
+// buffer, taken from a free list the first time it records (a mutex only
+// then) and returned when the thread exits, so short-lived workers such as
+// CpuReduceTask's threads reuse a few timeline rows instead of adding one each.
+// GPU intervals come from GpuProfiler::resolve(), on the CPU clock when the
+// timestamps are calibrated, otherwise ending when the CPU saw the submission
+// complete.
+//
+// Built without GPUCOMPUTE_TRACING, the TRACE_* macros compile to nothing.
+// Built with it, a zone costs one relaxed load while no session runs.
+// start() and writeChromeJson() must be called while no traced work is
+// running; zone and track names must outlive the session (string literals,
+// or intern()).
+class Tracer {
+public:
+    // Clears the previous session's events and starts recording
+    static void start();
+    static void stop();
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    // --- Recording ---
+    static void complete(const char* name, const char* category, int64_t startNs, int64_t endNs);
+    static void instant(const char* name, const char* category);
+    // Names this thread's row (until the thread exits)
+    static void setThreadName(const char* name);
+    // The regions of a resolved profile on the GPU row; 'hostCompleteUs' places an uncalibrated profile
+    static void gpuProfile(const GpuProfile& profile, double hostCompleteUs);
+    // A copy of 'name' that lives as long as the process, for names built at run time
+    static const char* intern(const std::string& name);
+
+    // steady_clock, the clock GpuProfiler's calibrated host times are on
+    static int64_t nowNs();
+
+    // --- Export ---
+    // Returns false if the file cannot be written
+    static bool writeChromeJson(const std::string& path);
+    static uint64_t getEventCount();
+    static uint64_t getDroppedCount();
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+// A zone from construction to the end of the scope
+class TraceScope {
+public:
+    TraceScope(const char* name, const char* category)
+            : m_name(name), m_category(category), m_startNs(Tracer::isEnabled() ? Tracer::nowNs() : -1) {}
+    ~TraceScope() {
+        if (m_startNs >= 0) Tracer::complete(m_name, m_category, m_startNs, Tracer::nowNs());
+    }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* m_name;
+    const char* m_category;
+    int64_t m_startNs;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef GPUCOMPUTE_TRACING
+#define TRACE_SCOPE(name, category) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name, category)
+#define TRACE_INSTANT(name, category) Tracer::instant(name, category)
+#define TRACE_THREAD_NAME(name) Tracer::setThreadName(name)
+#else
+#define TRACE_SCOPE(name, category) do {} while (0)
+#define TRACE_INSTANT(name, category) do {} while (0)
+#define TRACE_THREAD_NAME(name) do {} while (0)
+#endif
@@ -0,0 +1,294 @@
+#include "UploadRing.h"
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+
+void UploadRing::create(VulkanContext* context, VkDeviceSize capacity) {
+    m_context = context;
+    VkDevice device = m_context->getDevice();
+    m_dedicatedTransfer = m_context->hasDedicatedTransferQueue();
+
+    m_staging.create(m_context, capacity, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, MemoryUsage::UPLOAD);
+
+    // Copies are recorded on the transfer family; acquires on the compute family
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    poolInfo.queueFamilyIndex = m_context->getTransferQueueFamilyIndex();
+    if (vkCreateCommandPool(device, &poolInfo, nullptr, &m_transferPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create upload command pool!");
+    }
+    if (m_dedicatedTransfer) {
+        poolInfo.queueFamilyIndex = m_context->getComputeQueueFamilyIndex();
+        if (vkCreateCommandPool(device, &poolInfo, nullptr, &m_acquirePool) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create upload acquire command pool!");
+        }
+    }
+
+    m_batches.resize(MAX_BATCHES);
+    for (Batch& batch : m_batches) {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = m_transferPool;
+        allocInfo.commandBufferCount = 1;
+        if (vkAllocateCommandBuffers(device, &allocInfo, &batch.transferCommandBuffer) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to allocate upload command buffer!");
+        }
+
+        if (m_dedicatedTransfer) {
+            allocInfo.commandPool = m_acquirePool;
+            if (vkAllocateCommandBuffers(device, &allocInfo, &batch.acquireCommandBuffer) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to allocate upload acquire command buffer!");
+            }
+            VkSemaphoreCreateInfo semaphoreInfo{};
+            semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+            if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &batch.transferDone) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to create upload semaphore!");
+            }
+        }
+    }
+
+    LOGI("Upload ring created: %llu KB, %s", (unsigned long long)(capacity / 1024),
+         m_dedicatedTransfer ? "dedicated transfer queue" : "compute queue");
+}
+
+void UploadRing::destroy() {
+    if (m_context == nullptr) return;
+    VkDevice device = m_context->getDevice();
+
+    waitIdle();
+    for (Batch& batch : m_batches) {
+        if (batch.transferDone != VK_NULL_HANDLE) vkDestroySemaphore(device, batch.transferDone, nullptr);
+    }
+    m_batches.clear();
+    m_pending.clear();
+
+    // Destroying the pools frees their command buffers
+    if (m_transferPool != VK_NULL_HANDLE) vkDestroyCommandPool(device, m_transferPool, nullptr);
+    if (m_acquirePool != VK_NULL_HANDLE) vkDestroyCommandPool(device, m_acquirePool, nullptr);
+    m_transferPool = VK_NULL_HANDLE;
+    m_acquirePool = VK_NULL_HANDLE;
+
+    m_staging.destroy();
+    m_head = 0;
+    m_used = 0;
+    m_pendingBytes = 0;
+    m_context = nullptr;
+}
+
+// --- Public API ---
+
+void UploadRing::enqueue(VkBuffer dst, VkDeviceSize dstOffset, const void* data, VkDeviceSize size,
+                         VkQueue consumer) {
+    if (consumer == VK_NULL_HANDLE) consumer = m_context->getQueue();
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Chunks of at most half the ring, so one chunk can always be staged
+    // while the previous one is still in flight
+    const VkDeviceSize maxChunk = std::max<VkDeviceSize>(ALIGNMENT, (getCapacity() / 2) & ~(ALIGNMENT - 1));
+    const char* src = static_cast<const char*>(data);
+
+    VkDeviceSize done = 0;
+    while (done < size) {
+        VkDeviceSize chunk = std::min(size - done, maxChunk);
+        VkDeviceSize offset = allocate(chunk);
+        memcpy(m_staging.data<char>() + offset, src + done, (size_t)chunk);
+        m_pending.push_back({consumer, dst, offset, dstOffset + done, chunk});
+        done += chunk;
+    }
+}
+
+void UploadRing::submit() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    submitLocked();
+}
+
+void UploadRing::waitIdle() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    waitIdleLocked();
+}
+
+// --- Submission ---
+
+void UploadRing::submitLocked() {
+    if (m_pending.empty()) return;
+
+    // 1. Make the staged bytes visible to the device (no-op on coherent memory)
+    MappedRangeBatch ranges(m_context);
+    for (const PendingCopy& copy : m_pending) {
+        ranges.addFlush(m_staging, copy.srcOffset, copy.size);
+    }
+    ranges.submit();
+
+    // 2. One batch per consumer queue, in first-use order. Batches retire
+    // oldest first, so the ring bytes go with the last one: they are only
+    // reclaimed once every batch of this submit has completed.
+    std::vector<VkQueue> consumers;
+    for (const PendingCopy& copy : m_pending) {
+        if (std::find(consumers.begin(), consumers.end(), copy.consumer) == consumers.end()) {
+            consumers.push_back(copy.consumer);
+        }
+    }
+    for (size_t i = 0; i < consumers.size(); i++) {
+        std::vector<PendingCopy> copies;
+        for (const PendingCopy& copy : m_pending) {
+            if (copy.consumer == consumers[i]) copies.push_back(copy);
+        }
+        submitBatch(consumers[i], copies, (i + 1 == consumers.size()) ? m_pendingBytes : 0);
+    }
+
+    m_pending.clear();
+    m_pendingBytes = 0;
+}
+
+void UploadRing::submitBatch(VkQueue consumer, const std::vector<PendingCopy>& copies, VkDeviceSize bytes) {
+    retireCompleted();
+    if (m_inFlight.size() == MAX_BATCHES) {
+        retireOldest();
+    }
+    uint32_t batchIndex = 0;
+    while (m_batches[batchIndex].inFlight) batchIndex++;
+    Batch& batch = m_batches[batchIndex];
+
+    // Each destination gets one ownership barrier, however many copies it received
+    std::vector<VkBuffer> destinations;
+    for (const PendingCopy& copy : copies) {
+        if (std::find(destinations.begin(), destinations.end(), copy.dst) == destinations.end()) {
+            destinations.push_back(copy.dst);
+        }
+    }
+
+    // Record the batch's copies into one command buffer
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    vkResetCommandBuffer(batch.transferCommandBuffer, 0);
+    vkBeginCommandBuffer(batch.transferCommandBuffer, &beginInfo);
+    for (const PendingCopy& copy : copies) {
+        VkBufferCopy region{};
+        region.srcOffset = copy.srcOffset;
+        region.dstOffset = copy.dstOffset;
+        region.size = copy.size;
+        vkCmdCopyBuffer(batch.transferCommandBuffer, m_staging.getBuffer(), copy.dst, 1, &region);
+    }
+
+    std::vector<VkBufferMemoryBarrier> ownership(destinations.size());
+    if (m_dedicatedTransfer) {
+        // Release: transfer family -> compute family
+        for (size_t i = 0; i < destinations.size(); i++) {
+            ownership[i].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            ownership[i].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            ownership[i].dstAccessMask = 0;
+            ownership[i].srcQueueFamilyIndex = m_context->getTransferQueueFamilyIndex();
+            ownership[i].dstQueueFamilyIndex = m_context->getComputeQueueFamilyIndex();
+            ownership[i].buffer = destinations[i];
+            ownership[i].offset = 0;
+            ownership[i].size = VK_WHOLE_SIZE;
+        }
+        vkCmdPipelineBarrier(batch.transferCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                             0, 0, nullptr, static_cast<uint32_t>(ownership.size()), ownership.data(), 0, nullptr);
+    } else {
+        // Same queue: later compute submissions are ordered behind this barrier
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(batch.transferCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             0, 1, &barrier, 0, nullptr, 0, nullptr);
+    }
+    vkEndCommandBuffer(batch.transferCommandBuffer);
+
+    // Submit (no wait)
+    SubmitQueue* submitQueue = m_context->getSubmitQueue();
+    if (!m_dedicatedTransfer) {
+        batch.ticket = submitQueue->submit(consumer, batch.transferCommandBuffer);
+    } else {
+        SubmitRequest transfer;
+        transfer.queue = m_context->getTransferQueue();
+        transfer.commandBuffers.push_back(batch.transferCommandBuffer);
+        transfer.signalSemaphores.push_back(batch.transferDone);
+        submitQueue->submit(std::move(transfer));
+
+        // Acquire on the consumer queue; its ticket also covers the transfer (via the semaphore)
+        vkResetCommandBuffer(batch.acquireCommandBuffer, 0);
+        vkBeginCommandBuffer(batch.acquireCommandBuffer, &beginInfo);
+        for (VkBufferMemoryBarrier& barrier : ownership) {
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        }
+        vkCmdPipelineBarrier(batch.acquireCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             0, 0, nullptr, static_cast<uint32_t>(ownership.size()), ownership.data(), 0, nullptr);
+        vkEndCommandBuffer(batch.acquireCommandBuffer);
+
+        SubmitRequest acquire;
+        acquire.queue = consumer;
+        acquire.commandBuffers.push_back(batch.acquireCommandBuffer);
+        acquire.waitSemaphores.push_back(batch.transferDone);
+        acquire.waitStages.push_back(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+        batch.ticket = submitQueue->submit(std::move(acquire));
+    }
+
+    batch.bytes = bytes;
+    batch.inFlight = true;
+    m_inFlight.push_back(batchIndex);
+}
+
+void UploadRing::waitIdleLocked() {
+    submitLocked();
+    while (!m_inFlight.empty()) {
+        retireOldest();
+    }
+}
+
+// --- Ring Helpers ---
+
+VkDeviceSize UploadRing::allocate(VkDeviceSize size) {
+    const VkDeviceSize capacity = getCapacity();
+    size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    if (size > capacity) {
+        throw std::runtime_error("Upload larger than the staging ring!");
+    }
+
+    // A request that doesn't fit before the end wraps to 0, wasting the tail
+    VkDeviceSize wasted = (m_head + size > capacity) ? capacity - m_head : 0;
+    if (capacity - m_used < wasted + size) {
+        // Reclaim what has already finished first
+        retireCompleted();
+    }
+    if (capacity - m_used < wasted + size) {
+        // Still full: flush the queued copies and drain the ring. Waiting for
+        // completion keeps this correct whichever queue consumes the data.
+        waitIdleLocked();
+        m_head = 0;
+        wasted = 0;
+    }
+
+    if (wasted > 0) {
+        m_head = 0;
+        m_used += wasted;
+        m_pendingBytes += wasted;
+    }
+    VkDeviceSize offset = m_head;
+    m_head += size;
+    m_used += size;
+    m_pendingBytes += size;
+    return offset;
+}
+
+void UploadRing::retireOldest() {
+    Batch& batch = m_batches[m_inFlight.front()];
+    batch.ticket.wait();
+    batch.ticket = SubmitTicket();
+    m_used -= batch.bytes;
+    batch.bytes = 0;
+    batch.inFlight = false;
+    m_inFlight.pop_front();
+}
+
+void UploadRing::retireCompleted() {
+    while (!m_inFlight.empty() && m_batches[m_inFlight.front()].ticket.isComplete()) {
+        retireOldest();
+    }
+}
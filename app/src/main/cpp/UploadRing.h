@@ -0,0 +1,93 @@
+#pragma once
+
+#include "VulkanContext.h"
+#include "MappedBuffer.h"
+#include "SubmitQueue.h"
+#include <vector>
+#include <deque>
+#include <mutex>
+
+// A persistent, fence-tracked staging ring for host -> device uploads.
+//
+// enqueue() copies the data into the ring right away and queues a
+// vkCmdCopyBuffer; submit() records the queued copies into one command
+// buffer per consumer queue and submits them without waiting. Ring space is
+// reclaimed when a batch's ticket completes, so callers only block when the
+// ring is full.
+//
+// Thread-safe: the public calls serialize on one mutex, and each queued copy
+// remembers the queue that will consume it, so a submit() from any thread
+// orders the data before that queue's later work.
+//
+// On devices with a dedicated transfer queue the copies run there and the
+// destination buffers are handed to the compute queue family with
+// release/acquire barriers (whole-buffer ownership: on that path, bytes of
+// 'dst' outside the uploaded ranges are not preserved). Otherwise the copies
+// run on the compute queue, followed by a transfer -> compute barrier.
+// Either way, compute work submitted after submit() sees the data.
+class UploadRing {
+public:
+    UploadRing() = default;
+
+    void create(VulkanContext* context, VkDeviceSize capacity);
+    void destroy();
+
+    // Stages 'size' bytes and queues the copy into dst (large uploads are split).
+    // 'consumer' is the compute queue that will read the data (default: queue 0);
+    // only work submitted to that queue after submit() is ordered behind the upload.
+    void enqueue(VkBuffer dst, VkDeviceSize dstOffset, const void* data, VkDeviceSize size,
+                 VkQueue consumer = VK_NULL_HANDLE);
+    // Submits all queued copies, one batch per consumer queue (no-op when nothing is queued)
+    void submit();
+    // Blocks until every submitted batch has completed
+    void waitIdle();
+
+    VkDeviceSize getCapacity() const { return m_staging.getSize(); }
+    bool usesTransferQueue() const { return m_dedicatedTransfer; }
+
+private:
+    struct PendingCopy {
+        VkQueue consumer;
+        VkBuffer dst;
+        VkDeviceSize srcOffset;
+        VkDeviceSize dstOffset;
+        VkDeviceSize size;
+    };
+
+    struct Batch {
+        VkCommandBuffer transferCommandBuffer = VK_NULL_HANDLE;
+        VkCommandBuffer acquireCommandBuffer = VK_NULL_HANDLE; // Dedicated transfer queue only
+        VkSemaphore transferDone = VK_NULL_HANDLE;             // Dedicated transfer queue only
+        SubmitTicket ticket;
+        VkDeviceSize bytes = 0; // Ring bytes released when the ticket completes
+        bool inFlight = false;
+    };
+
+    // Unlocked bodies of the public calls (m_mutex held)
+    void submitLocked();
+    void submitBatch(VkQueue consumer, const std::vector<PendingCopy>& copies, VkDeviceSize bytes);
+    void waitIdleLocked();
+    // Returns the ring offset of 'size' contiguous bytes, waiting for old batches if needed
+    VkDeviceSize allocate(VkDeviceSize size);
+    void retireOldest();
+    void retireCompleted();
+
+    VulkanContext* m_context = nullptr;
+    MappedBuffer m_staging;
+    std::mutex m_mutex;
+
+    VkCommandPool m_transferPool = VK_NULL_HANDLE;
+    VkCommandPool m_acquirePool = VK_NULL_HANDLE;
+    bool m_dedicatedTransfer = false;
+
+    std::vector<Batch> m_batches;
+    std::deque<uint32_t> m_inFlight; // Batch indices, oldest first
+    std::vector<PendingCopy> m_pending;
+
+    VkDeviceSize m_head = 0;         // Next write offset
+    VkDeviceSize m_used = 0;         // Bytes owned by pending + in-flight batches
+    VkDeviceSize m_pendingBytes = 0; // Part of m_used not yet submitted
+
+    static const uint32_t MAX_BATCHES = 4;
+    static constexpr VkDeviceSize ALIGNMENT = 16;
+};
@@ -1,39 +1,12 @@
 #pragma once
 
-#include "BaseComputeTask.h"
+#include "ElementwiseTask.h"
 
-// --- REMOVED: #include "vector_add_shader.h" ---
-
-class VectorAddTask : public BaseComputeTask {
+// c = a + b: the ADD op of the elementwise library
+class VectorAddTask : public ElementwiseTask {
 public:
-    // --- MODIFIED: Constructor now takes AAssetManager ---
-    VectorAddTask(AAssetManager* assetManager);
-    ~VectorAddTask();
-
-    // --- ComputeTask Interface ---
-    long long dispatch() override;
-    void cleanup() override;
-
-protected:
-    // --- BaseComputeTask "Fill-in-the-blanks" ---
-    std::string getShaderPath() override; // <-- MODIFIED
-    void createDescriptorSetLayout() override;
-    void createBuffers() override;
-    void createDescriptorPool() override;
-    void createDescriptorSet() override;
-
-private:
-    void createDeviceLocalBuffer(VkBuffer& buffer, VkDeviceMemory& memory, VkDeviceSize size, const void* initialData);
-    void cleanupBuffers();
-
-    // --- Our 3 compute buffers ---
-    VkBuffer m_bufferA = VK_NULL_HANDLE;
-    VkBuffer m_bufferB = VK_NULL_HANDLE;
-    VkBuffer m_bufferC = VK_NULL_HANDLE;
-
-    VkDeviceMemory m_bufferMemoryA = VK_NULL_HANDLE;
-    VkDeviceMemory m_bufferMemoryB = VK_NULL_HANDLE;
-    VkDeviceMemory m_bufferMemoryC = VK_NULL_HANDLE;
+    VectorAddTask(AAssetManager* assetManager, uint32_t n = DEFAULT_ELEMENTS)
+            : ElementwiseTask(assetManager, ElementwiseOp::ADD, n) {}
 
-    static const uint32_t NUM_ELEMENTS = 1024;
-};
\ No newline at end of file
+    static const uint32_t DEFAULT_ELEMENTS = 1024;
+};
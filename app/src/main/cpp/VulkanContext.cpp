@@ -1,14 +1,31 @@
 #include "VulkanContext.h"
+#include "UploadRing.h"
+#include "SubmitQueue.h"
+#include "ScratchPool.h"
 #include <vector>
+#include <algorithm>
+#include <cstring>
 
 // --- Singleton ---
-VulkanContext* VulkanContext::s_instance = nullptr;
-
 VulkanContext* VulkanContext::getInstance() {
-    if (s_instance == nullptr) {
-        s_instance = new VulkanContext();
+    // Function-local statics are initialized exactly once, even under concurrent first calls
+    static VulkanContext* instance = new VulkanContext();
+    return instance;
+}
+
+// The calling thread's pool, valid only while 'generation' matches the context's.
+// It goes back to the context when the thread exits, so short-lived threads reuse pools.
+namespace {
+struct ThreadCommandPool {
+    VkCommandPool pool = VK_NULL_HANDLE;
+    uint32_t generation = 0;
+    ~ThreadCommandPool() {
+        if (pool != VK_NULL_HANDLE) {
+            VulkanContext::getInstance()->releaseThreadCommandPool(pool, generation);
+        }
     }
-    return s_instance;
+};
+thread_local ThreadCommandPool t_commandPool;
 }
 
 VulkanContext::VulkanContext() {
@@ -26,9 +43,18 @@ void VulkanContext::init() {
     try {
         createInstance();
         pickPhysicalDevice();
+        queryDeviceExtensions();
+        queryMemoryProperties();
         findComputeQueueFamily();
+        findTransferQueueFamily();
         createLogicalDeviceAndQueue();
-        createCommandPool();
+        m_generation.fetch_add(1);
+        m_submitQueue = new SubmitQueue();
+        m_submitQueue->start(this);
+        m_uploadRing = new UploadRing();
+        m_uploadRing->create(this, UPLOAD_RING_SIZE);
+        m_scratchPool = new ScratchPool();
+        m_scratchPool->create(this, SCRATCH_POOL_SIZE);
         LOGI("VulkanContext initialized successfully.");
     } catch (const std::exception& e) {
         LOGE("Vulkan init failed: %s", e.what());
@@ -37,8 +63,31 @@ void VulkanContext::init() {
 
 void VulkanContext::cleanup() {
     LOGI("Cleaning up VulkanContext...");
-    if (m_commandPool != VK_NULL_HANDLE) {
-        vkDestroyCommandPool(m_device, m_commandPool, nullptr);
+    if (m_scratchPool != nullptr) {
+        m_scratchPool->destroy();
+        delete m_scratchPool;
+        m_scratchPool = nullptr;
+    }
+    if (m_uploadRing != nullptr) {
+        m_uploadRing->destroy();
+        delete m_uploadRing;
+        m_uploadRing = nullptr;
+    }
+    if (m_submitQueue != nullptr) {
+        m_submitQueue->stop();
+        delete m_submitQueue;
+        m_submitQueue = nullptr;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        for (VkCommandPool pool : m_threadPools) {
+            vkDestroyCommandPool(m_device, pool, nullptr);
+        }
+        m_threadPools.clear();
+        m_freePools.clear();
+        // Any thread-local pool left from this generation is now stale (bumped under the lock so a
+        // thread exiting concurrently cannot return a destroyed pool to the free list)
+        m_generation.fetch_add(1);
     }
     if (m_device != VK_NULL_HANDLE) {
         vkDestroyDevice(m_device, nullptr);
@@ -50,11 +99,8 @@ void VulkanContext::cleanup() {
 
 // --- Helper: Find Memory Type ---
 uint32_t VulkanContext::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) {
-    VkPhysicalDeviceMemoryProperties memProperties;
-    vkGetPhysicalDeviceMemoryProperties(m_physicalDevice, &memProperties);
-
-    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
-        if ((typeFilter & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+    for (uint32_t i = 0; i < m_memoryProperties.memoryTypeCount; i++) {
+        if ((typeFilter & (1 << i)) && (m_memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
             return i;
         }
     }
@@ -62,6 +108,76 @@ uint32_t VulkanContext::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlag
     throw std::runtime_error("Failed to find suitable memory type!");
 }
 
+// --- Helper: Usage-Based Memory Type Selection ---
+uint32_t VulkanContext::selectMemoryType(uint32_t typeFilter, MemoryUsage usage) {
+    uint32_t bestIndex = UINT32_MAX;
+    int bestScore = 0;
+    VkDeviceSize bestHeapSize = 0;
+
+    for (uint32_t i = 0; i < m_memoryProperties.memoryTypeCount; i++) {
+        if (!(typeFilter & (1 << i))) continue;
+
+        int score = scoreMemoryType(i, usage);
+        if (score < 0) continue; // Not usable for this usage
+
+        // Ties go to the bigger heap
+        VkDeviceSize heapSize = m_memoryProperties.memoryHeaps[m_memoryProperties.memoryTypes[i].heapIndex].size;
+        if (bestIndex == UINT32_MAX || score > bestScore || (score == bestScore && heapSize > bestHeapSize)) {
+            bestIndex = i;
+            bestScore = score;
+            bestHeapSize = heapSize;
+        }
+    }
+    if (bestIndex == UINT32_MAX) {
+        LOGE("Failed to find a memory type for usage %d!", (int)usage);
+        throw std::runtime_error("Failed to find suitable memory type!");
+    }
+    return bestIndex;
+}
+
+int VulkanContext::scoreMemoryType(uint32_t memoryTypeIndex, MemoryUsage usage) {
+    VkMemoryPropertyFlags flags = m_memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags;
+    bool deviceLocal = flags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    bool hostVisible = flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+    bool hostCoherent = flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    bool hostCached = flags & VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+
+    // Never hand out lazily-allocated (tile memory) or protected types for buffers
+    if (flags & (VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT | VK_MEMORY_PROPERTY_PROTECTED_BIT)) {
+        return -1;
+    }
+
+    int score = 0;
+    switch (usage) {
+        case MemoryUsage::GPU_ONLY:
+            score += deviceLocal ? 100 : 0;
+            // On discrete GPUs host-visible device memory is a small BAR window; leave it free
+            if (hostVisible && !m_unifiedMemory) score -= 10;
+            break;
+
+        case MemoryUsage::UPLOAD:
+            if (!hostVisible) return -1;
+            score += hostCoherent ? 20 : 0;
+            score -= hostCached ? 5 : 0; // Write-combined is better for sequential writes
+            if (deviceLocal) score += m_unifiedMemory ? 10 : -10;
+            break;
+
+        case MemoryUsage::READBACK:
+            if (!hostVisible) return -1;
+            score += hostCached ? 50 : 0; // Uncached reads are very slow on most mobile GPUs
+            score += hostCoherent ? 10 : 0;
+            if (deviceLocal && m_unifiedMemory) score += 5;
+            break;
+
+        case MemoryUsage::STREAMING:
+            if (!hostVisible) return -1;
+            score += deviceLocal ? 100 : 0;
+            score += hostCoherent ? 20 : 0;
+            score -= hostCached ? 5 : 0;
+            break;
+    }
+    return score;
+}
 
 // --- Private Init Helpers ---
 
@@ -105,6 +221,16 @@ void VulkanContext::pickPhysicalDevice() {
     VkPhysicalDeviceProperties deviceProperties;
     vkGetPhysicalDeviceProperties(m_physicalDevice, &deviceProperties);
     LOGI("Using GPU: %s", deviceProperties.deviceName);
+    m_deviceType = deviceProperties.deviceType;
+
+    // Flush/invalidate ranges on non-coherent memory must be aligned to this
+    m_nonCoherentAtomSize = deviceProperties.limits.nonCoherentAtomSize;
+    if (m_nonCoherentAtomSize == 0) m_nonCoherentAtomSize = 1;
+    // Storage-buffer descriptor offsets must be multiples of this
+    m_minStorageBufferOffsetAlignment = deviceProperties.limits.minStorageBufferOffsetAlignment;
+    if (m_minStorageBufferOffsetAlignment == 0) m_minStorageBufferOffsetAlignment = 1;
+    // One-workgroup-per-block dispatches must stay within this (the spec guarantees 65535)
+    m_maxComputeWorkGroupCountX = deviceProperties.limits.maxComputeWorkGroupCount[0];
 
     // --- ADD THIS BLOCK ---
     // Check for timestamp support
@@ -121,6 +247,108 @@ void VulkanContext::pickPhysicalDevice() {
     // --- END OF BLOCK ---
 }
 
+void VulkanContext::queryDeviceExtensions() {
+    m_deviceExtensions.clear();
+    m_minImportedHostPointerAlignment = 0;
+    m_getMemoryHostPointerProperties = nullptr;
+    m_calibratedTimestampsSupported = false;
+    m_getCalibratedTimestamps = nullptr;
+
+    uint32_t extensionCount = 0;
+    vkEnumerateDeviceExtensionProperties(m_physicalDevice, nullptr, &extensionCount, nullptr);
+    std::vector<VkExtensionProperties> extensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(m_physicalDevice, nullptr, &extensionCount, extensions.data());
+    auto hasExtension = [&extensions](const char* name) {
+        for (const VkExtensionProperties& extension : extensions) {
+            if (strcmp(extension.extensionName, name) == 0) return true;
+        }
+        return false;
+    };
+
+    // Host pointer import: external memory is core in 1.1, the alignment comes from properties2
+    VkPhysicalDeviceProperties deviceProperties;
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &deviceProperties);
+    if (deviceProperties.apiVersion >= VK_API_VERSION_1_1 && hasExtension(VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME)) {
+        VkPhysicalDeviceExternalMemoryHostPropertiesEXT hostProperties{};
+        hostProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_MEMORY_HOST_PROPERTIES_EXT;
+        VkPhysicalDeviceProperties2 properties2{};
+        properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties2.pNext = &hostProperties;
+        vkGetPhysicalDeviceProperties2(m_physicalDevice, &properties2);
+
+        m_minImportedHostPointerAlignment = hostProperties.minImportedHostPointerAlignment;
+        m_deviceExtensions.push_back(VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME);
+        LOGI("Host pointer import supported (alignment %llu)", (unsigned long long)m_minImportedHostPointerAlignment);
+    } else {
+        LOGI("Host pointer import NOT supported: host data will be copied");
+    }
+
+    // Calibrated timestamps: only useful if the device clock can be sampled together with CLOCK_MONOTONIC
+    if (hasExtension(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME)) {
+        auto getTimeDomains = (PFN_vkGetPhysicalDeviceCalibrateableTimeDomainsEXT)
+                vkGetInstanceProcAddr(m_instance, "vkGetPhysicalDeviceCalibrateableTimeDomainsEXT");
+        uint32_t domainCount = 0;
+        std::vector<VkTimeDomainEXT> domains;
+        if (getTimeDomains != nullptr && getTimeDomains(m_physicalDevice, &domainCount, nullptr) == VK_SUCCESS) {
+            domains.resize(domainCount);
+            getTimeDomains(m_physicalDevice, &domainCount, domains.data());
+        }
+        bool device = std::find(domains.begin(), domains.end(), VK_TIME_DOMAIN_DEVICE_EXT) != domains.end();
+        bool monotonic = std::find(domains.begin(), domains.end(), VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT) != domains.end();
+        m_calibratedTimestampsSupported = device && monotonic;
+    }
+    if (m_calibratedTimestampsSupported) {
+        m_deviceExtensions.push_back(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME);
+        LOGI("Calibrated timestamps supported: GPU intervals can be placed on the CPU clock");
+    } else {
+        LOGI("Calibrated timestamps NOT supported: GPU intervals stay relative");
+    }
+}
+
+uint32_t VulkanContext::getHostPointerMemoryTypeBits(const void* hostPointer) {
+    if (m_getMemoryHostPointerProperties == nullptr) return 0;
+
+    VkMemoryHostPointerPropertiesEXT properties{};
+    properties.sType = VK_STRUCTURE_TYPE_MEMORY_HOST_POINTER_PROPERTIES_EXT;
+    if (m_getMemoryHostPointerProperties(m_device, VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT,
+                                         hostPointer, &properties) != VK_SUCCESS) {
+        return 0;
+    }
+    return properties.memoryTypeBits;
+}
+
+void VulkanContext::queryMemoryProperties() {
+    // Cached once; memory type selection never goes back to the driver
+    vkGetPhysicalDeviceMemoryProperties(m_physicalDevice, &m_memoryProperties);
+
+    // Unified if the largest DEVICE_LOCAL heap is also host-visible. That covers
+    // phones and integrated GPUs (one heap) and ReBAR desktops, but not the small
+    // 256 MB BAR window on classic discrete GPUs.
+    VkDeviceSize largestDeviceHeap = 0;
+    uint32_t largestDeviceHeapIndex = UINT32_MAX;
+    for (uint32_t i = 0; i < m_memoryProperties.memoryHeapCount; i++) {
+        const VkMemoryHeap& heap = m_memoryProperties.memoryHeaps[i];
+        if ((heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) && heap.size > largestDeviceHeap) {
+            largestDeviceHeap = heap.size;
+            largestDeviceHeapIndex = i;
+        }
+    }
+
+    m_unifiedMemory = (m_deviceType == VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU ||
+                       m_deviceType == VK_PHYSICAL_DEVICE_TYPE_CPU);
+    for (uint32_t i = 0; i < m_memoryProperties.memoryTypeCount; i++) {
+        const VkMemoryType& type = m_memoryProperties.memoryTypes[i];
+        LOGI("Memory type %u: heap %u (%llu MB), flags 0x%x", i, type.heapIndex,
+             (unsigned long long)(m_memoryProperties.memoryHeaps[type.heapIndex].size >> 20),
+             type.propertyFlags);
+        VkMemoryPropertyFlags mappable = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+        if ((type.propertyFlags & mappable) == mappable && type.heapIndex == largestDeviceHeapIndex) {
+            m_unifiedMemory = true;
+        }
+    }
+    LOGI("Memory model: %s", m_unifiedMemory ? "unified (direct mapping)" : "discrete (staging uploads)");
+}
+
 void VulkanContext::findComputeQueueFamily() {
     uint32_t queueFamilyCount = 0;
     vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &queueFamilyCount, nullptr);
@@ -152,42 +380,147 @@ void VulkanContext::findComputeQueueFamily() {
     }
 }
 
+void VulkanContext::findTransferQueueFamily() {
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+    // A transfer-only family is usually backed by a DMA engine that copies
+    // while the compute units keep working
+    for (uint32_t i = 0; i < queueFamilyCount; i++) {
+        if ((queueFamilies[i].queueFlags & VK_QUEUE_TRANSFER_BIT) &&
+            !(queueFamilies[i].queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT))) {
+            m_transferQueueFamilyIndex = i;
+            LOGI("Found dedicated transfer queue at index %d", i);
+            return;
+        }
+    }
+
+    // Most mobile GPUs expose a single family: uploads share the compute queue
+    m_transferQueueFamilyIndex = m_computeQueueFamilyIndex;
+    LOGI("No dedicated transfer queue, uploads use the compute queue");
+}
+
 void VulkanContext::createLogicalDeviceAndQueue() {
-    VkDeviceQueueCreateInfo queueCreateInfo{};
-    queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-    queueCreateInfo.queueFamilyIndex = m_computeQueueFamilyIndex;
-    queueCreateInfo.queueCount = 1;
-    float queuePriority = 1.0f;
-    queueCreateInfo.pQueuePriorities = &queuePriority;
+    // As many compute queues as the family offers, up to MAX_COMPUTE_QUEUES
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &queueFamilyCount, queueFamilies.data());
+    uint32_t computeQueueCount = std::min(queueFamilies[m_computeQueueFamilyIndex].queueCount, MAX_COMPUTE_QUEUES);
+    // timestampComputeAndGraphics is device-wide; the family can still opt out with 0 valid bits
+    m_timestampValidBits = m_timestampPeriod > 0 ? queueFamilies[m_computeQueueFamilyIndex].timestampValidBits : 0;
+    LOGI("Compute queue timestamps: %u valid bits", m_timestampValidBits);
+
+    std::vector<float> queuePriorities(computeQueueCount, 1.0f);
+    std::vector<VkDeviceQueueCreateInfo> queueCreateInfos(hasDedicatedTransferQueue() ? 2 : 1);
+    for (size_t i = 0; i < queueCreateInfos.size(); i++) {
+        queueCreateInfos[i].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+        queueCreateInfos[i].queueFamilyIndex = (i == 0) ? m_computeQueueFamilyIndex : m_transferQueueFamilyIndex;
+        queueCreateInfos[i].queueCount = (i == 0) ? computeQueueCount : 1;
+        queueCreateInfos[i].pQueuePriorities = queuePriorities.data();
+    }
 
     VkDeviceCreateInfo deviceCreateInfo{};
     deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-    deviceCreateInfo.pQueueCreateInfos = &queueCreateInfo;
-    deviceCreateInfo.queueCreateInfoCount = 1;
+    deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
+    deviceCreateInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
 
-    // We don't need any special device features for this project
+    // Only optional features: pipeline statistics queries, for the per-pass counters
+    VkPhysicalDeviceFeatures supportedFeatures{};
+    vkGetPhysicalDeviceFeatures(m_physicalDevice, &supportedFeatures);
     VkPhysicalDeviceFeatures deviceFeatures{};
+    deviceFeatures.pipelineStatisticsQuery = supportedFeatures.pipelineStatisticsQuery;
+    m_pipelineStatistics = supportedFeatures.pipelineStatisticsQuery == VK_TRUE;
+    LOGI("Pipeline statistics queries: %s", m_pipelineStatistics ? "supported" : "not supported");
     deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
+    deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(m_deviceExtensions.size());
+    deviceCreateInfo.ppEnabledExtensionNames = m_deviceExtensions.empty() ? nullptr : m_deviceExtensions.data();
 
     if (vkCreateDevice(m_physicalDevice, &deviceCreateInfo, nullptr, &m_device) != VK_SUCCESS) {
         LOGE("Failed to create logical device!");
         throw std::runtime_error("Failed to create logical device!");
     }
 
-    vkGetDeviceQueue(m_device, m_computeQueueFamilyIndex, 0, &m_queue);
-    LOGI("Logical device and queue created.");
+    m_computeQueues.resize(computeQueueCount);
+    for (uint32_t i = 0; i < computeQueueCount; i++) {
+        vkGetDeviceQueue(m_device, m_computeQueueFamilyIndex, i, &m_computeQueues[i]);
+    }
+    m_queue = m_computeQueues[0];
+    vkGetDeviceQueue(m_device, m_transferQueueFamilyIndex, 0, &m_transferQueue);
+
+    // Extension entry points are not exported by the loader
+    if (m_minImportedHostPointerAlignment > 0) {
+        m_getMemoryHostPointerProperties = (PFN_vkGetMemoryHostPointerPropertiesEXT)
+                vkGetDeviceProcAddr(m_device, "vkGetMemoryHostPointerPropertiesEXT");
+    }
+    if (m_calibratedTimestampsSupported) {
+        m_getCalibratedTimestamps = (PFN_vkGetCalibratedTimestampsEXT)
+                vkGetDeviceProcAddr(m_device, "vkGetCalibratedTimestampsEXT");
+    }
+    LOGI("Logical device created with %u compute queue(s)%s.", computeQueueCount,
+         hasDedicatedTransferQueue() ? " and a transfer queue" : "");
+}
+
+bool VulkanContext::getCalibratedTimestamps(uint64_t& deviceTicks, uint64_t& hostNs, uint64_t& maxDeviationNs) {
+    if (m_getCalibratedTimestamps == nullptr) return false;
+
+    VkCalibratedTimestampInfoEXT infos[2]{};
+    infos[0].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT;
+    infos[0].timeDomain = VK_TIME_DOMAIN_DEVICE_EXT;
+    infos[1].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT;
+    infos[1].timeDomain = VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT;
+    uint64_t timestamps[2] = {0, 0};
+    if (m_getCalibratedTimestamps(m_device, 2, infos, timestamps, &maxDeviationNs) != VK_SUCCESS) {
+        return false;
+    }
+    deviceTicks = timestamps[0];
+    hostNs = timestamps[1];
+    return true;
+}
+
+VkCommandPool VulkanContext::getCommandPool() {
+    uint32_t generation = m_generation.load();
+    if (t_commandPool.pool == VK_NULL_HANDLE || t_commandPool.generation != generation) {
+        t_commandPool.pool = createThreadCommandPool();
+        t_commandPool.generation = generation;
+    }
+    return t_commandPool.pool;
 }
 
-void VulkanContext::createCommandPool() {
+VkCommandPool VulkanContext::createThreadCommandPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        if (!m_freePools.empty()) {
+            VkCommandPool pool = m_freePools.back();
+            m_freePools.pop_back();
+            return pool;
+        }
+    }
+
     VkCommandPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
     poolInfo.queueFamilyIndex = m_computeQueueFamilyIndex;
     // VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT lets us reset/rerecord command buffers
     poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 
-    if (vkCreateCommandPool(m_device, &poolInfo, nullptr, &m_commandPool) != VK_SUCCESS) {
+    VkCommandPool pool = VK_NULL_HANDLE;
+    if (vkCreateCommandPool(m_device, &poolInfo, nullptr, &pool) != VK_SUCCESS) {
         LOGE("Failed to create command pool!");
         throw std::runtime_error("Failed to create command pool!");
     }
-    LOGI("Command pool created.");
+
+    std::lock_guard<std::mutex> lock(m_poolMutex);
+    m_threadPools.push_back(pool);
+    LOGI("Command pool created (%zu thread pool(s)).", m_threadPools.size());
+    return pool;
+}
+
+void VulkanContext::releaseThreadCommandPool(VkCommandPool pool, uint32_t generation) {
+    std::lock_guard<std::mutex> lock(m_poolMutex);
+    // A pool from an earlier generation was already destroyed by cleanup()
+    if (generation != m_generation.load()) return;
+    // Every command buffer is freed on the thread that allocated it, so the pool is empty here
+    m_freePools.push_back(pool);
 }
\ No newline at end of file
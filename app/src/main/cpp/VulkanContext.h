@@ -1,16 +1,32 @@
 #pragma once
 
 #include <vulkan/vulkan.h>
-#include <android/log.h>
+#include <vector>
+#include <mutex>
+#include <atomic>
 
-// --- Logging Macros ---
-#define LOG_TAG "GpuCompute"
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
-#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+// --- Logging Macros (LOGD/LOGI/LOGW/LOGE) ---
+#include "Log.h"
+
+class UploadRing;
+class SubmitQueue;
+class ScratchPool;
+
+// How a buffer's memory will be accessed; drives memory type selection
+enum class MemoryUsage {
+    GPU_ONLY,  // Only the GPU touches it (partials, outputs copied elsewhere)
+    UPLOAD,    // Host writes once, GPU copies out (staging source)
+    READBACK,  // GPU writes, host reads (results)
+    STREAMING  // Host rewrites it often and the GPU reads it in place
+};
+
+// Threading: init() and cleanup() are lifecycle calls made from one thread while
+// no task is running. Everything else may be called from any thread; queues are
+// only touched through the SubmitQueue, and every thread records into its own
+// command pool.
 class VulkanContext {
 public:
-    // --- Singleton Access ---
+    // --- Singleton Access (thread-safe) ---
     static VulkanContext* getInstance();
 
     // --- Deleted copy/move ---
@@ -26,12 +42,57 @@ public:
     // --- Getters for Vulkan Handles ---
     VkDevice getDevice() { return m_device; }
     VkPhysicalDevice getPhysicalDevice() { return m_physicalDevice; }
-    VkQueue getQueue() { return m_queue; }
-    VkCommandPool getCommandPool() { return m_commandPool; }
+    VkQueue getQueue() { return m_queue; } // Compute queue 0
+    // Extra queues of the compute family, for independent work that may run concurrently
+    uint32_t getComputeQueueCount() { return static_cast<uint32_t>(m_computeQueues.size()); }
+    VkQueue getComputeQueue(uint32_t index) { return m_computeQueues[index % m_computeQueues.size()]; }
+    // The calling thread's command pool (created on first use; pools are not thread-safe)
+    VkCommandPool getCommandPool();
+    // Called when a thread exits: its pool is kept for the next thread that needs one
+    void releaseThreadCommandPool(VkCommandPool pool, uint32_t generation);
     uint32_t getComputeQueueFamilyIndex() { return m_computeQueueFamilyIndex; }
+    // Transfer-only queue when the device has one, otherwise the compute queue
+    VkQueue getTransferQueue() { return m_transferQueue; }
+    uint32_t getTransferQueueFamilyIndex() { return m_transferQueueFamilyIndex; }
+    bool hasDedicatedTransferQueue() { return m_transferQueueFamilyIndex != m_computeQueueFamilyIndex; }
+    // Shared staging ring for host -> device uploads (see UploadRing.h)
+    UploadRing* getUploadRing() { return m_uploadRing; }
+    // Every vkQueueSubmit goes through here (see SubmitQueue.h)
+    SubmitQueue* getSubmitQueue() { return m_submitQueue; }
+    // Small device-only buffer for per-task scratch ranges (see ScratchPool.h)
+    ScratchPool* getScratchPool() { return m_scratchPool; }
 
+    // --- Memory Type Selection (uses properties cached at init) ---
     uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
+    // Ranks every allowed type for the given usage and returns the best one
+    uint32_t selectMemoryType(uint32_t typeFilter, MemoryUsage usage);
+    VkMemoryPropertyFlags getMemoryTypeFlags(uint32_t memoryTypeIndex) { return m_memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags; }
+    const VkPhysicalDeviceMemoryProperties& getMemoryProperties() { return m_memoryProperties; }
+    // True when the GPU's main memory is also host-visible (phones, integrated GPUs, ReBAR):
+    // inputs can then be mapped directly instead of going through a staging copy.
+    bool isUnifiedMemory() { return m_unifiedMemory; }
+    VkDeviceSize getNonCoherentAtomSize() { return m_nonCoherentAtomSize; }
+    VkDeviceSize getMinStorageBufferOffsetAlignment() { return m_minStorageBufferOffsetAlignment; }
+    uint32_t getMaxComputeWorkGroupCountX() { return m_maxComputeWorkGroupCountX; }
     float getTimeStampPeriod() { return m_timestampPeriod; }
+    // Meaningful bits of a compute-queue timestamp (0: the queue family cannot write timestamps)
+    uint32_t getTimestampValidBits() { return m_timestampValidBits; }
+
+    // pipelineStatisticsQuery was available and is enabled (see PipelineStatistics.h)
+    bool hasPipelineStatistics() { return m_pipelineStatistics; }
+
+    // --- Calibrated Timestamps (VK_EXT_calibrated_timestamps, see GpuProfiler.h) ---
+    bool hasCalibratedTimestamps() { return m_getCalibratedTimestamps != nullptr; }
+    // A device tick count and the CLOCK_MONOTONIC time (ns, the steady_clock on Android) sampled together,
+    // within 'maxDeviationNs' of each other. False without the extension or if the driver fails.
+    bool getCalibratedTimestamps(uint64_t& deviceTicks, uint64_t& hostNs, uint64_t& maxDeviationNs);
+
+    // --- Host Pointer Import (VK_EXT_external_memory_host, see HostBuffer.h) ---
+    bool hasHostPointerImport() { return m_getMemoryHostPointerProperties != nullptr; }
+    // Imported pointers and sizes must be multiples of this (0 without the extension)
+    VkDeviceSize getMinImportedHostPointerAlignment() { return m_minImportedHostPointerAlignment; }
+    // Memory types a host allocation can be imported into (0 if it cannot)
+    uint32_t getHostPointerMemoryTypeBits(const void* hostPointer);
 
 private:
     // --- Private Singleton Constructor ---
@@ -43,16 +104,44 @@ private:
     VkPhysicalDevice m_physicalDevice = VK_NULL_HANDLE;
     VkDevice m_device = VK_NULL_HANDLE;
     VkQueue m_queue = VK_NULL_HANDLE;
-    VkCommandPool m_commandPool = VK_NULL_HANDLE;
     uint32_t m_computeQueueFamilyIndex = -1;
+    std::vector<VkQueue> m_computeQueues; // [0] == m_queue
+    VkQueue m_transferQueue = VK_NULL_HANDLE;
+    uint32_t m_transferQueueFamilyIndex = -1;
+    UploadRing* m_uploadRing = nullptr;
+    SubmitQueue* m_submitQueue = nullptr;
+    ScratchPool* m_scratchPool = nullptr;
+    std::mutex m_poolMutex;
+    std::vector<VkCommandPool> m_threadPools; // Every per-thread pool, destroyed in cleanup()
+    std::vector<VkCommandPool> m_freePools;   // Pools of exited threads, handed to new threads first
+    std::atomic<uint32_t> m_generation{0};    // Bumped by init(); stale thread-local pools are ignored
     float m_timestampPeriod = 1.0f;
+    uint32_t m_timestampValidBits = 0;
+    bool m_calibratedTimestampsSupported = false; // Extension with both DEVICE and CLOCK_MONOTONIC domains
+    PFN_vkGetCalibratedTimestampsEXT m_getCalibratedTimestamps = nullptr;
+    bool m_pipelineStatistics = false;
+    VkDeviceSize m_nonCoherentAtomSize = 1;
+    VkDeviceSize m_minStorageBufferOffsetAlignment = 1;
+    uint32_t m_maxComputeWorkGroupCountX = 65535;
+    VkPhysicalDeviceType m_deviceType = VK_PHYSICAL_DEVICE_TYPE_OTHER;
+    VkPhysicalDeviceMemoryProperties m_memoryProperties{};
+    bool m_unifiedMemory = false;
+    std::vector<const char*> m_deviceExtensions; // Enabled at device creation
+    VkDeviceSize m_minImportedHostPointerAlignment = 0;
+    PFN_vkGetMemoryHostPointerPropertiesEXT m_getMemoryHostPointerProperties = nullptr;
 
     // --- Private Helpers ---
     void createInstance();
     void pickPhysicalDevice();
+    void queryDeviceExtensions();
+    void queryMemoryProperties();
+    int scoreMemoryType(uint32_t memoryTypeIndex, MemoryUsage usage);
     void findComputeQueueFamily();
+    void findTransferQueueFamily();
     void createLogicalDeviceAndQueue();
-    void createCommandPool(); // <-- FIX: Renamed from createCommonPool
+    VkCommandPool createThreadCommandPool();
 
-    static VulkanContext* s_instance;
+    static const VkDeviceSize UPLOAD_RING_SIZE = 8 * 1024 * 1024;
+    static const VkDeviceSize SCRATCH_POOL_SIZE = 1024 * 1024;
+    static constexpr uint32_t MAX_COMPUTE_QUEUES = 4;
 };
\ No newline at end of file
@@ -0,0 +1,65 @@
+// Desktop entry point: the out-of-core reduction without the Android app around it,
+// on any Linux Vulkan driver (a software ICD such as lavapipe is enough).
+//
+// usage: out_of_core_reduce [file.f32 [chunk_elements]]
+// Without a file, a test file is written to /tmp and checked against its reference sum.
+#include "VulkanContext.h"
+#include "OutOfCoreReduceTask.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <stdexcept>
+
+static const uint64_t TEST_FILE_ELEMENTS = 64ull * 1024 * 1024; // 256 MiB
+
+int main(int argc, char** argv) {
+    std::string path = argc > 1 ? argv[1] : "";
+    uint32_t chunkElements = OutOfCoreReduceTask::DEFAULT_CHUNK_ELEMENTS;
+    if (argc > 2) {
+        chunkElements = static_cast<uint32_t>(strtoul(argv[2], nullptr, 10));
+    }
+
+    VulkanContext* context = VulkanContext::getInstance();
+    context->init();
+    if (context->getDevice() == VK_NULL_HANDLE) {
+        LOGE("No Vulkan device: is a Vulkan ICD installed?");
+        Logger::flush();
+        return 1;
+    }
+
+    // --- Input: the given file, or a generated one with a known sum ---
+    bool generated = path.empty();
+    double expected = 0.0;
+    double absSum = 0.0;
+    if (generated) {
+        path = "/tmp/out_of_core.f32";
+    }
+
+    int status = 0;
+    try {
+        if (generated) {
+            OutOfCoreReduceTask::writeTestFile(path, TEST_FILE_ELEMENTS, InputDistribution::uniform(-1.0f, 1.0f, 7),
+                                               expected, absSum);
+        }
+        OutOfCoreReduceTask task(nullptr, path, chunkElements);
+        if (generated) {
+            task.setReference(expected, absSum);
+        }
+        task.init();
+        task.run(); // Warm-up (also pulls the file into the page cache)
+        OutOfCoreStats stats = task.run();
+        OutOfCoreReduceTask::logStats(stats);
+        printf("sum=%.17g GBs=%.3f bottleneck=%s correct=%s\n", stats.sum, stats.endToEndGBs, stats.bottleneck,
+               stats.valid ? "yes" : "NO");
+        if (!stats.valid) status = 1;
+        task.cleanup();
+    } catch (const std::exception& e) {
+        LOGE("Out-of-core reduction failed: %s", e.what());
+        status = 1;
+    }
+
+    if (generated) std::remove(path.c_str());
+    context->cleanup();
+    Logger::flush();
+    return status;
+}
@@ -4,6 +4,17 @@
 #include <android/asset_manager_jni.h>
 #include <vector>
 #include <sstream> // For logging the final table
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <shared_mutex>
+#include <functional>
+#include <memory>
 
 // --- Include all our tasks ---
 #include "VulkanContext.h"
@@ -13,10 +24,73 @@
 #include "CpuReduceTask.h"
 //#include "GpuTreeReduceTask.h"    // (For factory)
 #include "GpuOptimizedReduceTask.h"
+#include "StreamingReduceTask.h"
+#include "SubmitQueue.h"
+#include "TaskBatch.h"
+#include "SegmentedReduceTask.h"
+#include "FusedReduceTask.h"
+#include "ElementwiseTask.h"
+#include "InputGenerator.h"
+#include "FrugalReduceTask.h"
+#include "OutOfCoreReduceTask.h"
+#include "HostBuffer.h"
+#include "ReduceCache.h"
+#include "BenchmarkRunner.h"
+#include "ReduceDispatcher.h"
+#include "HybridReduceTask.h"
+#include "Trace.h"
+#include "Roofline.h"
+#include "GpuBandwidthTask.h"
+#include "CpuBandwidthTask.h"
 
 // --- Global Pointers ---
 VulkanContext* g_context = nullptr;
 AAssetManager* g_assetManager = nullptr;
+std::string g_cacheDir; // The app's cache directory, for scratch files
+ReduceCache* g_reduceCache = nullptr; // Tasks behind the reduce*() JNI entry points
+std::mutex g_initMutex;
+std::shared_mutex g_reduceCacheMutex; // Shared for a whole reduce*() call, exclusive to create or delete the cache
+BenchmarkRunner g_benchmark; // Runs the experiment sweep off the UI thread
+ReduceDispatcher* g_dispatcher = nullptr; // Created by the dispatcher experiment
+std::mutex g_dispatcherMutex;             // Guards g_dispatcher and g_thermalStatus
+int g_thermalStatus = 0;                  // Last PowerManager thermal status from the app
+Roofline g_roofline; // Measured first in every sweep (worker thread only); the others report against it
+
+// 'bytes' moved in 'us' as a percentage of the measured roofline at 'workingSetBytes'; -1 when untimed
+static double rooflinePct(const char* processor, uint64_t workingSetBytes, uint64_t bytes, double us) {
+    return us > 0.0 ? g_roofline.percentOf(processor, workingSetBytes, bytes / (us * 1000.0)) : -1.0;
+}
+
+// cleanup() joins the sweep from the UI thread, so every experiment that runs for more than a
+// moment also checks this inside its loops, not only between configurations
+static bool stopRequested() {
+    return g_benchmark.isStopRequested();
+}
+
+// Vulkan comes up on first use: the experiment sweep or a reduce*() call, whichever is first
+static void ensureContext() {
+    std::lock_guard<std::mutex> lock(g_initMutex);
+    if (g_context != nullptr) return;
+    LOGI("--- Initializing Vulkan Context ---");
+    VulkanContext* context = VulkanContext::getInstance();
+    context->init();
+    {
+        std::unique_lock<std::shared_mutex> cacheLock(g_reduceCacheMutex);
+        g_reduceCache = new ReduceCache(g_assetManager);
+    }
+    g_context = context;
+}
+
+// Brings Vulkan up if needed and returns the cache, held for as long as 'lock' is:
+// cleanup() cannot delete it (or the context under it) in the middle of a call
+static ReduceCache& lockReduceCache(std::shared_lock<std::shared_mutex>& lock) {
+    ensureContext();
+    lock = std::shared_lock<std::shared_mutex>(g_reduceCacheMutex);
+    if (g_reduceCache == nullptr) {
+        throw std::runtime_error("Compute resources were cleaned up!");
+    }
+    return *g_reduceCache;
+}
 
 
 // --- Task Factory ---
@@ -29,10 +103,12 @@ enum class TaskID {
 };
 
 // This factory can now create any task we've built
-ComputeTask* createTask(TaskID id, uint32_t n) {
+// (the reductions take their input distribution; the default is all 1.0)
+ComputeTask* createTask(TaskID id, uint32_t n,
+                        const InputDistribution& distribution = InputDistribution::constant(1.0f)) {
     switch (id) {
         case TaskID::CPU_REDUCE:
-            return new CpuReduceTask(n);
+            return new CpuReduceTask(n, distribution);
 
 //        case TaskID::GPU_TREE_REDUCE:
 //            if (g_assetManager == nullptr) {
@@ -41,44 +117,901 @@ ComputeTask* createTask(TaskID id, uint32_t n) {
 //            }
 //            return new GpuTreeReduceTask(g_assetManager, n);
 
-        case TaskID::GPU_OPTIMIZED_REDUCE:
+        case TaskID::GPU_OPTIMIZED_REDUCE: {
             if (g_assetManager == nullptr) {
                 LOGE("AssetManager is null, cannot create GpuTask");
                 return nullptr;
             }
-            return new GpuOptimizedReduceTask(g_assetManager, n);
+            GpuOptimizedReduceTask* task = new GpuOptimizedReduceTask(g_assetManager, n);
+            task->setInputDistribution(distribution);
+            return task;
+        }
 
-            // --- These are not used in this experiment, but the factory can build them ---
         case TaskID::VECTOR_ADD:
+            if (g_assetManager == nullptr) {
+                LOGE("AssetManager is null, cannot create GpuTask");
+                return nullptr;
+            }
+            return new VectorAddTask(g_assetManager, n);
+
+            // --- These are not used in this experiment, but the factory can build them ---
         case TaskID::LOCAL_REDUCE:
         default:
             return nullptr;
     }
 }
 
+// --- Iterative Workload: serial reset()/dispatch() loop vs. the streaming ring ---
+static void runIterativeExperiment(uint32_t n, uint32_t iterations) {
+    LOGI("--- STARTING ITERATIVE EXPERIMENT (N=%u, %u iterations) ---", n, iterations);
+
+    std::stringstream ss;
+    ss << "\n\n--- ITERATIVE RESULTS (Serial vs. Streaming vs. Multi-Queue) ---\n";
+    ss << "Mode,Slots,Queues,Total_us,Iter_per_s,Fill_us,Wait_us,GPU_us,GPU_Util_pct\n";
+
+    auto addRow = [&ss](const char* mode, uint32_t slots, const StreamingStats& stats) {
+        ss << mode << "," << slots << "," << stats.queueCount << "," << stats.totalTimeUs << ","
+           << stats.iterationsPerSecond << "," << stats.avgHostFillUs << "," << stats.avgHostWaitUs << ","
+           << stats.avgGpuUs << "," << (stats.gpuUtilization >= 0.0 ? stats.gpuUtilization * 100.0 : -1.0) << "\n";
+    };
+
+    // One queue, then every compute queue the device exposes (if more than one)
+    uint32_t maxQueues = g_context->getComputeQueueCount();
+    std::vector<uint32_t> queueCounts = {1};
+    if (maxQueues > 1) queueCounts.push_back(maxQueues);
+
+    for (uint32_t queues : queueCounts) {
+        for (uint32_t slots = 2; slots <= 3; slots++) {
+            if (stopRequested()) break;
+            StreamingReduceTask task(g_assetManager, n, slots, iterations, queues);
+            task.init();
+
+            // The serial run also provides the GPU-time estimate used when timestamps are unusable
+            StreamingStats serial = task.runSerial(iterations);
+            StreamingStats streaming = task.runStreaming(iterations);
+            StreamingReduceTask::logStats("SERIAL", serial);
+            StreamingReduceTask::logStats("STREAMING", streaming);
+
+            if (slots == 2 && queues == 1) {
+                addRow("Serial", 1, serial);
+            }
+            addRow(queues == 1 ? "Streaming" : "Streaming-MQ", slots, streaming);
+
+            task.cleanup();
+        }
+    }
+    if (maxQueues == 1) {
+        LOGI("Only one compute queue on this device; multi-queue rows skipped.");
+    }
+    ss << "--- END OF ITERATIVE RESULTS ---\n\n";
+    LOGI("%s", ss.str().c_str());
+}
+
+// --- Batched Workload: many small reductions, one submit each vs. one submit per batch ---
+static void runBatchExperiment(uint32_t n, const std::vector<uint32_t>& batchSizes) {
+    LOGI("--- STARTING BATCH EXPERIMENT (N=%u) ---", n);
+
+    std::stringstream ss;
+    ss << "\n\n--- BATCH RESULTS (Individual vs. TaskBatch, N=" << n << ") ---\n";
+    ss << "Batch_Size,Individual_Jobs_per_s,Batched_Jobs_per_s,Speedup,All_Correct\n";
+
+    for (uint32_t batchSize : batchSizes) {
+        if (stopRequested()) break;
+        std::vector<GpuOptimizedReduceTask*> tasks;
+        for (uint32_t i = 0; i < batchSize; i++) {
+            GpuOptimizedReduceTask* task = new GpuOptimizedReduceTask(g_assetManager, n);
+            task->init();
+            tasks.push_back(task);
+        }
+
+        // Individual: dispatch() = one submit and one wait per job
+        auto start = std::chrono::high_resolution_clock::now();
+        for (GpuOptimizedReduceTask* task : tasks) {
+            task->dispatch();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double individualUs = (double)std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+        // Batched: the same reductions over the inputs init() generated, in one submission
+        TaskBatch batch;
+        for (GpuOptimizedReduceTask* task : tasks) {
+            batch.add(task);
+        }
+        std::vector<TaskResult> results = batch.run();
+        double batchedUs = (double)batch.getLastRunTimeUs();
+
+        bool allCorrect = true;
+        for (const TaskResult& result : results) {
+            allCorrect = allCorrect && result.valid;
+        }
+
+        double individualJobsPerSecond = individualUs > 0 ? batchSize * 1e6 / individualUs : 0.0;
+        double batchedJobsPerSecond = batchedUs > 0 ? batchSize * 1e6 / batchedUs : 0.0;
+        ss << batchSize << "," << individualJobsPerSecond << "," << batchedJobsPerSecond << ","
+           << (individualJobsPerSecond > 0 ? batchedJobsPerSecond / individualJobsPerSecond : 0.0) << ","
+           << (allCorrect ? "yes" : "NO") << "\n";
+
+        for (GpuOptimizedReduceTask* task : tasks) {
+            task->cleanup();
+            delete task;
+        }
+    }
+    ss << "--- END OF BATCH RESULTS ---\n\n";
+    LOGI("%s", ss.str().c_str());
+}
+
+// --- Segmented Workload: thousands of small arrays in one task ---
+static void runSegmentedExperiment(uint32_t totalElements) {
+    LOGI("--- STARTING SEGMENTED EXPERIMENT (N=%u) ---", totalElements);
+
+    std::stringstream ss;
+    ss << "\n\n--- SEGMENTED RESULTS (N=" << totalElements << ") ---\n";
+    ss << "Layout,Segments,Mapping,Host_us,GPU_us,GPU_us_per_segment,Pct_of_roofline,Correct\n";
+
+    std::vector<float> values(totalElements);
+    for (uint32_t i = 0; i < totalElements; i++) {
+        values[i] = (float)(i % 7) * 0.5f;
+    }
+
+    // Every layout reads each value once
+    uint64_t bytes = sizeof(float) * (uint64_t)totalElements;
+    auto runOne = [&ss, bytes](const std::string& layout, SegmentedReduceTask& task) {
+        if (stopRequested()) return;
+        task.init();
+        task.dispatch(); // Warm-up
+        long long hostUs = task.dispatch();
+        TaskResult result = task.readResult();
+        ss << layout << "," << task.getSegmentCount() << ","
+           << SegmentedReduceTask::getMappingName(task.getMapping()) << "," << hostUs << ","
+           << result.gpuTimeUs << "," << (result.gpuTimeUs > 0 ? result.gpuTimeUs / task.getSegmentCount() : -1.0)
+           << "," << rooflinePct("gpu", bytes, bytes, result.gpuTimeUs) << ","
+           << (result.valid ? "yes" : "NO") << "\n";
+        task.cleanup();
+    };
+
+    // Uniform lengths, from tiny to large
+    for (uint32_t length : {16u, 256u, 1024u, 4096u, 16384u}) {
+        SegmentedReduceTask task(g_assetManager, values, length);
+        runOne("uniform-" + std::to_string(length), task);
+    }
+
+    // Mixed: small arrays of random length (1..16K) plus one large one
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<uint32_t> lengthDist(1, 16384);
+    std::vector<uint32_t> offsets = {0};
+    uint32_t largeLength = totalElements / 2;
+    offsets.push_back(largeLength);
+    while (offsets.back() < totalElements) {
+        offsets.push_back(std::min(totalElements, offsets.back() + lengthDist(rng)));
+    }
+    SegmentedReduceTask mixed(g_assetManager, values, offsets);
+    runOne("mixed", mixed);
+
+    ss << "--- END OF SEGMENTED RESULTS ---\n\n";
+    LOGI("%s", ss.str().c_str());
+}
+
+// --- Fused Workload: map-reduce in one pass vs. the two-task pipeline ---
+static void runFusedExperiment(uint32_t n) {
+    LOGI("--- STARTING FUSED EXPERIMENT (N=%u) ---", n);
+
+    std::stringstream ss;
+    ss << "\n\n--- FUSED RESULTS (N=" << n << ") ---\n";
+    ss << "Op,Pipeline,Host_us,GPU_us,MB_moved,GB_per_s,Pct_of_roofline,Value,Correct\n";
+
+    const FusedOp ops[] = {FusedOp::DOT, FusedOp::SUM_OF_SQUARES, FusedOp::L1_NORM,
+                           FusedOp::L2_NORM, FusedOp::MEAN_VARIANCE};
+    for (FusedOp op : ops) {
+        for (bool fused : {false, true}) {
+            if (stopRequested()) break;
+            FusedReduceTask task(g_assetManager, op, n);
+            task.setFused(fused);
+            task.init();
+            task.dispatch(); // Warm-up
+            long long hostUs = task.dispatch();
+            TaskResult result = task.readResult();
+
+            double megabytes = task.getBytesMoved() / 1.0e6;
+            ss << FusedReduceTask::getOpName(op) << "," << (fused ? "fused" : "two-task") << ","
+               << hostUs << "," << result.gpuTimeUs << "," << megabytes << ","
+               << (result.gpuTimeUs > 0 ? task.getBytesMoved() / (result.gpuTimeUs * 1000.0) : -1.0) << ","
+               << rooflinePct("gpu", task.getBytesMoved(), task.getBytesMoved(), result.gpuTimeUs) << ","
+               << result.value << (op == FusedOp::MEAN_VARIANCE ? " var=" + std::to_string(task.getVariance()) : "")
+               << "," << (result.valid ? "yes" : "NO") << "\n";
+            task.cleanup();
+        }
+    }
+
+    ss << "--- END OF FUSED RESULTS ---\n\n";
+    LOGI("%s", ss.str().c_str());
+}
+
+// --- Elementwise Workload: achieved bandwidth per op ---
+static void runElementwiseExperiment(uint32_t n) {
+    LOGI("--- STARTING ELEMENTWISE EXPERIMENT (N=%u) ---", n);
+
+    std::stringstream ss;
+    ss << "\n\n--- ELEMENTWISE RESULTS (N=" << n << ") ---\n";
+    ss << "Op,InPlace,Host_us,GPU_us,MB_moved,GB_per_s,Pct_of_roofline,Correct\n";
+
+    const ElementwiseOp ops[] = {ElementwiseOp::ADD, ElementwiseOp::AXPY, ElementwiseOp::SCALE,
+                                 ElementwiseOp::FMA, ElementwiseOp::CLAMP, ElementwiseOp::TO_HALF};
+    for (ElementwiseOp op : ops) {
+        for (bool inPlace : {false, true}) {
+            if (inPlace && op == ElementwiseOp::TO_HALF) continue;
+            if (stopRequested()) break;
+
+            ElementwiseTask task(g_assetManager, op, n);
+            task.setInPlace(inPlace);
+            task.init();
+            task.dispatch(); // Warm-up
+            long long hostUs = task.dispatch();
+            TaskResult result = task.readResult();
+
+            double megabytes = task.getBytesMoved() / 1.0e6;
+            // -1 when the GPU time is not trustworthy (see GpuProfiler)
+            double gbPerS = result.gpuTimeUs > 0 ? task.getBytesMoved() / (result.gpuTimeUs * 1000.0) : -1.0;
+            ss << ElementwiseTask::getOpName(op) << "," << (inPlace ? "yes" : "no") << ","
+               << hostUs << "," << result.gpuTimeUs << "," << megabytes << "," << gbPerS << ","
+               << g_roofline.percentOf("gpu", task.getBytesMoved(), gbPerS) << ","
+               << (result.valid ? "yes" : "NO") << "\n";
+            task.cleanup();
+        }
+    }
+
+    ss << "--- END OF ELEMENTWISE RESULTS ---\n\n";
+    LOGI("%s", ss.str().c_str());
+}
+
+// --- Input Workload: host fill vs. GPU generation, per distribution ---
+static void runInputExperiment(uint32_t n) {
+    LOGI("--- STARTING INPUT EXPERIMENT (N=%u) ---", n);
+
+    std::stringstream ss;
+    ss << "\n\n--- INPUT RESULTS (N=" << n << ") ---\n";
+    ss << "Distribution,Host_fill_us,GPU_generate_us,GPU_reduce_us,Sum,Correct\n";
+
+    const InputDistribution distributions[] = {
+            InputDistribution::constant(1.0f),
+            InputDistribution::iota(0.0f, 1.0f / 1024.0f),
+            InputDistribution::uniform(-1.0f, 1.0f, 42),
+            InputDistribution::normal(0.0f, 1.0f, 42)
+    };
+    for (const InputDistribution& distribution : distributions) {
+        if (stopRequested()) break;
+        // What a host-side reset() would cost
+        std::vector<float> hostData(n);
+        auto fillStart = std::chrono::high_resolution_clock::now();
+        InputGenerator::hostFill(distribution, hostData.data(), n);
+        auto fillEnd = std::chrono::high_resolution_clock::now();
+        long long hostFillUs = std::chrono::duration_cast<std::chrono::microseconds>(fillEnd - fillStart).count();
+
+        // The CPU baseline checks the same values (result in the log)
+        CpuReduceTask cpuTask(n, distribution);
+        cpuTask.init();
+        cpuTask.dispatch();
+        cpuTask.cleanup();
+
+        GpuOptimizedReduceTask gpuTask(g_assetManager, n);
+        gpuTask.setInputDistribution(distribution);
+        gpuTask.init();
+        gpuTask.dispatch(); // Warm-up
+        gpuTask.dispatch();
+        TaskResult result = gpuTask.readResult();
+
+        ss << distribution.getName() << "," << hostFillUs << "," << gpuTask.getLastGenerateUs() << ","
+           << result.gpuTimeUs << "," << result.value << "," << (result.valid ? "yes" : "NO") << "\n";
+        gpuTask.cleanup();
+    }
+
+    ss << "--- END OF INPUT RESULTS ---\n\n";
+    LOGI("%s", ss.str().c_str());
+}
+
+// --- Memory-Frugal Reduction: device footprint vs. GpuOptimizedReduceTask ---
+static void runFrugalExperiment(const std::vector<uint32_t>& sizes, uint32_t admissionN) {
+    LOGI("--- STARTING FRUGAL EXPERIMENT ---");
+
+    std::stringstream ss;
+    ss << "\n\n--- FRUGAL RESULTS ---\n";
+    ss << "N,Task,Device_bytes,Scratch_bytes,GPU_us,Pct_of_roofline,Sum,Correct\n";
+
+    for (uint32_t n : sizes) {
+        if (stopRequested()) break;
+        uint64_t bytes = sizeof(float) * (uint64_t)n; // All three read the input once
+        // The baseline launches one workgroup per 256 elements: past the device's
+        // workgroup-count limit only the frugal task (capped grid) can run
+        if (n <= GpuOptimizedReduceTask::getMaxElementCount()) {
+            GpuOptimizedReduceTask optimizedTask(g_assetManager, n);
+            optimizedTask.init();
+            optimizedTask.dispatch(); // Warm-up
+            optimizedTask.dispatch();
+            TaskResult result = optimizedTask.readResult();
+            ss << n << ",optimized," << optimizedTask.getDeviceMemoryBytes() << ",-," << result.gpuTimeUs << ","
+               << rooflinePct("gpu", bytes, bytes, result.gpuTimeUs) << "," << result.value << ","
+               << (result.valid ? "yes" : "NO") << "\n";
+            optimizedTask.cleanup();
+        } else {
+            ss << n << ",optimized,-,-,-,-,-,too many workgroups\n";
+        }
+
+        FrugalReduceTask ownedTask(g_assetManager, n);
+        ownedTask.init();
+        ownedTask.dispatch(); // Warm-up
+        ownedTask.dispatch();
+        TaskResult result = ownedTask.readResult();
+        ss << n << ",frugal-owned," << ownedTask.getDeviceMemoryBytes() << "," << ownedTask.getScratchBytes() << ","
+           << result.gpuTimeUs << "," << rooflinePct("gpu", bytes, bytes, result.gpuTimeUs) << "," << result.value
+           << "," << (result.valid ? "yes" : "NO") << "\n";
+
+        // The same input, borrowed: only the scratch range and the readback are the task's own
+        FrugalReduceTask borrowedTask(g_assetManager, ownedTask.getInputBuffer(), n, ownedTask.getExpectedSum());
+        borrowedTask.init();
+        borrowedTask.dispatch(); // Warm-up
+        borrowedTask.dispatch();
+        result = borrowedTask.readResult();
+        ss << n << ",frugal-borrowed," << borrowedTask.getDeviceMemoryBytes() << ","
+           << borrowedTask.getScratchBytes() << "," << result.gpuTimeUs << ","
+           << rooflinePct("gpu", bytes, bytes, result.gpuTimeUs) << "," << result.value << ","
+           << (result.valid ? "yes" : "NO") << "\n";
+        borrowedTask.cleanup();
+        ownedTask.cleanup();
+    }
+
+    // Admission: decided from the estimate alone, nothing is allocated.
+    // Policy: a job may take at most half of the largest device-local heap.
+    const VkPhysicalDeviceMemoryProperties& memoryProperties = g_context->getMemoryProperties();
+    VkDeviceSize heapSize = 0;
+    for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++) {
+        if (memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) {
+            heapSize = std::max(heapSize, memoryProperties.memoryHeaps[i].size);
+        }
+    }
+    VkDeviceSize estimate = FrugalReduceTask::estimateDeviceMemory(admissionN, true);
+    ss << "Admission: N=" << admissionN << " needs <= " << estimate << " bytes, device-local heap "
+       << heapSize << " bytes -> " << (estimate <= heapSize / 2 ? "admit" : "reject") << "\n";
+
+    ss << "--- END OF FRUGAL RESULTS ---\n\n";
+    LOGI("%s", ss.str().c_str());
+}
+
+// --- Out-of-Core Streaming: a float file reduced chunk by chunk ---
+static void runOutOfCoreExperiment(uint64_t elements, const std::vector<uint32_t>& chunkSizes) {
+    if (g_cacheDir.empty()) {
+        LOGW("No cache directory: skipping the out-of-core experiment");
+        return;
+    }
+    LOGI("--- STARTING OUT-OF-CORE EXPERIMENT (N=%llu) ---", (unsigned long long)elements);
+
+    std::string path = g_cacheDir + "/out_of_core.f32";
+    double expected = 0.0;
+    double absSum = 0.0;
+    // Writing and reading 256 MiB takes seconds: both stop as soon as asked
+    if (!OutOfCoreReduceTask::writeTestFile(path, elements, InputDistribution::uniform(-1.0f, 1.0f, 7), expected,
+                                            absSum, stopRequested)) {
+        return;
+    }
+
+    std::stringstream ss;
+    ss << "\n\n--- OUT-OF-CORE RESULTS (N=" << elements << ", " << (sizeof(float) * elements >> 20) << " MiB) ---\n";
+    ss << "Chunk_MiB,Slots,Uploads,Total_us,GBs,Read_us,Upload_us,Reduce_us,Reduce_pct_of_roofline,Bottleneck,"
+          "Sum,Correct\n";
+    for (uint32_t chunkElements : chunkSizes) {
+        if (stopRequested()) break;
+        OutOfCoreReduceTask task(g_assetManager, path, chunkElements);
+        task.setReference(expected, absSum);
+        task.setStopCheck(stopRequested);
+        task.init();
+        task.run(); // Warm-up (also pulls the file into the page cache)
+        OutOfCoreStats stats = task.run();
+        OutOfCoreReduceTask::logStats(stats);
+        if (stats.stopped) {
+            task.cleanup();
+            break;
+        }
+        ss << (sizeof(float) * chunkElements >> 20) << "," << stats.slotCount << ","
+           << (stats.transferQueue ? "transfer" : "inline") << "," << stats.totalTimeUs << "," << stats.endToEndGBs
+           << "," << stats.readUs << "," << stats.uploadUs << "," << stats.reduceUs << ","
+           // The reduce stage sees one chunk at a time, so that is its working set
+           << rooflinePct("gpu", sizeof(float) * (uint64_t)chunkElements, stats.bytes, stats.reduceUs) << ","
+           << stats.bottleneck << ","
+           << stats.sum << "," << (stats.valid ? "yes" : "NO") << "\n";
+        task.cleanup();
+    }
+    std::remove(path.c_str());
+
+    ss << "--- END OF OUT-OF-CORE RESULTS ---\n\n";
+    LOGI("%s", ss.str().c_str());
+}
+
+// --- Host Import: caller-owned memory read in place vs. copied every iteration ---
+static void runHostImportExperiment(uint32_t n, uint32_t iterations) {
+    LOGI("--- STARTING HOST IMPORT EXPERIMENT (N=%u, %u iterations) ---", n, iterations);
+
+    // The caller's allocation, aligned and padded so it can be imported
+    VkDeviceSize alignment = std::max<VkDeviceSize>(4096, g_context->getMinImportedHostPointerAlignment());
+    VkDeviceSize bytes = HostBuffer::alignForImport(g_context, sizeof(float) * n);
+    void* hostData = nullptr;
+    if (posix_memalign(&hostData, alignment, bytes) != 0) {
+        throw std::runtime_error("Failed to allocate the host import buffer!");
+    }
+    InputDistribution distribution = InputDistribution::uniform(-1.0f, 1.0f, 11);
+    double expected = 0.0;
+    double absSum = 0.0;
+    InputGenerator::hostReference(distribution, n, expected, absSum);
+
+    std::stringstream ss;
+    ss << "\n\n--- HOST IMPORT RESULTS (N=" << n << ", extension "
+       << (g_context->hasHostPointerImport() ? "present" : "absent") << ") ---\n";
+    ss << "Mode,Path,Fill_us,Update_us,Dispatch_us,GPU_us,Correct,Fallback_reason\n";
+
+    // Each iteration the caller produces the data again, makes it visible and reduces it
+    auto runMode = [&](const char* mode, bool allowImport) {
+        HostBuffer hostBuffer;
+        hostBuffer.create(g_context, hostData, bytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, allowImport);
+        FrugalReduceTask task(g_assetManager, hostBuffer.getBuffer(), n, expected);
+        task.init();
+
+        double fillUs = 0.0, updateUs = 0.0, dispatchUs = 0.0, gpuUs = 0.0;
+        uint32_t gpuSamples = 0; // Untrusted GPU times (-1) are left out of the average
+        bool valid = true;
+        bool stopped = false;
+        for (uint32_t i = 0; i <= iterations; i++) { // Iteration 0 is the warm-up
+            if (stopRequested()) {
+                stopped = true;
+                break;
+            }
+            auto t0 = std::chrono::high_resolution_clock::now();
+            InputGenerator::hostFill(distribution, static_cast<float*>(hostData), n);
+            auto t1 = std::chrono::high_resolution_clock::now();
+            hostBuffer.update(0, sizeof(float) * n);
+            auto t2 = std::chrono::high_resolution_clock::now();
+            long long dispatchTime = task.dispatch();
+            TaskResult result = task.readResult();
+            if (i == 0) continue;
+            fillUs += std::chrono::duration<double, std::micro>(t1 - t0).count();
+            updateUs += std::chrono::duration<double, std::micro>(t2 - t1).count();
+            dispatchUs += dispatchTime;
+            if (result.gpuTimeUs >= 0.0) {
+                gpuUs += result.gpuTimeUs;
+                gpuSamples++;
+            }
+            valid = valid && result.valid;
+        }
+        if (!stopped) {
+            ss << mode << "," << HostBuffer::getPathName(hostBuffer.getPath()) << "," << fillUs / iterations << ","
+               << updateUs / iterations << "," << dispatchUs / iterations << ","
+               << (gpuSamples ? gpuUs / gpuSamples : -1.0) << ","
+               << (valid ? "yes" : "NO") << ","
+               << (hostBuffer.getFallbackReason() ? hostBuffer.getFallbackReason() : "-") << "\n";
+        }
+
+        task.cleanup();
+        hostBuffer.destroy();
+    };
+    runMode("import", true);
+    runMode("copy", false);
+    std::free(hostData);
+
+    ss << "--- END OF HOST IMPORT RESULTS ---\n\n";
+    LOGI("%s", ss.str().c_str());
+}
+
+// --- JNI Data Path: first call of a size class vs. cached calls, copied vs. imported ---
+static void runReduceCacheExperiment(const std::vector<uint32_t>& counts) {
+    LOGI("--- STARTING REDUCE CACHE EXPERIMENT ---");
+
+    std::stringstream ss;
+    ss << "\n\n--- REDUCE CACHE RESULTS (what reduceFloatArray / reduceDirectBuffer cost) ---\n";
+    ss << "N,Op,Call,Path,Copy_us,Host_us,GPU_us,Pct_of_roofline,Value,Reference\n";
+
+    std::shared_lock<std::shared_mutex> cacheLock;
+    ReduceCache& cache = lockReduceCache(cacheLock);
+    InputDistribution distribution = InputDistribution::uniform(-1.0f, 1.0f, 5);
+    for (uint32_t n : counts) {
+        if (stopRequested()) break;
+        // The caller's array, page-aligned so it can also be registered
+        VkDeviceSize bytes = HostBuffer::alignForImport(g_context, sizeof(float) * n);
+        void* data = nullptr;
+        if (posix_memalign(&data, std::max<VkDeviceSize>(4096, g_context->getMinImportedHostPointerAlignment()),
+                           bytes) != 0) {
+            throw std::runtime_error("Failed to allocate the reduce cache input!");
+        }
+        float* values = static_cast<float*>(data);
+        InputGenerator::hostFill(distribution, values, n);
+        double reference = 0.0;
+        double absSum = 0.0;
+        InputGenerator::hostReference(distribution, n, reference, absSum);
+
+        auto addRow = [&](const char* call, const HostReduceResult& result) {
+            ss << n << ",sum," << call << "," << HostBuffer::getPathName(result.path) << "," << result.copyUs << ","
+               << result.hostTimeUs << "," << result.gpuTimeUs << ","
+               << rooflinePct("gpu", sizeof(float) * (uint64_t)n, sizeof(float) * (uint64_t)n, result.gpuTimeUs) << ","
+               << result.value << "," << reference << "\n";
+        };
+        addRow("first", cache.reduce(FusedOp::SUM, values, n)); // Creates the size class
+        addRow("cached", cache.reduce(FusedOp::SUM, values, n));
+        if (cache.registerHostMemory(data, bytes)) {
+            addRow("registered", cache.reduce(FusedOp::SUM, values, n));
+            cache.unregisterHostMemory(data);
+        }
+        std::free(data);
+    }
+    ss << "Cached tasks: " << cache.getTaskCount() << "\n";
+    ss << "--- END OF REDUCE CACHE RESULTS ---\n\n";
+    LOGI("%s", ss.str().c_str());
+}
+
+// --- Adaptive Dispatch: route each N to the backend its calibrated cost model favours ---
+static void runDispatcherExperiment(const std::vector<uint32_t>& sizes) {
+    LOGI("--- STARTING DISPATCHER EXPERIMENT ---");
+    ReduceDispatcher* dispatcher;
+    {
+        std::lock_guard<std::mutex> lock(g_dispatcherMutex);
+        if (g_dispatcher == nullptr) {
+            g_dispatcher = new ReduceDispatcher(g_assetManager);
+            g_dispatcher->init();
+            g_dispatcher->setThermalStatus(g_thermalStatus);
+            g_dispatcher->setStopCheck(stopRequested); // Calibration (5 sizes x 6 runs x 2 backends) takes a while
+        }
+        dispatcher = g_dispatcher;
+    }
+    // A calibration measured earlier on this device (and at this thermal status) is reused
+    dispatcher->loadOrCalibrate(g_cacheDir.empty() ? "" : g_cacheDir + "/reduce_dispatcher.txt");
+
+    std::stringstream ss;
+    ss << "\n\n--- DISPATCHER RESULTS ---\n";
+    ss << "N,Backend,Predicted_us,Other_predicted_us,Actual_us,Correct\n";
+    for (uint32_t n : sizes) {
+        if (stopRequested()) break;
+        ReduceDispatch dispatch = dispatcher->reduce(n);
+        ss << n << "," << ReduceDispatcher::getBackendName(dispatch.backend) << "," << dispatch.predictedUs << ","
+           << dispatch.otherUs << "," << dispatch.result.hostTimeUs << "," << (dispatch.result.valid ? "yes" : "NO")
+           << "\n";
+    }
+    ss << "Metrics: " << dispatcher->getMetrics().toJson() << "\n";
+    ss << "--- END OF DISPATCHER RESULTS ---\n\n";
+    LOGI("%s", ss.str().c_str());
+}
+
+// --- CPU+GPU Co-execution: one input split across both, vs. each alone on the same buffer ---
+static void runHybridExperiment(BenchmarkRunner& runner, const std::vector<uint32_t>& sizes, uint32_t iterations) {
+    LOGI("--- STARTING HYBRID EXPERIMENT (%u iterations) ---", iterations);
+    std::stringstream ss;
+    ss << "\n\n--- HYBRID RESULTS (median of " << iterations << ") ---\n";
+    ss << "N,Mode,GPU_share,Time_us,GPU_side_us,CPU_side_us,Elements_per_us,Pct_of_roofline,Correct\n";
+
+    // Fixed shares of 1 and 0 run the exact same code with one side idle
+    struct Mode { const char* name; double share; bool adaptive; };
+    const Mode modes[] = {{"gpu-only", 1.0, false}, {"cpu-only", 0.0, false}, {"hybrid", 0.5, true}};
+    for (uint32_t n : sizes) {
+        HybridReduceTask task(g_assetManager, n, InputDistribution::uniform(-1.0f, 1.0f, 5));
+        task.init();
+        for (const Mode& mode : modes) {
+            if (runner.isStopRequested()) break;
+            if (mode.adaptive) {
+                task.setAdaptive(mode.share);
+            } else {
+                task.setFixedShare(mode.share);
+            }
+            // Warm-up, which is also where the adaptive share converges
+            for (uint32_t i = 0; i < 10 && !runner.isStopRequested(); i++) task.dispatch();
+            if (runner.isStopRequested()) break;
+
+            BenchmarkRecord record;
+            record.experiment = "hybrid";
+            record.backend = mode.name;
+            record.size = n;
+            std::vector<double> samples;
+            double gpuSideUs = 0.0, cpuSideUs = 0.0;
+            for (uint32_t i = 0; i < iterations; i++) {
+                samples.push_back((double)task.dispatch());
+                record.valid = record.valid && task.getLastResult().valid;
+                gpuSideUs += task.getLastSplit().gpuUs;
+                cpuSideUs += task.getLastSplit().cpuUs;
+            }
+            record.setSamples(samples);
+            record.addPhase("gpu_share", (double)task.getLastSplit().gpuElements / n);
+            record.addPhase("gpu_side_us", gpuSideUs / iterations);
+            record.addPhase("cpu_side_us", cpuSideUs / iterations);
+            // Against the roof of the side doing the work; the split against the higher of the two,
+            // since both sides stream from the same memory
+            uint64_t bytes = sizeof(float) * (uint64_t)n;
+            double gpuPct = rooflinePct("gpu", bytes, bytes, record.p50Us);
+            double cpuPct = rooflinePct("cpu", bytes, bytes, record.p50Us);
+            double pct = mode.adaptive ? ((gpuPct >= 0.0 && cpuPct >= 0.0) ? std::min(gpuPct, cpuPct) : -1.0)
+                                       : (mode.share > 0.0 ? gpuPct : cpuPct);
+            if (pct >= 0.0) record.addPhase("roofline_pct", pct);
+            runner.emit(record);
+
+            ss << n << "," << mode.name << "," << (double)task.getLastSplit().gpuElements / n << "," << record.p50Us
+               << "," << gpuSideUs / iterations << "," << cpuSideUs / iterations << "," << n / record.p50Us << ","
+               << pct << "," << (record.valid ? "yes" : "NO") << "\n";
+        }
+        task.cleanup();
+    }
+    ss << "--- END OF HYBRID RESULTS ---\n\n";
+    LOGI("%s", ss.str().c_str());
+}
+
+// --- GPU Profiler: per-pass and per-barrier timestamps, and whether they can be trusted ---
+static void runProfilerExperiment(BenchmarkRunner& runner, uint32_t n, uint32_t iterations) {
+    LOGI("--- STARTING PROFILER EXPERIMENT (N=%u, %u iterations) ---", n, iterations);
+    GpuOptimizedReduceTask task(g_assetManager, n);
+    task.init();
+
+    BenchmarkRecord record;
+    record.experiment = "profiler";
+    record.backend = "gpu-optimized";
+    record.size = n;
+    std::vector<double> reduceUs; // Trusted readings only
+    uint32_t trusted = 0;
+    task.dispatch(); // Warm-up
+    task.readResult();
+    for (uint32_t i = 0; i < iterations; i++) {
+        task.dispatch();
+        TaskResult result = task.readResult();
+        record.valid = record.valid && result.valid;
+        if (task.getLastProfile().trustworthy) trusted++;
+        if (result.gpuTimeUs >= 0.0) reduceUs.push_back(result.gpuTimeUs);
+    }
+    const GpuProfile& profile = task.getLastProfile();
+    record.setSamples(reduceUs);
+    for (const GpuRegion& region : profile.regions) {
+        if (region.plausible) record.addPhase(region.name + "_us", region.durationUs);
+    }
+    runner.emit(record);
+
+    // What each pass does: achieved bandwidth and arithmetic intensity, from the last run
+    const std::vector<PassStats>& passes = task.getLastPassStats();
+    for (const PassStats& pass : passes) {
+        BenchmarkRecord passRecord;
+        passRecord.experiment = "pass-stats";
+        passRecord.backend = pass.name;
+        passRecord.size = n;
+        passRecord.valid = record.valid;
+        if (pass.gpuUs >= 0.0) passRecord.setSamples({pass.gpuUs});
+        passRecord.addPhase("workgroups", pass.workgroups);
+        passRecord.addPhase("invocations", (double)pass.invocations);
+        if (pass.measuredInvocations >= 0) passRecord.addPhase("measured_invocations", (double)pass.measuredInvocations);
+        passRecord.addPhase("bytes", (double)(pass.bytesRead + pass.bytesWritten));
+        passRecord.addPhase("ops", (double)pass.operations);
+        passRecord.addPhase("barriers_before", pass.barriersBefore);
+        if (pass.gpuUs >= 0.0) passRecord.addPhase("gb_per_s", pass.bandwidthGBs());
+        passRecord.addPhase("ops_per_byte", pass.arithmeticIntensity());
+        if (pass.gpuUs >= 0.0 && !g_roofline.isEmpty()) {
+            passRecord.addPhase("roofline_pct", g_roofline.percentOf("gpu", pass.bytesRead + pass.bytesWritten,
+                                                                     pass.bandwidthGBs()));
+        }
+        runner.emit(passRecord);
+    }
+
+    LOGI("\n\n--- PROFILER RESULTS (N=%u, %u of %u profiles trusted, %s timestamps, %u valid bits) ---\n%s\n"
+         "--- PASS STATISTICS (%s) ---\n%s\n"
+         "--- END OF PROFILER RESULTS ---\n",
+         n, trusted, iterations, profile.calibrated ? "calibrated" : "uncalibrated",
+         g_context->getTimestampValidBits(), profile.toString().c_str(),
+         g_context->hasPipelineStatistics() ? "invocations measured" : "no pipeline statistics on this device",
+         PassStats::toString(passes).c_str());
+    task.cleanup();
+}
+
+// --- Concurrent Workload: independent reductions driven from several app threads ---
+static void runConcurrentExperiment(uint32_t n, uint32_t threadCount, uint32_t tasksPerThread) {
+    LOGI("--- STARTING CONCURRENT EXPERIMENT (N=%u, %u threads x %u tasks) ---", n, threadCount, tasksPerThread);
+
+    SubmitQueue* submitQueue = g_context->getSubmitQueue();
+    uint64_t requestsBefore = submitQueue->getRequestCount();
+    uint64_t submitsBefore = submitQueue->getSubmitCount();
+    std::atomic<uint32_t> failures{0};
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < threadCount; t++) {
+        threads.emplace_back([n, t, tasksPerThread, &failures]() {
+            // No locking here: each thread records into its own pool and submits through the queue
+            for (uint32_t i = 0; i < tasksPerThread && !stopRequested(); i++) {
+                try {
+                    GpuOptimizedReduceTask task(g_assetManager, n);
+                    task.setQueueIndex(t);
+                    task.init();
+                    task.dispatch();
+                    task.cleanup();
+                } catch (const std::exception& e) {
+                    LOGE("Concurrent task failed on thread %u: %s", t, e.what());
+                    failures++;
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    std::stringstream ss;
+    ss << "\n\n--- CONCURRENT RESULTS ---\n";
+    ss << "Threads,Tasks,Total_us,Requests,vkQueueSubmit_calls,Failures\n";
+    ss << threadCount << "," << threadCount * tasksPerThread << ","
+       << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << ","
+       << submitQueue->getRequestCount() - requestsBefore << ","
+       << submitQueue->getSubmitCount() - submitsBefore << "," << failures.load() << "\n";
+    ss << "--- END OF CONCURRENT RESULTS ---\n\n";
+    LOGI("%s", ss.str().c_str());
+}
+
 // --- JNI Function: Called from onCreate to pass AssetManager ---
 extern "C" JNIEXPORT void JNICALL
 Java_com_example_gpucomputetest_MainActivity_initJNI(
         JNIEnv* env,
         jobject /* this */,
-        jobject assetManager) {
+        jobject assetManager,
+        jstring cacheDir) {
 
     LOGI("--- initJNI(): Storing AssetManager ---");
     g_assetManager = AAssetManager_fromJava(env, assetManager);
     if (g_assetManager == nullptr) {
         LOGE("Failed to get AAssetManager");
     }
+
+    const char* cacheDirChars = env->GetStringUTFChars(cacheDir, nullptr);
+    g_cacheDir = cacheDirChars;
+    env->ReleaseStringUTFChars(cacheDir, cacheDirChars);
+
+    // A copy of this run's log next to the other outputs, besides logcat
+    Logger::openFile(g_cacheDir + "/gpucompute.log");
 }
 
 
-// --- JNI Entry Point: Runs our experiment ---
-extern "C" JNIEXPORT jstring JNICALL
-Java_com_example_gpucomputetest_MainActivity_stringFromJNI(
-        JNIEnv* env,
-        jobject /* this */) {
+// --- Memory Roofline: bandwidth against working set size, GPU and CPU ---
+// Every later bandwidth figure is reported as a percentage of these curves.
+static void runRooflineExperiment(BenchmarkRunner& runner, const std::vector<uint64_t>& workingSets,
+                                  uint32_t iterations) {
+    LOGI("--- STARTING ROOFLINE EXPERIMENT (%zu working sets, %u iterations) ---", workingSets.size(), iterations);
+    g_roofline.clear();
+    const BandwidthKernel kernels[] = {BandwidthKernel::COPY, BandwidthKernel::READ, BandwidthKernel::WRITE,
+                                       BandwidthKernel::STRIDED, BandwidthKernel::RANDOM};
+    uint64_t capacity = *std::max_element(workingSets.begin(), workingSets.end());
 
-    std::string resultMessage = "Optimized benchmark finished. Check Logcat.";
+    GpuBandwidthTask gpuTask(g_assetManager, capacity);
+    CpuBandwidthTask cpuTask(capacity);
+    gpuTask.init();
+    cpuTask.init();
+    bool gpuTimed = true;
+    for (uint64_t workingSet : workingSets) {
+        for (BandwidthKernel kernel : kernels) {
+            if (runner.isStopRequested()) break;
+            BandwidthSample samples[2] = {gpuTask.measure(kernel, workingSet, iterations),
+                                          cpuTask.measure(kernel, workingSet, iterations)};
+            gpuTimed = gpuTimed && samples[0].gpuTimed;
+            for (const BandwidthSample& sample : samples) {
+                g_roofline.add(sample);
+
+                BenchmarkRecord record;
+                record.experiment = "roofline";
+                record.backend = sample.processor + "-" + getBandwidthKernelName(kernel);
+                record.size = workingSet; // Bytes here, not elements
+                record.setSamples({sample.us});
+                record.addPhase("gb_per_s", sample.gbPerS());
+                runner.emit(record);
+            }
+        }
+    }
+    gpuTask.cleanup();
+    cpuTask.cleanup();
+
+    LOGI("\n\n--- ROOFLINE RESULTS (best of %u; GPU %s) ---\n%s\n--- END OF ROOFLINE RESULTS ---\n",
+         iterations, gpuTimed ? "timestamps" : "CPU-side times, timestamps not trusted",
+         g_roofline.toString().c_str());
+}
+
+// --- The CPU vs. GPU reduction sweep: one record per (size, backend) ---
+// One long-lived task per backend, resized for every size: pipelines, descriptor
+// sets and buffers are created once (the buffers grow as N does), as in production.
+static void runReduceSweep(BenchmarkRunner& runner, const std::vector<uint32_t>& testSizes, uint32_t iterations) {
+    struct Backend { TaskID id; const char* name; };
+    const Backend backends[] = {{TaskID::CPU_REDUCE, "cpu"}, {TaskID::GPU_OPTIMIZED_REDUCE, "gpu-optimized"}};
+    std::vector<double> medians[2];
+    std::vector<double> rooflinePcts[2]; // -1 without a roofline
+
+    for (uint32_t b = 0; b < 2; b++) {
+        // Created at the smallest size, so the sweep also exercises growth
+        auto t0 = std::chrono::high_resolution_clock::now();
+        std::unique_ptr<ComputeTask> task(createTask(backends[b].id, testSizes.front()));
+        if (!task) continue;
+        task->init();
+        double initUs = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - t0).count();
+
+        // --- 2. WARMUP RUNS ---
+        LOGI("--- STARTING WARMUP RUNS (%s) ---", backends[b].name);
+        for (uint32_t n : testSizes) {
+            if (runner.isStopRequested()) break;
+            task->resize(n);
+            task->dispatch(); // Run but ignore result
+        }
+        LOGI("--- WARMUP COMPLETE ---");
+
+        // --- 3. TIMED RUNS ---
+        LOGI("--- STARTING TIMED BENCHMARKS (%s) ---", backends[b].name);
+        for (uint32_t n : testSizes) {
+            if (runner.isStopRequested()) break;
+            BenchmarkRecord record;
+            record.experiment = "reduce";
+            record.backend = backends[b].name;
+            record.size = n;
+
+            auto t1 = std::chrono::high_resolution_clock::now();
+            task->resize(n); // Capacity is already there after the warm-up: no allocation
+            double resizeUs = std::chrono::duration<double, std::micro>(
+                    std::chrono::high_resolution_clock::now() - t1).count();
+
+            std::vector<double> samples;
+            double gpuUs = 0.0;
+            bool gpuTimed = task->isRecordable();
+            for (uint32_t i = 0; i < iterations; i++) {
+                TRACE_SCOPE("iteration", "harness");
+                samples.push_back((double)task->dispatch());
+                if (task->isRecordable()) {
+                    TaskResult result = task->readResult();
+                    record.valid = record.valid && result.valid;
+                    gpuTimed = gpuTimed && result.gpuTimeUs >= 0.0;
+                    gpuUs += result.gpuTimeUs;
+                }
+            }
+
+            record.setSamples(samples);
+            record.addPhase("init_us", initUs); // Once per backend, shared by every size
+            record.addPhase("resize_us", resizeUs);
+            record.addPhase("dispatch_us", record.meanUs);
+            if (gpuTimed) record.addPhase("gpu_us", gpuUs / iterations);
+
+            // Against the measured roofline at this working set: the reduction streams N floats in
+            // (both backends generated them at init() / resize(), outside the timed runs)
+            bool gpu = backends[b].id != TaskID::CPU_REDUCE;
+            double us = gpuTimed ? gpuUs / iterations : record.p50Us;
+            uint64_t bytes = (uint64_t)n * sizeof(float);
+            double pct = rooflinePct(gpu ? "gpu" : "cpu", bytes, bytes, us);
+            if (pct >= 0.0) record.addPhase("roofline_pct", pct);
+            rooflinePcts[b].push_back(pct);
+            runner.emit(record);
+            medians[b].push_back(record.p50Us);
+        }
+        task->cleanup();
+    }
+    if (medians[0].size() != testSizes.size() || medians[1].size() != testSizes.size()) return; // Stopped
 
+    // --- 4. FORMAT AND LOG FINAL TABLE ---
+    std::stringstream ss;
+    ss << "\n\n--- FINAL BENCHMARK RESULTS (CPU vs. GPU Optimized, median of " << iterations << ") ---\n";
+    ss << "N (Elements),CPU_Time_us,GPU_Optimized_Time_us,CPU_Pct_of_roofline,GPU_Pct_of_roofline\n";
+    for (size_t i = 0; i < testSizes.size(); ++i) {
+        ss << testSizes[i] << "," << medians[0][i] << "," << medians[1][i] << ","
+           << rooflinePcts[0][i] << "," << rooflinePcts[1][i] << "\n";
+    }
+    ss << "--- END OF RESULTS ---\n\n";
+
+    // Log the entire table in one go
+    LOGI("%s", ss.str().c_str());
+}
+
+// Runs one logcat experiment and records how long it took
+static void runStep(BenchmarkRunner& runner, const char* name, const std::function<void()>& experiment) {
+    if (runner.isStopRequested()) return;
+    TRACE_SCOPE(name, "experiment");
+    auto start = std::chrono::high_resolution_clock::now();
+    experiment();
+    double us = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count();
+
+    BenchmarkRecord record;
+    record.experiment = name;
+    record.backend = "experiment";
+    record.setSamples({us});
+    record.addPhase("total_us", us);
+    runner.emit(record);
+}
+
+// --- The full sweep, run on the BenchmarkRunner's worker thread ---
+static void runAllExperiments(BenchmarkRunner& runner) {
     // The full list of 10 sizes
     std::vector<uint32_t> testSizes = {
             256 * 1,    // 256
@@ -93,77 +1026,283 @@ Java_com_example_gpucomputetest_MainActivity_stringFromJNI(
             256 * 4096  // 1,048,576
     };
 
-    try {
-        // --- 1. Init Vulkan (once) ---
-        LOGI("--- Initializing Vulkan Context ---");
-        g_context = VulkanContext::getInstance();
-        g_context->init();
+    // --- 1. Init Vulkan (once) ---
+    ensureContext();
+#ifdef GPUCOMPUTE_TRACING
+    Tracer::start();
+#endif
 
-        // --- 2. WARMUP RUNS ---
-        LOGI("--- STARTING WARMUP RUNS ---");
-        for (uint32_t n : testSizes) {
-            // Warm up CPU
-            ComputeTask* taskCpu = createTask(TaskID::CPU_REDUCE, n);
-            if(taskCpu) {
-                taskCpu->init();
-                taskCpu->dispatch(); // Run but ignore result
-                taskCpu->cleanup();
-                delete taskCpu;
-            }
-            // Warm up GPU
-            ComputeTask* taskGpu = createTask(TaskID::GPU_OPTIMIZED_REDUCE, n);
-            if(taskGpu) {
-                taskGpu->init();
-                taskGpu->dispatch(); // Run but ignore result
-                taskGpu->cleanup();
-                delete taskGpu;
-            }
-        }
-        LOGI("--- WARMUP COMPLETE ---");
+    // --- MEMORY ROOFLINE (first: the experiments below report against it) ---
+    // 16 KiB (L1) to 64 MiB (DRAM), x4
+    runStep(runner, "roofline", [&runner] {
+        runRooflineExperiment(runner, {16 * 1024, 64 * 1024, 256 * 1024, 1024 * 1024, 4 * 1024 * 1024,
+                                       16 * 1024 * 1024, 64 * 1024 * 1024}, 5);
+    });
 
+    // --- 2.-4. CPU vs. GPU SWEEP ---
+    {
+        TRACE_SCOPE("reduce sweep", "experiment");
+        runReduceSweep(runner, testSizes, 10);
+    }
 
-        // --- 3. TIMED RUNS ---
-        LOGI("--- STARTING TIMED BENCHMARKS ---");
+    // --- 5. ITERATIVE WORKLOAD (Phase 5.2 revisited) ---
+    runStep(runner, "iterative", [] { runIterativeExperiment(256 * 4096, 100); });
 
-        std::vector<long long> cpuTimes;
-        std::vector<long long> gpuTimes;
+    // --- 6. BATCHED SUBMISSION ---
+    runStep(runner, "batch", [] { runBatchExperiment(256 * 16, {1, 8, 64, 512}); });
 
-        // --- Run CPU Tests ---
-        for (uint32_t n : testSizes) {
-            ComputeTask* task = createTask(TaskID::CPU_REDUCE, n);
-            task->init();
-            cpuTimes.push_back(task->dispatch()); // Store result
-            task->cleanup();
-            delete task;
-        }
+    // --- 7. SEGMENTED REDUCTION ---
+    runStep(runner, "segmented", [] { runSegmentedExperiment(256 * 4096); });
 
-        // --- Run GPU (OPTIMIZED) Tests ---
-        for (uint32_t n : testSizes) {
-            ComputeTask* task = createTask(TaskID::GPU_OPTIMIZED_REDUCE, n);
-            task->init();
-            gpuTimes.push_back(task->dispatch()); // Store result
-            task->cleanup();
-            delete task;
+    // --- 8. CONCURRENT SUBMISSION ---
+    runStep(runner, "concurrent", [] { runConcurrentExperiment(256 * 4096, 4, 8); });
+
+    // --- 9. FUSED MAP-REDUCE ---
+    runStep(runner, "fused", [] { runFusedExperiment(256 * 4096); });
+
+    // --- 10. ELEMENTWISE BANDWIDTH (N not a multiple of 4 or 256 on purpose) ---
+    runStep(runner, "elementwise", [] { runElementwiseExperiment(4 * 1000 * 1000 + 3); });
+
+    // --- 11. INPUT GENERATION ---
+    runStep(runner, "input", [] { runInputExperiment(256 * 4096); });
+
+    // --- 12. MEMORY-FRUGAL REDUCTION (admission checked for 128M elements) ---
+    runStep(runner, "frugal", [] { runFrugalExperiment({256 * 4096, 8 * 1024 * 1024, 16 * 1024 * 1024}, 128 * 1024 * 1024); });
+
+    // --- 13. OUT-OF-CORE STREAMING (256 MiB file, 4 / 16 / 64 MiB chunks) ---
+    runStep(runner, "out-of-core", [] {
+        runOutOfCoreExperiment(64ull * 1024 * 1024, {1024 * 1024, 4 * 1024 * 1024, 16 * 1024 * 1024});
+    });
+
+    // --- 14. ZERO-COPY HOST IMPORT ---
+    runStep(runner, "host-import", [] { runHostImportExperiment(16 * 1024 * 1024, 20); });
+
+    // --- 15. JNI DATA PATH (cached tasks per size class) ---
+    runStep(runner, "reduce-cache", [] { runReduceCacheExperiment({1000, 256 * 4096, 4 * 1024 * 1024}); });
+
+    // --- 16. ADAPTIVE CPU/GPU DISPATCH (sizes between the calibration points on purpose) ---
+    runStep(runner, "dispatcher", [] {
+        runDispatcherExperiment({300, 3000, 30 * 1000, 300 * 1000, 3 * 1000 * 1000});
+    });
+
+    // --- 17. CPU+GPU CO-EXECUTION ---
+    runStep(runner, "hybrid", [&runner] { runHybridExperiment(runner, {256 * 4096, 16 * 1024 * 1024}, 20); });
+
+    // --- 18. GPU TIMESTAMP PROFILER ---
+    runStep(runner, "profiler", [&runner] { runProfilerExperiment(runner, 256 * 4096, 20); });
+
+#ifdef GPUCOMPUTE_TRACING
+    // --- Timeline of the whole sweep: adb pull it, then open it in ui.perfetto.dev ---
+    Tracer::stop();
+    if (!g_cacheDir.empty()) {
+        std::string tracePath = g_cacheDir + "/trace.json";
+        if (Tracer::writeChromeJson(tracePath)) {
+            LOGI("Trace: %llu events (%llu dropped) written to %s", (unsigned long long)Tracer::getEventCount(),
+                 (unsigned long long)Tracer::getDroppedCount(), tracePath.c_str());
         }
+    }
+#endif
+}
+
+// --- JNI Benchmark Control: the sweep runs on a worker thread, results are polled ---
+// States match BenchmarkRunner::State: 0 idle, 1 running, 2 finished, 3 failed, 4 cancelled.
 
-        // --- 4. FORMAT AND LOG FINAL TABLE ---
-        std::stringstream ss;
-        ss << "\n\n--- FINAL BENCHMARK RESULTS (CPU vs. GPU Optimized) ---\n";
-        ss << "N (Elements),CPU_Time_us,GPU_Optimized_Time_us\n";
-        for (size_t i = 0; i < testSizes.size(); ++i) {
-            ss << testSizes[i] << "," << cpuTimes[i] << "," << gpuTimes[i] << "\n";
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_gpucomputetest_MainActivity_startBenchmark(
+        JNIEnv* /* env */,
+        jobject /* this */) {
+    return g_benchmark.start(runAllExperiments) ? JNI_TRUE : JNI_FALSE;
+}
+
+// One JSON object per configuration finished since the last call
+extern "C" JNIEXPORT jobjectArray JNICALL
+Java_com_example_gpucomputetest_MainActivity_pollBenchmarkResults(
+        JNIEnv* env,
+        jobject /* this */) {
+    std::vector<BenchmarkRecord> records = g_benchmark.poll();
+    jobjectArray array = env->NewObjectArray((jsize)records.size(), env->FindClass("java/lang/String"), nullptr);
+    if (array == nullptr) return nullptr;
+    for (size_t i = 0; i < records.size(); i++) {
+        jstring json = env->NewStringUTF(records[i].toJson().c_str());
+        env->SetObjectArrayElement(array, (jsize)i, json);
+        env->DeleteLocalRef(json);
+    }
+    return array;
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_gpucomputetest_MainActivity_getBenchmarkState(
+        JNIEnv* /* env */,
+        jobject /* this */) {
+    return static_cast<jint>(g_benchmark.getState());
+}
+
+extern "C" JNIEXPORT jstring JNICALL
+Java_com_example_gpucomputetest_MainActivity_getBenchmarkError(
+        JNIEnv* env,
+        jobject /* this */) {
+    return env->NewStringUTF(g_benchmark.getError().c_str());
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_gpucomputetest_MainActivity_cancelBenchmark(
+        JNIEnv* /* env */,
+        jobject /* this */) {
+    g_benchmark.requestStop();
+}
+
+// --- JNI Entry Point: Runs our experiment (blocking; kept for callers that want the old behaviour) ---
+extern "C" JNIEXPORT jstring JNICALL
+Java_com_example_gpucomputetest_MainActivity_stringFromJNI(
+        JNIEnv* env,
+        jobject /* this */) {
+
+    if (!g_benchmark.start(runAllExperiments)) {
+        return env->NewStringUTF("A benchmark is already running.");
+    }
+    g_benchmark.join();
+
+    std::string resultMessage = "Optimized benchmark finished. Check Logcat.";
+    if (g_benchmark.getState() == BenchmarkRunner::State::FAILED) {
+        resultMessage = "Error: " + g_benchmark.getError();
+    }
+    return env->NewStringUTF(resultMessage.c_str());
+}
+
+// --- JNI Data Path: reductions over caller data, no Java-side copy ---
+// op: the FusedOp ordinal (0 sum, 2 sum of squares, 3 L1, 4 L2, 5 mean/variance; 1 = dot is rejected).
+// Each returns {value, variance, gpuTimeUs, hostTimeUs, imported (0/1)}, or throws a RuntimeException.
+
+static jdoubleArray toJavaResult(JNIEnv* env, const HostReduceResult& result) {
+    jdouble values[5] = {result.value, result.variance, result.gpuTimeUs, (jdouble)result.hostTimeUs,
+                         result.path == HostBufferPath::IMPORTED ? 1.0 : 0.0};
+    jdoubleArray array = env->NewDoubleArray(5);
+    if (array != nullptr) env->SetDoubleArrayRegion(array, 0, 5, values);
+    return array;
+}
+
+static FusedOp toFusedOp(jint op) {
+    if (op < 0 || op > (jint)FusedOp::MEAN_VARIANCE) {
+        throw std::runtime_error("Unknown reduce op!");
+    }
+    return static_cast<FusedOp>(op);
+}
+
+static void throwJava(JNIEnv* env, const std::exception& e) {
+    LOGE("reduce failed: %s", e.what());
+    jclass exceptionClass = env->FindClass("java/lang/RuntimeException");
+    if (exceptionClass != nullptr) env->ThrowNew(exceptionClass, e.what());
+}
+
+// A direct ByteBuffer (native byte order): its memory is read where it is, no JNI copy
+extern "C" JNIEXPORT jdoubleArray JNICALL
+Java_com_example_gpucomputetest_MainActivity_reduceDirectBuffer(
+        JNIEnv* env,
+        jobject /* this */,
+        jobject buffer,
+        jint count,
+        jint op) {
+    try {
+        void* address = env->GetDirectBufferAddress(buffer);
+        jlong capacity = env->GetDirectBufferCapacity(buffer);
+        if (address == nullptr || count <= 0 || capacity < (jlong)sizeof(float) * count) {
+            throw std::runtime_error("reduceDirectBuffer needs a direct buffer holding 'count' floats!");
         }
-        ss << "--- END OF RESULTS ---\n\n";
+        std::shared_lock<std::shared_mutex> cacheLock;
+        ReduceCache& cache = lockReduceCache(cacheLock);
+        return toJavaResult(env, cache.reduce(toFusedOp(op), static_cast<const float*>(address), (uint32_t)count));
+    } catch (const std::exception& e) {
+        throwJava(env, e);
+        return nullptr;
+    }
+}
 
-        // Log the entire table in one go
-        LOGI("%s", ss.str().c_str());
+// A float[]: pinned (or copied, at the VM's choice) only for the copy into the task's input
+extern "C" JNIEXPORT jdoubleArray JNICALL
+Java_com_example_gpucomputetest_MainActivity_reduceFloatArray(
+        JNIEnv* env,
+        jobject /* this */,
+        jfloatArray values,
+        jint count,
+        jint op) {
+    try {
+        if (count <= 0 || env->GetArrayLength(values) < count) {
+            throw std::runtime_error("reduceFloatArray needs 0 < count <= values.size!");
+        }
+        FusedOp fusedOp = toFusedOp(op);
+        std::shared_lock<std::shared_mutex> cacheLock;
+        ReduceCache& cache = lockReduceCache(cacheLock);
+        // The critical section covers only the copy: ReduceCache pins the array once it
+        // holds its lock and its task is ready, and releases it before the GPU work
+        void* elements = nullptr;
+        HostReduceResult result = cache.reduce(fusedOp, (uint32_t)count,
+                [&]() -> const float* {
+                    elements = env->GetPrimitiveArrayCritical(values, nullptr);
+                    return static_cast<const float*>(elements);
+                },
+                [&]() { env->ReleasePrimitiveArrayCritical(values, elements, JNI_ABORT); });
+        return toJavaResult(env, result);
+    } catch (const std::exception& e) {
+        throwJava(env, e);
+        return nullptr;
+    }
+}
 
+// Imports a direct ByteBuffer the caller will reduce again and again; true if later calls skip the copy.
+// The buffer must stay reachable until unregisterDirectBuffer().
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_gpucomputetest_MainActivity_registerDirectBuffer(
+        JNIEnv* env,
+        jobject /* this */,
+        jobject buffer) {
+    try {
+        void* address = env->GetDirectBufferAddress(buffer);
+        jlong capacity = env->GetDirectBufferCapacity(buffer);
+        if (address == nullptr || capacity <= 0) {
+            throw std::runtime_error("registerDirectBuffer needs a direct buffer!");
+        }
+        std::shared_lock<std::shared_mutex> cacheLock;
+        ReduceCache& cache = lockReduceCache(cacheLock);
+        return cache.registerHostMemory(address, (size_t)capacity) ? JNI_TRUE : JNI_FALSE;
     } catch (const std::exception& e) {
-        LOGE("!!! FATAL ERROR: %s", e.what());
-        resultMessage = "Error: " + std::string(e.what());
+        throwJava(env, e);
+        return JNI_FALSE;
+    }
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_gpucomputetest_MainActivity_unregisterDirectBuffer(
+        JNIEnv* env,
+        jobject /* this */,
+        jobject buffer) {
+    void* address = env->GetDirectBufferAddress(buffer);
+    std::shared_lock<std::shared_mutex> cacheLock(g_reduceCacheMutex);
+    if (address != nullptr && g_reduceCache != nullptr) {
+        g_reduceCache->unregisterHostMemory(address);
     }
+}
 
-    return env->NewStringUTF(resultMessage.c_str());
+// --- JNI Dispatcher: thermal input and metrics ---
+
+// PowerManager.THERMAL_STATUS_*; a change makes the dispatcher recalibrate before its next request
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_gpucomputetest_MainActivity_setThermalStatus(
+        JNIEnv* /* env */,
+        jobject /* this */,
+        jint status) {
+    std::lock_guard<std::mutex> lock(g_dispatcherMutex);
+    g_thermalStatus = status;
+    if (g_dispatcher != nullptr) g_dispatcher->setThermalStatus(status);
+}
+
+// Cost models, crossover N, routing counts and recalibrations as JSON ("{}" before the first calibration)
+extern "C" JNIEXPORT jstring JNICALL
+Java_com_example_gpucomputetest_MainActivity_getDispatcherMetrics(
+        JNIEnv* env,
+        jobject /* this */) {
+    std::lock_guard<std::mutex> lock(g_dispatcherMutex);
+    std::string json = g_dispatcher != nullptr ? g_dispatcher->getMetrics().toJson() : "{}";
+    return env->NewStringUTF(json.c_str());
 }
 
 // --- JNI Cleanup: Called when the app is destroyed ---
@@ -173,8 +1312,31 @@ Java_com_example_gpucomputetest_MainActivity_cleanup(
         jobject /* this */) {
 
     LOGI("--- Cleaning up compute resources ---");
+    // The sweep must be off the GPU before anything it uses goes away
+    g_benchmark.requestStop();
+    g_benchmark.join();
+    std::lock_guard<std::mutex> lock(g_initMutex);
+    {
+        std::lock_guard<std::mutex> dispatcherLock(g_dispatcherMutex);
+        if (g_dispatcher != nullptr) {
+            g_dispatcher->cleanup();
+            delete g_dispatcher;
+            g_dispatcher = nullptr;
+        }
+    }
+    {
+        // Waits for reduce*() calls in flight; later ones see no cache until the next ensureContext()
+        std::unique_lock<std::shared_mutex> cacheLock(g_reduceCacheMutex);
+        if (g_reduceCache != nullptr) {
+            g_reduceCache->clear();
+            delete g_reduceCache;
+            g_reduceCache = nullptr;
+        }
+    }
     if (g_context != nullptr) {
         g_context->cleanup();
+        g_context = nullptr;
     }
     LOGI("--- Cleanup complete ---");
+    Logger::flush();
 }
\ No newline at end of file
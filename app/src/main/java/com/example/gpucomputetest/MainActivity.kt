@@ -1,13 +1,23 @@
 package com.example.gpucomputetest
 
+import android.os.Build
 import android.os.Bundle
+import android.os.PowerManager
 import android.content.res.AssetManager
+import java.nio.ByteBuffer
+import kotlinx.coroutines.delay
 import androidx.activity.ComponentActivity
 import androidx.activity.compose.setContent
 import androidx.compose.foundation.layout.Box
 import androidx.compose.foundation.layout.fillMaxSize
 import androidx.compose.material3.Text // Keep Text
 import androidx.compose.runtime.Composable
+import androidx.compose.runtime.LaunchedEffect
+import androidx.compose.runtime.getValue
+import androidx.compose.runtime.mutableStateListOf
+import androidx.compose.runtime.mutableStateOf
+import androidx.compose.runtime.remember
+import androidx.compose.runtime.setValue
 import androidx.compose.ui.Alignment
 import androidx.compose.ui.Modifier
 // DELETED: import com.example.gpucomputetest.ui.theme.GpuComputeTestTheme
@@ -15,30 +25,96 @@ import androidx.compose.ui.Modifier
 class MainActivity : ComponentActivity() {
 
     // --- Native (JNI) Functions ---
-    private external fun initJNI(assetManager: AssetManager)
-    private external fun stringFromJNI(): String
+    private external fun initJNI(assetManager: AssetManager, cacheDir: String)
+    private external fun stringFromJNI(): String // Blocking; the UI uses startBenchmark()
+    // The sweep on a native worker thread: start, then poll for one JSON record per configuration
+    private external fun startBenchmark(): Boolean
+    private external fun pollBenchmarkResults(): Array<String>
+    private external fun getBenchmarkState(): Int
+    private external fun getBenchmarkError(): String
+    private external fun cancelBenchmark()
     private external fun cleanup()
 
+    // Reductions over caller data (op: REDUCE_* below). Each returns
+    // [value, variance, gpuTimeUs, hostTimeUs, imported]; the buffer must be direct, native order.
+    external fun reduceDirectBuffer(buffer: ByteBuffer, count: Int, op: Int): DoubleArray
+    external fun reduceFloatArray(values: FloatArray, count: Int, op: Int): DoubleArray
+    // Lets later reduceDirectBuffer() calls on this buffer skip the copy, when the device can import it
+    external fun registerDirectBuffer(buffer: ByteBuffer): Boolean
+    external fun unregisterDirectBuffer(buffer: ByteBuffer)
+    // The CPU/GPU dispatcher recalibrates when the thermal status (PowerManager.THERMAL_STATUS_*) changes
+    private external fun setThermalStatus(status: Int)
+    external fun getDispatcherMetrics(): String
+
+    private var thermalListener: Any? = null // PowerManager.OnThermalStatusChangedListener (API 29+)
+
     // --- Activity Lifecycle ---
     override fun onCreate(savedInstanceState: Bundle?) {
         super.onCreate(savedInstanceState)
 
-        initJNI(assets)
-        val computeResult = stringFromJNI()
+        initJNI(assets, cacheDir.absolutePath)
+        registerThermalListener() // Before the sweep calibrates the dispatcher
+        startBenchmark()
 
         // --- SIMPLIFIED setContent ---
         setContent {
             // No theme or surface needed, just show the text
-            Greeting(computeResult)
+            val records = remember { mutableStateListOf<String>() }
+            var status by remember { mutableStateOf("Benchmark running...") }
+            LaunchedEffect(Unit) {
+                while (true) {
+                    val state = getBenchmarkState()
+                    records.addAll(pollBenchmarkResults())
+                    if (state != BENCHMARK_RUNNING) {
+                        status = when (state) {
+                            BENCHMARK_FAILED -> "Error: " + getBenchmarkError()
+                            BENCHMARK_CANCELLED -> "Benchmark cancelled."
+                            else -> "Optimized benchmark finished. Check Logcat."
+                        }
+                        break
+                    }
+                    delay(250)
+                }
+            }
+            Greeting(status + "\n" + records.size + " results\n" + records.takeLast(3).joinToString("\n"))
         }
     }
 
+    private fun registerThermalListener() {
+        if (Build.VERSION.SDK_INT < Build.VERSION_CODES.Q) return
+        val powerManager = getSystemService(POWER_SERVICE) as PowerManager
+        setThermalStatus(powerManager.currentThermalStatus)
+        val listener = PowerManager.OnThermalStatusChangedListener { status -> setThermalStatus(status) }
+        powerManager.addThermalStatusListener(listener)
+        thermalListener = listener
+    }
+
     override fun onDestroy() {
         super.onDestroy()
-        cleanup()
+        if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.Q) {
+            (thermalListener as? PowerManager.OnThermalStatusChangedListener)?.let {
+                (getSystemService(POWER_SERVICE) as PowerManager).removeThermalStatusListener(it)
+            }
+        }
+        cancelBenchmark()
+        cleanup() // Waits for the sweep to see the stop; long experiments check it in their inner loops
     }
 
     companion object {
+        // Match FusedOp in FusedReduceTask.h
+        const val REDUCE_SUM = 0
+        const val REDUCE_SUM_OF_SQUARES = 2
+        const val REDUCE_L1_NORM = 3
+        const val REDUCE_L2_NORM = 4
+        const val REDUCE_MEAN_VARIANCE = 5
+
+        // Match BenchmarkRunner::State
+        const val BENCHMARK_IDLE = 0
+        const val BENCHMARK_RUNNING = 1
+        const val BENCHMARK_FINISHED = 2
+        const val BENCHMARK_FAILED = 3
+        const val BENCHMARK_CANCELLED = 4
+
         init {
             System.loadLibrary("gpucomputetest")
         }